@@ -0,0 +1,539 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../include/AndInverterGraph.h"
+#include "../include/CutEngine.h"
+#include "../include/FlowMapEngine.h"
+#include "../include/RegisterPartitioner.h"
+#include "../include/SequentialMapper.h"
+#include "../include/TechMapper.h"
+#include "../include/ZddCutEngine.h"
+
+// Runs the mapping engines on the EPFL suite (or on the designs given in the
+// command line) and compares their runtime, peak memory, lookup table count
+// and depth.
+//
+// Each run is made in a child process, so that its peak resident set size is
+// its own, and is repeated --repeat times. --save-baseline writes every sample
+// to a file; --baseline compares a run with such a file and exits with status
+// 2 if a design regressed. Runtime and memory are compared with robust
+// statistics: the median of the samples, their median absolute deviation
+// (MAD) and an approximate 95% confidence interval of the median. A design
+// regresses when the interval of the current run lies above the one of the
+// baseline and the median grew by more than --threshold percent, or when its
+// lookup table count or number of levels grew at all.
+//
+// The seqmap engine is the sequential mapper (SequentialMapper); its levels
+// are its clock period after retiming. The other engines map a design with
+// latches one combinational island at a time (RegisterPartitioner). The
+// designs with latches of --sequential-dir (aiger/sequential by default) run
+// after the suite.
+//
+// Usage: tmap_bench [-k N] [-c N] [--goal=area|delay]
+//                   [--engines=cuts,flowmap,zdd,seqmap] [--aiger-dir=DIR]
+//                   [--sequential-dir=DIR] [--repeat=N] [--save-baseline=FILE] [--baseline=FILE]
+//                   [--threshold=PERCENT] [designs...]
+
+namespace
+{
+
+struct BenchmarkResult
+{
+  unsigned int lutCount = 0;
+  unsigned int levels = 0;
+  double seconds = 0.0;
+  // Peak resident set size of the process, in kilobytes
+  long peakRss = 0;
+};
+
+// Every run of an engine on a design
+struct BenchmarkSamples
+{
+  unsigned int lutCount = 0;
+  unsigned int levels = 0;
+  std::vector<double> secondsVector = {};
+  std::vector<double> peakRssVector = {};
+};
+
+struct RobustSummary
+{
+  double median = 0.0;
+  double mad = 0.0;
+  double lower = 0.0;
+  double upper = 0.0;
+};
+
+BenchmarkResult
+runEngine (const AndInverterGraph &aig, const std::string &engine,
+           unsigned int k, unsigned int c, MappingGoal mappingGoal)
+{
+  BenchmarkResult result;
+  auto start = std::chrono::steady_clock::now ();
+
+  // The levels of the sequential mapper are its clock period after retiming
+  if (engine == "seqmap")
+    {
+      SequentialMapper sequentialMapper (aig, k, c > 0 ? c : 8);
+      sequentialMapper.run ();
+      auto end = std::chrono::steady_clock::now ();
+      result.lutCount = sequentialMapper.getMappingAreaCost ();
+      result.levels = sequentialMapper.getClockPeriod ();
+      result.seconds = std::chrono::duration<double> (end - start).count ();
+      return result;
+    }
+  if (aig.isSequential ())
+    {
+      RegisterPartitioner partitioner (aig, mappingGoal, k, c);
+      partitioner.setEngine (engine);
+      partitioner.run ();
+      auto end = std::chrono::steady_clock::now ();
+      result.lutCount = partitioner.getMappingAreaCost ();
+      result.levels = partitioner.getMappingDelayCost ();
+      result.seconds = std::chrono::duration<double> (end - start).count ();
+      return result;
+    }
+  std::unique_ptr<MappingEngine> mappingEngine;
+  if (engine == "flowmap")
+    mappingEngine.reset (new FlowMapEngine (aig, k));
+  else if (engine == "zdd")
+    mappingEngine.reset (new ZddCutEngine (aig, mappingGoal, k));
+  else
+    mappingEngine.reset (new CutEngine (aig, mappingGoal, k, c));
+  TechMapper techMapper (*mappingEngine);
+  techMapper.run ();
+  auto end = std::chrono::steady_clock::now ();
+  result.lutCount = techMapper.getMappingAreaCost ();
+  result.levels = techMapper.getMappingDelayCost ();
+  result.seconds = std::chrono::duration<double> (end - start).count ();
+  return result;
+}
+
+// Runs an engine in a child process and reads its result through a pipe
+BenchmarkResult
+runIsolated (const AndInverterGraph &aig, const std::string &engine,
+             unsigned int k, unsigned int c, MappingGoal mappingGoal)
+{
+  int pipeDescriptors[2];
+  if (pipe (pipeDescriptors) != 0)
+    throw std::runtime_error ("Runtime error (runIsolated): pipe() failed.");
+  std::cout << std::flush;
+  pid_t pid = fork ();
+  if (pid < 0)
+    throw std::runtime_error ("Runtime error (runIsolated): fork() failed.");
+  if (pid == 0)
+    {
+      close (pipeDescriptors[0]);
+      int status = 1;
+      try
+        {
+          BenchmarkResult result = runEngine (aig, engine, k, c, mappingGoal);
+          if (write (pipeDescriptors[1], &result, sizeof (result))
+              == sizeof (result))
+            status = 0;
+        }
+      catch (const std::exception &e)
+        {
+          std::cerr << "  what(): " << e.what () << std::endl;
+        }
+      _exit (status);
+    }
+  close (pipeDescriptors[1]);
+  BenchmarkResult result;
+  ssize_t numRead = read (pipeDescriptors[0], &result, sizeof (result));
+  close (pipeDescriptors[0]);
+  int status;
+  struct rusage usage;
+  if (wait4 (pid, &status, 0, &usage) != pid || !WIFEXITED (status)
+      || WEXITSTATUS (status) != 0 || numRead != sizeof (result))
+    throw std::runtime_error ("Runtime error (runIsolated): the run of the "
+                              "engine '"
+                              + engine + "' failed.");
+  result.peakRss = usage.ru_maxrss;
+  return result;
+}
+
+RobustSummary
+summarize (std::vector<double> samples)
+{
+  RobustSummary summary;
+  if (samples.empty ())
+    return summary;
+  auto median = [] (std::vector<double> &values) {
+    std::sort (values.begin (), values.end ());
+    std::size_t middle = values.size () / 2;
+    return values.size () % 2 ? values[middle]
+                              : (values[middle - 1] + values[middle]) / 2;
+  };
+  summary.median = median (samples);
+  for (auto &sample : samples)
+    sample = std::abs (sample - summary.median);
+  summary.mad = median (samples);
+  // Notch of a box plot (1.57 IQR / sqrt(n)), with the IQR estimated from
+  // the MAD of a normal distribution
+  double halfWidth = 1.57 * 1.349 * 1.4826 * summary.mad
+                     / std::sqrt (static_cast<double> (samples.size ()));
+  summary.lower = summary.median - halfWidth;
+  summary.upper = summary.median + halfWidth;
+  return summary;
+}
+
+// Baseline files have a line with the mapping parameters, then one line per
+// design and engine: the lookup table count, the levels, the number of runs,
+// and the seconds and peak RSS (kB) of each run
+std::string
+parametersLine (unsigned int k, unsigned int c, MappingGoal mappingGoal)
+{
+  std::ostringstream line;
+  line << "parameters " << k << " " << c << " "
+       << (mappingGoal == MappingGoal::MinimizeDelay ? "delay" : "area");
+  return line.str ();
+}
+
+void
+saveBaseline (
+    const std::string &fileName, const std::string &parameters,
+    const std::map<std::pair<std::string, std::string>, BenchmarkSamples>
+        &samplesMap)
+{
+  std::ofstream baselineFile (fileName);
+  if (!baselineFile.is_open ())
+    throw std::runtime_error ("Unable to open '" + fileName + "'");
+  baselineFile << "# tmap_bench baseline" << std::endl
+               << parameters << std::endl;
+  baselineFile << std::setprecision (9);
+  for (const auto &[key, samples] : samplesMap)
+    {
+      baselineFile << key.first << " " << key.second << " "
+                   << samples.lutCount << " " << samples.levels << " "
+                   << samples.secondsVector.size ();
+      for (const auto &seconds : samples.secondsVector)
+        baselineFile << " " << seconds;
+      for (const auto &peakRss : samples.peakRssVector)
+        baselineFile << " " << peakRss;
+      baselineFile << std::endl;
+    }
+}
+
+std::map<std::pair<std::string, std::string>, BenchmarkSamples>
+loadBaseline (const std::string &fileName, const std::string &parameters)
+{
+  std::ifstream baselineFile (fileName);
+  if (!baselineFile.is_open ())
+    throw std::runtime_error ("Unable to open '" + fileName + "'");
+  std::map<std::pair<std::string, std::string>, BenchmarkSamples> samplesMap;
+  std::string line;
+  unsigned int lineNumber = 0;
+  bool hasParameters = false;
+  while (std::getline (baselineFile, line))
+    {
+      lineNumber++;
+      if (line.empty () || line[0] == '#')
+        continue;
+      if (line.rfind ("parameters ", 0) == 0)
+        {
+          if (line != parameters)
+            throw std::runtime_error ("The baseline '" + fileName
+                                      + "' was measured with other "
+                                        "parameters ("
+                                      + line + ").");
+          hasParameters = true;
+          continue;
+        }
+      std::istringstream fields (line);
+      std::string design, engine;
+      BenchmarkSamples samples;
+      std::size_t numRuns = 0;
+      fields >> design >> engine >> samples.lutCount >> samples.levels
+          >> numRuns;
+      samples.secondsVector.resize (numRuns);
+      samples.peakRssVector.resize (numRuns);
+      for (auto &seconds : samples.secondsVector)
+        fields >> seconds;
+      for (auto &peakRss : samples.peakRssVector)
+        fields >> peakRss;
+      if (!fields || numRuns == 0)
+        throw std::runtime_error ("In " + fileName + ", line "
+                                  + std::to_string (lineNumber)
+                                  + ": malformed baseline entry.");
+      samplesMap[{ design, engine }] = std::move (samples);
+    }
+  if (!hasParameters)
+    throw std::runtime_error ("The baseline '" + fileName
+                              + "' has no parameters line.");
+  return samplesMap;
+}
+
+// Prints the comparison of every design and engine found in both runs and
+// returns the number of regressions
+unsigned int
+compareWithBaseline (
+    const std::map<std::pair<std::string, std::string>, BenchmarkSamples>
+        &baselineMap,
+    const std::map<std::pair<std::string, std::string>, BenchmarkSamples>
+        &samplesMap,
+    double threshold)
+{
+  std::cout << std::left << std::setw (14) << "design" << std::setw (9)
+            << "engine" << std::setw (10) << "metric" << std::right
+            << std::setw (22) << "baseline" << std::setw (22) << "current"
+            << std::setw (10) << "change" << std::endl;
+  unsigned int numRegressions = 0;
+  auto printRow = [&] (const std::pair<std::string, std::string> &key,
+                       const std::string &metric, const std::string &baseline,
+                       const std::string &current, double change,
+                       bool regressed) {
+    std::ostringstream changeText;
+    changeText << std::showpos << std::fixed << std::setprecision (1)
+               << change << "%";
+    std::cout << std::left << std::setw (14) << key.first << std::setw (9)
+              << key.second << std::setw (10) << metric << std::right
+              << std::setw (22) << baseline << std::setw (22) << current
+              << std::setw (10) << changeText.str ()
+              << (regressed ? "  REGRESSION" : "") << std::endl;
+    numRegressions += regressed;
+  };
+  auto relativeChange = [] (double baseline, double current) {
+    return baseline > 0 ? 100.0 * (current - baseline) / baseline : 0.0;
+  };
+  // Median +- MAD, e.g. "0.125 +- 0.004"
+  auto summaryText = [] (const RobustSummary &summary, double scale,
+                         int precision) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision (precision)
+         << summary.median * scale << " +- " << summary.mad * scale;
+    return text.str ();
+  };
+  for (const auto &[key, samples] : samplesMap)
+    {
+      auto baselineIterator = baselineMap.find (key);
+      if (baselineIterator == baselineMap.end ())
+        continue;
+      const BenchmarkSamples &baseline = baselineIterator->second;
+      printRow (key, "LUTs", std::to_string (baseline.lutCount),
+                std::to_string (samples.lutCount),
+                relativeChange (baseline.lutCount, samples.lutCount),
+                samples.lutCount > baseline.lutCount);
+      printRow (key, "levels", std::to_string (baseline.levels),
+                std::to_string (samples.levels),
+                relativeChange (baseline.levels, samples.levels),
+                samples.levels > baseline.levels);
+      auto compareSamples = [&] (const std::string &metric,
+                                 const std::vector<double> &baselineSamples,
+                                 const std::vector<double> &currentSamples,
+                                 double scale, int precision) {
+        RobustSummary before = summarize (baselineSamples);
+        RobustSummary after = summarize (currentSamples);
+        double change = relativeChange (before.median, after.median);
+        printRow (key, metric, summaryText (before, scale, precision),
+                  summaryText (after, scale, precision), change,
+                  after.lower > before.upper && change > threshold);
+      };
+      compareSamples ("time (s)", baseline.secondsVector,
+                      samples.secondsVector, 1.0, 3);
+      compareSamples ("RSS (MB)", baseline.peakRssVector,
+                      samples.peakRssVector, 1.0 / 1024, 1);
+    }
+  return numRegressions;
+}
+
+std::vector<std::string>
+splitList (const std::string &list)
+{
+  std::vector<std::string> items;
+  std::stringstream ss (list);
+  std::string item;
+  while (std::getline (ss, item, ','))
+    if (!item.empty ())
+      items.push_back (item);
+  return items;
+}
+
+} // namespace
+
+int
+main (int argc, char *argv[])
+try
+  {
+    unsigned int k = 6;
+    unsigned int c = 8;
+    MappingGoal mappingGoal = MappingGoal::MinimizeDelay;
+    std::vector<std::string> engines = { "cuts", "flowmap" };
+    std::string aigerDir = "aiger/epfl";
+    std::string sequentialDir = "aiger/sequential";
+    unsigned int numRepeats = 1;
+    std::string saveBaselineFile = "";
+    std::string baselineFile = "";
+    double threshold = 5.0;
+    std::vector<std::string> designs;
+    for (int i = 1; i < argc; i++)
+      {
+        std::string arg = argv[i];
+        if (arg == "-k" && i + 1 < argc)
+          k = std::stoul (argv[++i]);
+        else if (arg == "-c" && i + 1 < argc)
+          c = std::stoul (argv[++i]);
+        else if (arg == "--goal=area")
+          mappingGoal = MappingGoal::MinimizeArea;
+        else if (arg == "--goal=delay")
+          mappingGoal = MappingGoal::MinimizeDelay;
+        else if (arg.rfind ("--engines=", 0) == 0)
+          engines = splitList (arg.substr (10));
+        else if (arg.rfind ("--aiger-dir=", 0) == 0)
+          aigerDir = arg.substr (12);
+        else if (arg.rfind ("--sequential-dir=", 0) == 0)
+          sequentialDir = arg.substr (17);
+        else if (arg.rfind ("--repeat=", 0) == 0)
+          numRepeats = std::stoul (arg.substr (9));
+        else if (arg.rfind ("--save-baseline=", 0) == 0)
+          saveBaselineFile = arg.substr (16);
+        else if (arg.rfind ("--baseline=", 0) == 0)
+          baselineFile = arg.substr (11);
+        else if (arg.rfind ("--threshold=", 0) == 0)
+          threshold = std::stod (arg.substr (12));
+        else if (arg.rfind ("-", 0) == 0)
+          throw std::runtime_error ("Unknown option '" + arg + "'");
+        else
+          designs.push_back (arg);
+      }
+    for (const auto &engine : engines)
+      if (engine != "cuts" && engine != "flowmap" && engine != "zdd"
+          && engine != "seqmap")
+        throw std::runtime_error ("Unknown engine '" + engine + "'");
+    if (numRepeats < 1)
+      throw std::runtime_error ("The number of repeats must be at least 1.");
+
+    // Load the baseline first, so that a bad file fails before the runs
+    std::string parameters = parametersLine (k, c, mappingGoal);
+    std::map<std::pair<std::string, std::string>, BenchmarkSamples>
+        baselineMap;
+    if (!baselineFile.empty ())
+      baselineMap = loadBaseline (baselineFile, parameters);
+
+    // Default to every AIGER file of the suite, then to the sequential
+    // designs if there are any
+    if (designs.empty ())
+      {
+        auto addDesigns = [&designs] (const std::string &dir) {
+          std::vector<std::string> dirDesigns;
+          for (const auto &entry :
+               std::filesystem::recursive_directory_iterator (dir))
+            if (entry.is_regular_file ()
+                && entry.path ().extension () == ".aig")
+              dirDesigns.push_back (entry.path ().string ());
+          std::sort (dirDesigns.begin (), dirDesigns.end ());
+          designs.insert (designs.end (), dirDesigns.begin (),
+                          dirDesigns.end ());
+        };
+        addDesigns (aigerDir);
+        if (std::filesystem::is_directory (sequentialDir))
+          addDesigns (sequentialDir);
+      }
+
+    std::cout << ">> Benchmark: k = " << k << ", c = " << c << ", goal = "
+              << (mappingGoal == MappingGoal::MinimizeDelay ? "delay" : "area")
+              << ", runs = " << numRepeats << std::endl;
+    std::cout << std::left << std::setw (14) << "design";
+    for (const auto &engine : engines)
+      std::cout << std::right << std::setw (14) << (engine + " LUTs")
+                << std::setw (8) << "levels" << std::setw (11) << "time (s)"
+                << std::setw (10) << "RSS (MB)";
+    std::cout << std::endl;
+
+    // Times and RSS are medians of the runs
+    std::map<std::string, BenchmarkResult> totals;
+    std::map<std::pair<std::string, std::string>, BenchmarkSamples>
+        samplesMap;
+    for (const auto &design : designs)
+      {
+        std::string designName
+            = std::filesystem::path (design).stem ().string ();
+        std::cout << std::left << std::setw (14) << designName << std::flush;
+        std::unique_ptr<AndInverterGraph> aigPointer;
+        try
+          {
+            aigPointer.reset (new AndInverterGraph (design));
+          }
+        catch (const std::exception &e)
+          {
+            std::cout << " skipped: " << e.what () << std::endl;
+            continue;
+          }
+        const AndInverterGraph &aig = *aigPointer;
+        for (const auto &engine : engines)
+          {
+            BenchmarkSamples &samples = samplesMap[{ designName, engine }];
+            for (unsigned int i = 0; i < numRepeats; i++)
+              {
+                BenchmarkResult run
+                    = runIsolated (aig, engine, k, c, mappingGoal);
+                samples.lutCount = run.lutCount;
+                samples.levels = run.levels;
+                samples.secondsVector.push_back (run.seconds);
+                samples.peakRssVector.push_back (run.peakRss);
+              }
+            double seconds = summarize (samples.secondsVector).median;
+            double peakRss = summarize (samples.peakRssVector).median;
+            std::cout << std::right << std::setw (14) << samples.lutCount
+                      << std::setw (8) << samples.levels << std::setw (11)
+                      << std::fixed << std::setprecision (3) << seconds
+                      << std::setw (10) << std::setprecision (1)
+                      << peakRss / 1024 << std::flush;
+            totals[engine].lutCount += samples.lutCount;
+            totals[engine].levels += samples.levels;
+            totals[engine].seconds += seconds;
+          }
+        std::cout << std::endl;
+      }
+
+    std::cout << std::left << std::setw (14) << "total";
+    for (const auto &engine : engines)
+      std::cout << std::right << std::setw (14) << totals[engine].lutCount
+                << std::setw (8) << totals[engine].levels << std::setw (11)
+                << std::fixed << std::setprecision (3)
+                << totals[engine].seconds << std::setw (10) << "";
+    std::cout << std::endl;
+
+    if (!saveBaselineFile.empty ())
+      saveBaseline (saveBaselineFile, parameters, samplesMap);
+    if (!baselineFile.empty ())
+      {
+        std::cout << ">> Comparison with " << baselineFile
+                  << ": median +- MAD, threshold = " << std::defaultfloat
+                  << threshold << "%" << std::endl;
+        unsigned int numRegressions
+            = compareWithBaseline (baselineMap, samplesMap, threshold);
+        std::cout << "# Regressions: " << numRegressions << std::endl;
+        if (numRegressions > 0)
+          return 2;
+      }
+
+    return 0;
+  }
+catch (const std::exception &e)
+  {
+    std::cerr << "An error has ocurred.\n  what(): " << e.what () << std::endl;
+    return 1;
+  }
@@ -0,0 +1,164 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _ALLOCATIONTRACKER_H
+#define _ALLOCATIONTRACKER_H
+
+#include <cstdint>
+#include <iostream>
+
+/**
+ * @brief Counts the heap allocations of tmap by phase (parse, enumeration,
+ * cover, ...) and by subsystem (cut sets, truth tables, ...).
+ *
+ * Tracking is opt-in: it is compiled only when tmap is configured with
+ * -DTMAP_ALLOCATION_TRACKING=ON, which replaces the global operators new and
+ * delete. Every allocation is charged to the phase and to the subsystem
+ * active in its thread, set by the TMAP_ALLOCATION_PHASE() and
+ * TMAP_ALLOCATION_SUBSYSTEM() scopes, and its release is charged to the same
+ * tags. Without tracking the scopes expand to nothing.
+ *
+ */
+class AllocationTracker
+{
+public:
+  // Largest number of tags, including the two "no tag" tags
+  static constexpr unsigned int MaxTags = 64;
+
+  enum class TagKind
+  {
+    Phase,
+    Subsystem
+  };
+
+  struct Statistics
+  {
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t liveBytes = 0;
+    std::uint64_t peakLiveBytes = 0;
+  };
+
+  /**
+   * @brief Returns @c true if tmap was built with allocation tracking.
+   *
+   * @return boolean
+   */
+  static bool isEnabled () noexcept;
+
+  /**
+   * @brief Returns the tag of a phase or subsystem, registering it on first
+   * use. Throws @c std::overflow_error() if there are already MaxTags tags.
+   *
+   * @param name Name of the phase or subsystem (must outlive the program)
+   * @param kind
+   * @return unsigned int
+   */
+  static unsigned int registerTag (const char *name, TagKind kind);
+
+  /**
+   * @brief Returns the kind of a tag.
+   *
+   * @param tag
+   * @return TagKind
+   */
+  static TagKind getTagKind (unsigned int tag);
+
+  /**
+   * @brief Returns the tag active in the calling thread for a kind.
+   *
+   * @param kind
+   * @return unsigned int
+   */
+  static unsigned int getCurrentTag (TagKind kind) noexcept;
+
+  /**
+   * @brief Sets the tag active in the calling thread for the kind of @c tag.
+   * Use AllocationScope instead of calling it directly.
+   *
+   * @param tag
+   */
+  static void setCurrentTag (unsigned int tag);
+
+  /**
+   * @brief Returns the statistics of the allocations charged to a tag.
+   *
+   * @param tag
+   * @return Statistics
+   */
+  static Statistics getStatistics (unsigned int tag);
+
+  /**
+   * @brief Returns the statistics of all allocations.
+   *
+   * @return Statistics
+   */
+  static Statistics getTotalStatistics () noexcept;
+
+  /**
+   * @brief Prints the statistics of every phase and subsystem to a C++
+   * output stream.
+   *
+   * @param os
+   */
+  static void print (std::ostream &os);
+
+  /**
+   * @brief Charges an allocation of @c size bytes to a phase and a
+   * subsystem. Called by the replacement of operator new.
+   *
+   */
+  static void recordAllocation (std::size_t size, unsigned int phaseTag,
+                                unsigned int subsystemTag) noexcept;
+
+  /**
+   * @brief Charges the release of @c size bytes to a phase and a subsystem.
+   * Called by the replacement of operator delete.
+   *
+   */
+  static void recordRelease (std::size_t size, unsigned int phaseTag,
+                             unsigned int subsystemTag) noexcept;
+};
+
+/**
+ * @brief Makes a tag the active one of its kind in the calling thread until
+ * the end of the scope.
+ *
+ */
+class AllocationScope
+{
+public:
+  explicit AllocationScope (unsigned int tag);
+  ~AllocationScope ();
+  AllocationScope (const AllocationScope &) = delete;
+  AllocationScope &operator= (const AllocationScope &) = delete;
+
+private:
+  unsigned int _previousTag = 0;
+};
+
+#ifdef TMAP_ALLOCATION_TRACKING
+#define TMAP_ALLOCATION_CONCAT_(a, b) a##b
+#define TMAP_ALLOCATION_CONCAT(a, b) TMAP_ALLOCATION_CONCAT_ (a, b)
+#define TMAP_ALLOCATION_SCOPE(name, kind)                                     \
+  static const unsigned int TMAP_ALLOCATION_CONCAT (_allocationTag, __LINE__) \
+      = AllocationTracker::registerTag (name, kind);                          \
+  AllocationScope TMAP_ALLOCATION_CONCAT (_allocationScope, __LINE__) (       \
+      TMAP_ALLOCATION_CONCAT (_allocationTag, __LINE__))
+#else
+#define TMAP_ALLOCATION_SCOPE(name, kind) static_cast<void> (0)
+#endif
+
+#define TMAP_ALLOCATION_PHASE(name)                                           \
+  TMAP_ALLOCATION_SCOPE (name, AllocationTracker::TagKind::Phase)
+#define TMAP_ALLOCATION_SUBSYSTEM(name)                                       \
+  TMAP_ALLOCATION_SCOPE (name, AllocationTracker::TagKind::Subsystem)
+
+#endif
@@ -11,11 +11,18 @@
 #ifndef _ANDINVERTERGRAPH_H
 #define _ANDINVERTERGRAPH_H
 
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "AndNode.h"
 #include "LatchNode.h"
+#include "StringPool.h"
 
 class AndInverterGraph {
  public:
@@ -25,11 +32,67 @@ class AndInverterGraph {
    * @brief Constructs a new AndInverterGraph object and initializes it from
    * @c filePath.
    *
-   * @param filePath A string with the path to the AIGER file. Both binary and
-   * ASCII formats are supported. Example: "/home/user/myaigerfile.aig".
+   * Files whose name ends with ".blif" are read as BLIF netlists: their
+   * @c .names covers are decomposed into and-nodes while reading (see
+   * initializeFromBlif()). Files written by saveSnapshot() are recognized by
+   * their magic number and mapped into memory (see initializeFromSnapshot()).
+   * Any other file is read as AIGER.
+   *
+   * @param filePath A string with the path to the AIGER or BLIF file. Both
+   * binary and ASCII AIGER formats are supported. Example:
+   * "/home/user/myaigerfile.aig".
    */
   AndInverterGraph(const std::string &filePath);
 
+  /**
+   * @brief Constructs a new combinational AndInverterGraph object in memory:
+   * @c numInputs inputs, then one and-node per pair of children literals in
+   * @c andChildVector (in topological order, with @c rhs0 >= @c rhs1), and
+   * the outputs in @c outputLiteralVector. @c name stands for the file path
+   * in messages. Throws @c std::runtime_error() if a node breaks the rules of
+   * the AIGER format.
+   *
+   * @param name
+   * @param numInputs
+   * @param andChildVector
+   * @param outputLiteralVector
+   */
+  AndInverterGraph(
+      const std::string &name, unsigned int numInputs,
+      const std::vector<std::pair<unsigned int, unsigned int>> &andChildVector,
+      const std::vector<unsigned int> &outputLiteralVector);
+
+  // Nodes may live in a memory mapped snapshot, which copies would not own
+  AndInverterGraph(const AndInverterGraph &) = delete;
+  AndInverterGraph &operator=(const AndInverterGraph &) = delete;
+
+  // Version of the snapshot format written by saveSnapshot()
+  static constexpr unsigned int SnapshotVersion = 1;
+
+  /**
+   * @brief Saves a snapshot of the AndInverterGraph object to @c filePath: a
+   * binary image of its and-nodes, latches and outputs (with their fanouts),
+   * and optionally of its symbols and comments, that the constructor loads
+   * by mapping the file into memory instead of parsing it. Sections are
+   * aligned to 64 bytes. Snapshots are only portable between builds of tmap
+   * with the same snapshot version, byte order and node layout; loading
+   * checks all three. Throws @c std::runtime_error() if the file cannot be
+   * written.
+   *
+   * @param filePath Path of the snapshot file
+   * @param includeSymbols Whether symbols and comments are saved
+   */
+  void saveSnapshot(const std::string &filePath,
+                    bool includeSymbols = true) const;
+
+  /**
+   * @brief Returns @c true if the AndInverterGraph object was loaded from a
+   * snapshot.
+   *
+   * @return bool
+   */
+  bool isSnapshot() const noexcept;
+
   /**
    * @brief Returns @c true if the AndInverterGraph object is sucessfully
    * initialized, and @c false otherwise.
@@ -181,6 +244,44 @@ class AndInverterGraph {
    */
   unsigned int getFirstLatchLiteral() const noexcept;
 
+  /**
+   * @brief Returns the name of an input (0 to getNumInputs() - 1), or an
+   * empty string if the inputs are not named. Symbols are parsed on the
+   * first call to any of the name getters, so that mapping never pays for
+   * them. Throws @c std::out_of_range() if the index is not valid, and
+   * @c std::runtime_error() if the symbol table is malformed.
+   *
+   * @param inputIndex
+   * @return std::string_view
+   */
+  std::string_view getInputName(unsigned int inputIndex) const;
+
+  /**
+   * @brief Returns the name of a latch (0 to getNumLatches() - 1), or an
+   * empty string if the latches are not named. See getInputName().
+   *
+   * @param latchIndex
+   * @return std::string_view
+   */
+  std::string_view getLatchName(unsigned int latchIndex) const;
+
+  /**
+   * @brief Returns the name of an output (0 to getNumOutputs() - 1), or an
+   * empty string if the outputs are not named. See getInputName().
+   *
+   * @param outputIndex
+   * @return std::string_view
+   */
+  std::string_view getOutputName(unsigned int outputIndex) const;
+
+  /**
+   * @brief Returns the lines of the comment section, if any. See
+   * getInputName().
+   *
+   * @return std::vector<std::string_view>
+   */
+  std::vector<std::string_view> getComments() const;
+
   /**
    * @brief Prints all AIG information to a C++ output stream.
    *
@@ -209,16 +310,90 @@ class AndInverterGraph {
   std::vector<unsigned int> _outputLiteralVector;
   std::vector<AndNode> _andVector;
   std::vector<LatchNode> _latchVector;
-  std::vector<std::string> _inputNameVector;
-  std::vector<std::string> _latchNameVector;
-  std::vector<std::string> _outputNameVector;
-  std::vector<std::string> _commentVector;
-  bool _hasNamedInputs = false;
-  bool _hasNamedLatches = false;
-  bool _hasNamedOutputs = false;
-  bool _hasComments = false;
+  // The nodes: the contents of _andVector and _latchVector, or arrays in the
+  // memory mapped snapshot (kept alive by _snapshotData)
+  const AndNode *_andNodes = nullptr;
+  const LatchNode *_latchNodes = nullptr;
+  std::shared_ptr<const char> _snapshotData;
+
+  // Symbols and comments, as ids in a pool of interned strings. Each vector
+  // is empty if the AIG has no such symbols
+  struct SymbolTable {
+    StringPool pool;
+    std::vector<unsigned int> inputNames;
+    std::vector<unsigned int> latchNames;
+    std::vector<unsigned int> outputNames;
+    std::vector<unsigned int> comments;
+  };
+  mutable SymbolTable _symbolTable;
+  mutable std::once_flag _symbolTableLoaded;
+  // Offset of the symbol table in the AIGER file or in the snapshot (-1 if
+  // there is none), and what the snapshot stores there
+  std::int64_t _symbolOffset = -1;
+  std::uint64_t _snapshotSymbolSize = 0;
+  std::uint64_t _snapshotNumComments = 0;
+  unsigned int _snapshotFlags = 0;
   bool _initialized = false;
   bool _isBinary = false;
+  bool _isBlif = false;
+  bool _isSnapshot = false;
+
+  /**
+   * @brief Initializes the AndInverterGraph object from a BLIF netlist.
+   *
+   * Only the first model of the file is read. Its @c .names covers are
+   * decomposed into two-input and-nodes with structural hashing, and its
+   * @c .latch statements become latch nodes. The resulting object has the
+   * same layout as one read from AIGER: inputs first, then latches, then
+   * and-nodes in topological order with @c rhs0 >= @c rhs1. Logic that does
+   * not reach an output or a latch is not created. Throws
+   * @c std::runtime_error() on syntax errors, undriven nets, combinational
+   * loops and unsupported constructs (@c .subckt, @c .gate, @c .mlatch).
+   *
+   * @param inputFile An open stream positioned at the start of the file
+   */
+  void initializeFromBlif(std::ifstream &inputFile);
+
+  /**
+   * @brief Initializes the AndInverterGraph object from a snapshot written
+   * by saveSnapshot(). The file is mapped into memory and the nodes are used
+   * in place; only the outputs and the symbols (if any) are copied. Throws
+   * @c std::runtime_error() if the snapshot has another version, byte order
+   * or node layout, or if it is truncated.
+   *
+   * @param filePath
+   */
+  void initializeFromSnapshot(const std::string &filePath);
+
+  /**
+   * @brief Returns the symbol table, loading it on the first call (see
+   * loadSymbolTable()). Safe to call from several threads.
+   *
+   * @return const SymbolTable&
+   */
+  const SymbolTable &getSymbolTable() const;
+
+  /**
+   * @brief Parses the symbol table and the comments at _symbolOffset, from
+   * the AIGER file (which is opened again) or from the mapped snapshot.
+   * Throws @c std::runtime_error() if they are malformed or incomplete.
+   *
+   */
+  void loadSymbolTable() const;
+
+  /**
+   * @brief Parses the symbol lines ("i0 name", "l0 name", "o0 name") and the
+   * comment section of an AIGER file. See loadSymbolTable().
+   *
+   */
+  void loadAigerSymbolTable() const;
+
+  /**
+   * @brief Decodes the symbols and comments of a snapshot. See
+   * loadSymbolTable().
+   *
+   */
+  void loadSnapshotSymbolTable() const;
 
   /**
    * @brief Converts an and-literal into an index to access _andVector.
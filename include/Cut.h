@@ -14,6 +14,8 @@
 #include <iostream>
 #include <set>
 
+#include "TruthTable.h"
+
 class Cut
 {
 public:
@@ -106,6 +108,42 @@ public:
    */
   void unsetPowerCost () noexcept;
 
+  /**
+   * @brief Sets the truth table of the function implemented by the cut.
+   * Variable @c i of the table is the @c i-th node variable of the cut, in
+   * increasing order. Throws an exception if the number of variables of the
+   * table differs from the number of node variables.
+   *
+   * @param truthTable
+   */
+  void setTruthTable (const TruthTable &truthTable);
+
+  /**
+   * @brief Returns a read-only reference to the truth table of the cut. The
+   * table is empty if it has not been set.
+   *
+   * @return const TruthTable&
+   */
+  const TruthTable &getTruthTable () const noexcept;
+
+  /**
+   * @brief Boolean predicate that returns true if the truth table of the cut
+   * has been set.
+   *
+   * @return boolean
+   */
+  bool hasTruthTable () const noexcept;
+
+  /**
+   * @brief Removes the node variables the function of the cut does not
+   * depend on, shrinking both the variable set and the truth table. Returns
+   * the number of node variables removed. Throws an exception if the truth
+   * table has not been set.
+   *
+   * @return unsigned int
+   */
+  unsigned int removeVacuousVariables ();
+
   /**
    * @brief Boolean predicate that returns true if the Cut object has no node
    * variables
@@ -180,6 +218,7 @@ private:
   unsigned int _areaCost = -1;
   unsigned int _delayCost = -1;
   unsigned int _powerCost = -1;
+  TruthTable _truthTable = {};
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,92 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _CUTARENA_H
+#define _CUTARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+
+/**
+ * @brief Bump allocator that holds the cut sets enumerated by one worker of a
+ * CutEngine. Allocation is a pointer increment inside a chunk; nothing is
+ * freed until release() is called, which frees every chunk at once.
+ *
+ * Chunks are bound to a NUMA node (see NumaTopology) when the machine has
+ * more than one, so that the cut sets of a worker live next to the CPUs it
+ * runs on. Otherwise they come from the heap.
+ *
+ */
+class CutArena
+{
+public:
+  /**
+   * @brief Construct a new CutArena object whose memory is placed on
+   * @c numaNode.
+   *
+   * @param numaNode
+   */
+  explicit CutArena (unsigned int numaNode = 0);
+
+  CutArena (const CutArena &) = delete;
+  CutArena &operator= (const CutArena &) = delete;
+
+  /**
+   * @brief Returns the memory resource from which the arena allocates.
+   *
+   * @return std::pmr::memory_resource*
+   */
+  std::pmr::memory_resource *getResource () noexcept;
+
+  /**
+   * @brief Returns the NUMA node of the arena.
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumaNode () const noexcept;
+
+  /**
+   * @brief Frees all memory of the arena. Objects allocated from it must have
+   * been destroyed.
+   *
+   */
+  void release ();
+
+private:
+  /**
+   * @brief Upstream resource of the arena: chunks mapped with mmap and bound
+   * to a NUMA node, or heap chunks on single node machines.
+   *
+   */
+  class ChunkResource : public std::pmr::memory_resource
+  {
+  public:
+    explicit ChunkResource (unsigned int numaNode);
+
+  private:
+    unsigned int _numaNode = 0;
+    bool _bindChunks = false;
+
+    void *do_allocate (std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate (void *chunk, std::size_t bytes,
+                        std::size_t alignment) override;
+    bool do_is_equal (
+        const std::pmr::memory_resource &other) const noexcept override;
+  };
+
+  // Size of the first chunk; each new chunk is larger than the previous one
+  static constexpr std::size_t InitialChunkSize = 64 * 1024;
+
+  unsigned int _numaNode = 0;
+  ChunkResource _chunkResource;
+  std::pmr::monotonic_buffer_resource _arena;
+};
+
+#endif
@@ -11,11 +11,20 @@
 #ifndef _CUTENGINE_H
 #define _CUTENGINE_H
 
+#include <atomic>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <string>
+#include <utility>
 
 #include "AndInverterGraph.h"
 #include "Cut.h"
+#include "CutArena.h"
 #include "CutSet.h"
+#include "CutSpillFile.h"
+#include "MappingEngine.h"
+#include "MappingObserver.h"
 
 enum class MappingGoal
 {
@@ -23,19 +32,44 @@ enum class MappingGoal
   MinimizeDelay
 };
 
-class CutEngine
+/**
+ * @brief Mapping engine that enumerates K-feasible cuts explicitly.
+ *
+ * The engine notifies the events of the enumeration through
+ * @c ObserverPolicy (see MappingObserver.h). CutEngine uses
+ * NullObserverPolicy, whose notifications compile to nothing;
+ * ObservedCutEngine uses DynamicObserverPolicy, which forwards them to the
+ * MappingObserver registered with setObserver(). Both are instantiated in
+ * the library.
+ *
+ * run() can enumerate with several threads (see setNumThreads()). In that
+ * case the observer is notified from all of them and must be thread-safe.
+ *
+ */
+template <typename ObserverPolicy>
+class CutEngineBase : public MappingEngine, public ObserverPolicy
 {
 public:
-  CutEngine () = delete;
+  CutEngineBase () = delete;
 
   /**
    * @brief Construct a new CutEngine object from an AndInverterGraph object.
    *
    * @param aig An AndInverterGraph object
    */
-  CutEngine (const AndInverterGraph &aig,
-             MappingGoal mappingGoal = MappingGoal::MinimizeArea,
-             unsigned int k = 6, unsigned int c = 0);
+  CutEngineBase (const AndInverterGraph &aig,
+                 MappingGoal mappingGoal = MappingGoal::MinimizeArea,
+                 unsigned int k = 6, unsigned int c = 0);
+
+  CutEngineBase (const CutEngineBase &) = delete;
+  CutEngineBase &operator= (const CutEngineBase &) = delete;
+
+  /**
+   * @brief Destroy the CutEngine object, releasing the arenas of its cut
+   * sets.
+   *
+   */
+  ~CutEngineBase ();
 
   /**
    * @brief Given two cuts (cutA and cutB), this method decides whether cutA is
@@ -107,7 +141,7 @@ public:
    *
    * @return const AndInverterGraph&
    */
-  const AndInverterGraph &getAndInverterGraph () const noexcept;
+  const AndInverterGraph &getAndInverterGraph () const noexcept override;
 
   /**
    * @brief Boolean predicate that returns @c true if the best cut has been
@@ -116,16 +150,20 @@ public:
    * @param andLiteral The literal of an and-node
    * @return boolean
    */
-  bool hasBestCut (unsigned int andLiteral) const;
+  bool hasBestCut (unsigned int andLiteral) const override;
 
   /**
    * @brief Returns a read-only reference for the CutSet of an and-node. If the
    * CutSet has not been evaluated it returns a reference for an empty CutSet.
    *
+   * In out-of-core mode (see setOutOfCore()) a spilled cut set is read back
+   * into a buffer of the engine, and the reference is only valid until the
+   * next call for another spilled node.
+   *
    * @param andLiteral The literal of an and-node
    * @return const CutSet&
    */
-  const CutSet &getCutSet (unsigned int andLiteral) const;
+  const CutSet &getCutSet (unsigned int andLiteral) const override;
 
   /**
    * @brief Returns a read-only reference for the best Cut of an and-node.
@@ -135,7 +173,145 @@ public:
    * @param andLiteral The literal of an and-node
    * @return const Cut&
    */
-  const Cut &getBestCut (unsigned int andLiteral) const;
+  const Cut &getBestCut (unsigned int andLiteral) const override;
+
+  /**
+   * @brief Returns a read-only reference for the selected Cut of an and-node:
+   * its best cut with a truth table and, when support reduction is enabled,
+   * without the leaves its function does not depend on. Its delay cost is
+   * evaluated from the selected cuts of its leaves. Throws an exception if
+   * the cuts of @c andLiteral have not been found yet.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return const Cut&
+   */
+  const Cut &getSelectedCut (unsigned int andLiteral) const override;
+
+  /**
+   * @brief Enables or disables support reduction of the selected cuts
+   * (enabled by default). It only takes effect for nodes whose cuts are
+   * found afterwards, and only if K is not greater than
+   * TruthTable::MaxVariables.
+   *
+   * @param supportReduction
+   */
+  void setSupportReduction (bool supportReduction) noexcept;
+
+  /**
+   * @brief Enables or disables the pruning of dominated cuts (disabled by
+   * default): a cut whose leaves are a superset of the leaves of another cut
+   * of the same node is discarded before the c best cuts are chosen. It only
+   * takes effect for nodes whose cuts are found afterwards.
+   *
+   * @param pruneDominated
+   */
+  void setDominancePruning (bool pruneDominated) noexcept;
+
+  /**
+   * @brief Sets the delay model used to evaluate the delay cost of cuts (the
+   * unit delay model by default). Cuts already found are discarded.
+   *
+   * @param delayModel
+   */
+  void setDelayModel (const DelayModel &delayModel);
+
+  /**
+   * @brief Returns the delay model used to evaluate the delay cost of cuts.
+   *
+   * @return DelayModel
+   */
+  DelayModel getDelayModel () const noexcept override;
+
+  /**
+   * @brief Returns the fanout estimates of the nodes (see
+   * updateFanoutEstimates()).
+   *
+   * @return std::vector<unsigned int>
+   */
+  std::vector<unsigned int> getFanoutEstimates () const override;
+
+  /**
+   * @brief Replaces the fanout estimates of the nodes, which are initialized
+   * to 1 (a single sink per net). If the delay model depends on fanout the
+   * cuts already found are discarded and @c true is returned; otherwise
+   * nothing changes and @c false is returned.
+   *
+   * @param fanoutVector Fanout of each variable index in the last cover
+   * @return boolean
+   */
+  bool updateFanoutEstimates (
+      const std::vector<unsigned int> &fanoutVector) override;
+
+  /**
+   * @brief Sets the number of threads used by run() (1 by default). The
+   * and-nodes are enumerated in depth-first order from the outputs, and the
+   * threads take consecutive nodes of that order; a node waits for the nodes
+   * before it whose results it reads. Each thread is bound to a NUMA node and
+   * allocates the cut sets it enumerates from its own CutArena. The cuts
+   * found and selected do not depend on the number of threads.
+   *
+   * @param numThreads
+   */
+  void setNumThreads (unsigned int numThreads) noexcept;
+
+  /**
+   * @brief Returns the number of threads used by run().
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumThreads () const noexcept;
+
+  /**
+   * @brief Enables out-of-core mode for designs whose cut sets do not fit in
+   * memory, or disables it if @c window is 0 (the default). Cuts already
+   * found are discarded.
+   *
+   * In out-of-core mode run() enumerates with one thread and keeps in memory
+   * only the cut sets needed within the next @c window nodes it enumerates.
+   * A cut set none of whose fanouts is that close is written to a scratch
+   * file (see CutSpillFile) in @c scratchDirectory, or in the temporary
+   * directory of the system if it is empty, and only its best cut stays in
+   * memory. Phi operation reads it back when a fanout is enumerated. The
+   * cuts found are the same as in memory. Throws @c std::runtime_error() if
+   * the scratch file cannot be created.
+   *
+   * @param window Number of nodes ahead whose cut sets stay in memory
+   * @param scratchDirectory
+   */
+  void setOutOfCore (unsigned int window,
+                     const std::string &scratchDirectory = "");
+
+  /**
+   * @brief Returns the window of the out-of-core mode (0 if it is disabled).
+   *
+   * @return unsigned int
+   */
+  unsigned int getOutOfCoreWindow () const noexcept;
+
+  /**
+   * @brief Returns the number of bytes of cut sets written to the scratch
+   * file by the out-of-core mode.
+   *
+   * @return std::uint64_t
+   */
+  std::uint64_t getNumSpilledBytes () const noexcept;
+
+  /**
+   * @brief Counts the and-nodes enumerated by run() in @c progress and checks
+   * it between nodes. When it is cancelled, the threads stop taking nodes,
+   * the cuts found are discarded with reset() (arenas and scratch file
+   * included) and run() throws MappingCancelled.
+   *
+   * @param progress A MappingProgress object, or @c nullptr
+   */
+  void setProgress (MappingProgress *progress) noexcept override;
+
+  /**
+   * @brief Discards all cuts found, so that the next calls to findCuts()
+   * evaluate them again.
+   *
+   */
+  void reset ();
 
   /**
    * @brief Finds K-feasible cuts for an and-node in the AndInverterGraph
@@ -151,17 +327,22 @@ public:
    * If the CutSet of @c andLiteral is already defined it is simply returned
    * (the operation is not applied again).
    *
+   * The nodes are enumerated in depth-first order from @c andLiteral, with
+   * the implementation map updated after each node, as run() does from each
+   * output in turn.
+   *
    * @param andLiteral The literal of an and-node
    * @return const CutSet&
    */
-  const CutSet &findCuts (const unsigned int &andLiteral);
+  const CutSet &findCuts (const unsigned int &andLiteral) override;
 
   /**
    * @brief Run the CutEngine. Find cuts for all and-nodes in the
-   * AndInverterGraph object used to create the CutEngine.
+   * AndInverterGraph object used to create the CutEngine, with the number of
+   * threads set by setNumThreads().
    *
    */
-  void run ();
+  void run () override;
 
   /**
    * @brief Overloads operator << so that all cuts found by the CutEngine can
@@ -173,14 +354,47 @@ public:
    */
   void printOutputsBestCuts (std::ostream &os) const;
 
+  template <typename Policy>
   friend std::ostream &operator<< (std::ostream &os,
-                                   const CutEngine &cutEngine);
+                                   const CutEngineBase<Policy> &cutEngine);
   void printImplementation (std::ostream &os);
 
 private:
-  std::vector<CutSet> _cutSetVector = {};
+  // Cut set of each and-node, or nullptr if it has not been evaluated. Cut
+  // sets are constructed in the arena of the thread that enumerated them and
+  // published complete (with their selected cut) by a release store, so
+  // readers that acquire a non-null slot need no lock
+  std::vector<std::atomic<CutSet *>> _cutSetVector = {};
+  std::vector<std::unique_ptr<CutArena>> _arenaVector = {};
+  const CutSet _emptyCutSet = {};
+  unsigned int _numThreads = 1;
+  MappingProgress *_progress = nullptr;
+  // Out-of-core mode: cut sets in memory are owned by _residentCutSetVector
+  // instead of an arena. A spilled node keeps a cut set with its best cut
+  // only, and the offset of its full cut set in _spillFile
+  static constexpr std::uint64_t NotSpilled = -1;
+  unsigned int _outOfCoreWindow = 0;
+  std::unique_ptr<CutSpillFile> _spillFile = nullptr;
+  std::vector<std::unique_ptr<CutSet>> _residentCutSetVector = {};
+  std::vector<std::uint64_t> _spillOffsetVector = {};
+  mutable CutSet _spilledCutSet = {};
+  mutable unsigned int _spilledCutSetIndex = -1;
+  std::vector<Cut> _selectedCutVector = {};
+  bool _supportReduction = true;
+  bool _pruneDominated = false;
+  DelayModel _delayModel = {};
+  std::vector<unsigned int> _fanoutEstimateVector = {};
   MappingGoal _mappingGoal = MappingGoal::MinimizeArea;
   std::map<unsigned int, bool> _implementationMap = {};
+  // During run(): the position of each and-node in the order of the run, or
+  // NoPosition, and the position from which each and-node is no longer
+  // implemented for the nodes of the run (see runDepthFirst()). Threads take
+  // NodesPerTake consecutive positions at a time
+  static constexpr unsigned int NoPosition = -1;
+  static constexpr unsigned int NodesPerTake = 16;
+  std::vector<unsigned int> _positionVector = {};
+  std::unique_ptr<std::atomic<unsigned int>[]> _unimplementedFromVector
+      = nullptr;
   const AndInverterGraph &_aig;
   unsigned int _k = 6;
   unsigned int _c = 0;
@@ -211,7 +425,8 @@ private:
    *
    * - If the node is an input, the cost is
    * -> For area and power, zero;
-   * -> For delay, 1;
+   * -> For delay, the lut delay plus the delay of the net driven by the
+   * input (see estimateNetDelay());
    *
    * - If the node is an and-node, the cost is:
    * -> For power, zero;
@@ -223,6 +438,141 @@ private:
    */
   Cut generateAutoCut (unsigned int nodeLiteral) const;
 
+  /**
+   * @brief Computes the truth table of the function implemented by @c cut
+   * for the and-node @c andLiteral, by bit-parallel simulation of the
+   * and-nodes between the leaves of the cut and the node.
+   *
+   * @param andLiteral The literal of an and-node
+   * @param cut A cut of @c andLiteral
+   * @return TruthTable
+   */
+  TruthTable computeTruthTable (unsigned int andLiteral, const Cut &cut) const;
+
+  /**
+   * @brief Defines the selected cut of an and-node from its best cut (see
+   * getSelectedCut()). The cut set of the node need not be published yet.
+   *
+   * @param andLiteral The literal of an and-node
+   * @param bestCut The best cut of the node
+   */
+  void selectCut (unsigned int andLiteral, const Cut &bestCut);
+
+  /**
+   * @brief Constructs a copy of @c cutSet in @c arena. The copy is not
+   * visible to readers until it is published.
+   *
+   * @param cutSet
+   * @param arena
+   * @return CutSet*
+   */
+  static CutSet *allocateCutSet (const CutSet &cutSet, CutArena &arena);
+
+  /**
+   * @brief Publishes @c cutSet as the cut set of an and-node, which must not
+   * have one. Everything written before by the calling thread (the cut set
+   * and the selected cut of the node) is visible to the threads that read
+   * the cut set afterwards.
+   *
+   * @param andLiteral The literal of an and-node
+   * @param cutSet A cut set constructed by allocateCutSet()
+   */
+  void publishCutSet (unsigned int andLiteral, CutSet *cutSet);
+
+  /**
+   * @brief Returns a copy of the CutSet of an and-node, reading it from the
+   * scratch file if it was spilled.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return CutSet
+   */
+  CutSet readCutSet (unsigned int andLiteral) const;
+
+  /**
+   * @brief Writes the cut set of an and-node kept in memory by the
+   * out-of-core mode to the scratch file, and replaces it with a cut set
+   * with its best cut only.
+   *
+   * @param vectorIndex
+   */
+  void spillCutSet (unsigned int vectorIndex);
+
+  /**
+   * @brief Destroys the cut sets found and releases their arenas. It must
+   * not run concurrently with readers.
+   *
+   */
+  void clearCutSets ();
+
+  /**
+   * @brief Finds the cuts of an and-node whose children have their cuts
+   * found: applies Phi operation, sorts (and prunes) the cuts, stores them
+   * in @c arena, updates the implementation map, selects a cut and publishes
+   * the cut set.
+   *
+   * If @c implementationUpdates is not null, the changes to the
+   * implementation map are appended to it instead of being applied, so that
+   * nodes enumerated at the same time do not write to the map.
+   *
+   * @param andLiteral The literal of an and-node
+   * @param arena
+   * @param implementationUpdates
+   */
+  void enumerateNode (
+      unsigned int andLiteral, CutArena &arena,
+      std::vector<std::pair<unsigned int, bool>> *implementationUpdates);
+
+  /**
+   * @brief Updates the implementation map after the best cut of an and-node
+   * is found, or appends the changes to @c implementationUpdates if it is
+   * not null (see enumerateNode()).
+   *
+   * @param andLiteral The literal of an and-node
+   * @param bestCut The best cut of the node
+   * @param implementationUpdates
+   */
+  void updateImplementationMap (
+      unsigned int andLiteral, const Cut &bestCut,
+      std::vector<std::pair<unsigned int, bool>> *implementationUpdates);
+
+  /**
+   * @brief Lists the positions of @c nodeOrder at which each and-node is read
+   * by a fanout, in increasing order: those of the and-node of vector index
+   * @c i are in useVector from useBeginVector[i] to useBeginVector[i + 1].
+   *
+   * @param nodeOrder Literals of the pending nodes, in order
+   * @param useBeginVector
+   * @param useVector
+   */
+  void findUsePositions (const std::vector<unsigned int> &nodeOrder,
+                         std::vector<unsigned int> &useBeginVector,
+                         std::vector<unsigned int> &useVector) const;
+
+  /**
+   * @brief Enumerates the nodes ordered by run() with setNumThreads()
+   * threads. The cuts found are the same as if the nodes were enumerated one
+   * by one in order, with the implementation map updated after each node.
+   *
+   * @param nodeOrder Literals of the pending nodes, in order
+   */
+  void runDepthFirst (const std::vector<unsigned int> &nodeOrder);
+
+  /**
+   * @brief Enumerates the nodes ordered by run() in out-of-core mode (see
+   * setOutOfCore()). After each node, the cut sets in memory whose next
+   * fanout is more than the window ahead are spilled.
+   *
+   * @param nodeOrder Literals of the pending nodes, in order
+   */
+  void runOutOfCore (const std::vector<unsigned int> &nodeOrder);
+
+  /**
+   * @brief If the run is cancelled (see setProgress()), discards the cuts
+   * found and throws MappingCancelled.
+   *
+   */
+  void stopIfCancelled ();
+
   /**
    * @brief Applies Phi operation for an and-node in the AndInverterGraph
    * object, returning the CutSet of all K-feasible cuts.
@@ -305,12 +655,29 @@ private:
   /**
    * @brief Estimate the delay cost for the auto cut of @c andLiteral. The
    * delay cost is estimated to be equal the delay cost of the best cut of
-   * @c andLiteral plus 1.
+   * @c andLiteral plus the delay of the net it drives and the lut delay. With
+   * the unit delay model this is the delay cost of the best cut plus 1.
    *
    * @param andLiteral
    * @return unsigned int
    */
   unsigned int estimateAutoCutDelayCost (unsigned int andLiteral) const;
+
+  /**
+   * @brief Estimate the delay of the net driven by a node, from the fanout
+   * estimate of the node (see updateFanoutEstimates()).
+   *
+   * @param nodeLiteral The literal of an input or and-node
+   * @return unsigned int
+   */
+  unsigned int estimateNetDelay (unsigned int nodeLiteral) const;
 };
 
+template <typename ObserverPolicy>
+std::ostream &operator<< (std::ostream &os,
+                          const CutEngineBase<ObserverPolicy> &cutEngine);
+
+using CutEngine = CutEngineBase<NullObserverPolicy>;
+using ObservedCutEngine = CutEngineBase<DynamicObserverPolicy>;
+
 #endif
\ No newline at end of file
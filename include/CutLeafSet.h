@@ -0,0 +1,125 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _CUTLEAFSET_H
+#define _CUTLEAFSET_H
+
+#include <bitset>
+#include <set>
+#include <vector>
+
+/**
+ * @brief Compact form of the leaves (node variables) of a cut, used while
+ * cuts are combined.
+ *
+ * Most leaves of a cut are close below its root, so the leaves are stored
+ * as a bitset over a window of WindowWidth variables starting at a window
+ * base: union is a bitwise OR, size a popcount and inclusion an AND. A cut
+ * with a leaf outside its window falls back to a sorted array of variables,
+ * and so does any operation between leaf sets of different windows.
+ *
+ */
+class CutLeafSet
+{
+public:
+  // Number of variables in a window
+  static constexpr unsigned int WindowWidth = 128;
+
+  /**
+   * @brief Construct an empty CutLeafSet object in the window that starts at
+   * variable 0.
+   *
+   */
+  CutLeafSet () = default;
+
+  /**
+   * @brief Construct a new CutLeafSet object with the variables of a cut, in
+   * the window that starts at @c windowBase.
+   *
+   * @param variables
+   * @param windowBase
+   */
+  CutLeafSet (const std::set<unsigned int> &variables,
+              unsigned int windowBase);
+
+  /**
+   * @brief Returns the first variable of the window of the leaf set. For a
+   * cut of the and-node with variable @c v, windows usually end at @c v.
+   *
+   * @param rootVariable
+   * @return unsigned int
+   */
+  static unsigned int windowBaseOf (unsigned int rootVariable) noexcept;
+
+  /**
+   * @brief Returns @c true if the leaves are stored as a bitset, and
+   * @c false if they fell back to a sorted array.
+   *
+   * @return boolean
+   */
+  bool isWindowed () const noexcept;
+
+  /**
+   * @brief Returns the number of leaves.
+   *
+   * @return unsigned int
+   */
+  unsigned int size () const noexcept;
+
+  /**
+   * @brief Returns @c true if every leaf of this set is a leaf of
+   * @c other, i.e. if a cut with the leaves of @c other is dominated.
+   *
+   * @param other
+   * @return boolean
+   */
+  bool isSubsetOf (const CutLeafSet &other) const;
+
+  /**
+   * @brief Returns the leaves as a set of node variables.
+   *
+   * @return std::set<unsigned int>
+   */
+  std::set<unsigned int> toSet () const;
+
+  /**
+   * @brief Returns the union of two leaf sets.
+   *
+   * @param rhs
+   * @return CutLeafSet
+   */
+  CutLeafSet operator| (const CutLeafSet &rhs) const;
+
+  /**
+   * @brief Returns the leaves as a sorted array, whatever their form.
+   *
+   * @return std::vector<unsigned int>
+   */
+  std::vector<unsigned int> toSortedArray () const;
+
+  /**
+   * @brief Writes the leaves as a sorted array into @c variables, whose
+   * capacity is reused, so that a caller that converts many leaf sets does
+   * not allocate for each of them.
+   *
+   * @param variables
+   */
+  void toSortedArray (std::vector<unsigned int> &variables) const;
+
+  bool operator== (const CutLeafSet &rhs) const;
+
+private:
+  unsigned int _windowBase = 0;
+  bool _windowed = true;
+  std::bitset<WindowWidth> _bits = {};
+  std::vector<unsigned int> _sortedVariables = {};
+};
+
+#endif
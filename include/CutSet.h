@@ -11,13 +11,23 @@
 #ifndef _CUTSET_H
 #define _CUTSET_H
 
+#include <memory_resource>
 #include <vector>
 
 #include "Cut.h"
 
-class CutSet : public std::vector<Cut>
+/**
+ * @brief Set of cuts of a node. Its storage comes from a polymorphic memory
+ * resource, which is the default (heap) one unless the CutSet is constructed
+ * with another (e.g. the CutArena of the worker that enumerated it). Copies
+ * use the default resource.
+ *
+ */
+class CutSet : public std::pmr::vector<Cut>
 {
 public:
+  using std::pmr::vector<Cut>::vector;
+
   /**
    * @brief Try to add a new cut to the set. If the new cut is already in the
    * set, returns a @c std::pair with an iterator to the cut as first element
@@ -28,7 +38,7 @@ public:
    * @param newCut
    * @return std::pair<iterator, bool>
    */
-  std::pair<std::vector<Cut>::iterator, bool> emplace (const Cut &newCut);
+  std::pair<iterator, bool> emplace (const Cut &newCut);
 
   // Delete some std::vector modifiers
   void assign () = delete;
@@ -0,0 +1,113 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _CUTSPILLFILE_H
+#define _CUTSPILLFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CutSet.h"
+
+/**
+ * @brief Scratch file, mapped into memory, where a CutEngine writes the cut
+ * sets it does not keep in memory. Cut sets are appended in a compact
+ * encoding (variables and costs of each cut) and read back by their offset.
+ *
+ * The file is created in a directory of choice and removed from it at once,
+ * so it disappears when the object is destroyed or the process exits. It
+ * grows in segments; once a segment is full its pages are handed back to
+ * the kernel, which writes them to the file and drops them from memory. A
+ * read faults in only the pages of the cut set it decodes.
+ *
+ */
+class CutSpillFile
+{
+public:
+  /**
+   * @brief Construct a new CutSpillFile object, creating the scratch file in
+   * @c directory (the temporary directory of the system if empty). Throws
+   * @c std::runtime_error() if the file cannot be created.
+   *
+   * @param directory
+   */
+  explicit CutSpillFile (const std::string &directory = "");
+
+  CutSpillFile (const CutSpillFile &) = delete;
+  CutSpillFile &operator= (const CutSpillFile &) = delete;
+
+  /**
+   * @brief Unmaps and closes the scratch file.
+   *
+   */
+  ~CutSpillFile ();
+
+  /**
+   * @brief Appends a cut set to the file and returns its offset. Truth tables
+   * of the cuts are not saved. Throws @c std::runtime_error() if the file
+   * cannot grow.
+   *
+   * @param cutSet
+   * @return std::uint64_t
+   */
+  std::uint64_t write (const CutSet &cutSet);
+
+  /**
+   * @brief Reads back the cut set written at @c offset.
+   *
+   * @param offset An offset returned by write()
+   * @return CutSet
+   */
+  CutSet read (std::uint64_t offset) const;
+
+  /**
+   * @brief Returns the number of bytes written to the file.
+   *
+   * @return std::uint64_t
+   */
+  std::uint64_t getNumBytes () const noexcept;
+
+  /**
+   * @brief Discards every cut set written and shrinks the file.
+   *
+   */
+  void clear ();
+
+private:
+  struct Segment
+  {
+    std::uint64_t fileOffset;
+    std::size_t size;
+    char *data;
+  };
+
+  // Minimum size of a segment; a cut set larger than it gets a segment of
+  // its own
+  static constexpr std::size_t SegmentSize = 64 * 1024 * 1024;
+
+  int _fileDescriptor = -1;
+  std::string _filePath = "";
+  std::vector<Segment> _segmentVector = {};
+  std::uint64_t _fileSize = 0;
+  std::size_t _segmentUsed = 0;
+  std::uint64_t _numBytes = 0;
+
+  /**
+   * @brief Grows the file by a new segment of at least @c minSize bytes and
+   * maps it, releasing the pages of the previous segment.
+   *
+   * @param minSize
+   */
+  void addSegment (std::size_t minSize);
+};
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _CUTTRIE_H
+#define _CUTTRIE_H
+
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Duplicate and dominance index over the leaf sets of the unions of
+ * one diamond operation (see CutEngineBase::diamondOperation()).
+ *
+ * Each leaf set, sorted, is a path from the root of a prefix trie, and a
+ * node that ends a path holds the index of its union in the container built
+ * by the diamond. Finding a repeated union walks one path instead of
+ * comparing it with every union, and finding a union whose leaves are a
+ * subset of a leaf set only descends into the children whose variable is in
+ * that set.
+ *
+ * The trie is scratch memory of the diamond: it does not store the cuts,
+ * whose leaves stay in their Cut objects, and it is discarded with the
+ * diamond. It does not follow the container either, so it must be rebuilt
+ * if the unions are reordered or removed.
+ *
+ */
+class CutTrie
+{
+public:
+  // Cut index of the trie nodes that do not end a cut
+  static constexpr std::size_t NoCut
+      = std::numeric_limits<std::size_t>::max ();
+
+  /**
+   * @brief Construct an empty CutTrie object whose nodes are allocated from
+   * @c resource.
+   *
+   * @param resource
+   */
+  explicit CutTrie (std::pmr::memory_resource *resource
+                    = std::pmr::get_default_resource ());
+
+  /**
+   * @brief Adds a cut with the leaves @c sortedLeaves (in increasing order)
+   * and the index @c cutIndex. If a cut with the same leaves is already in
+   * the trie, returns its index and @c bool(false). Otherwise returns
+   * @c cutIndex and @c bool(true).
+   *
+   * @param sortedLeaves
+   * @param cutIndex
+   * @return std::pair<std::size_t, bool>
+   */
+  std::pair<std::size_t, bool>
+  insert (const std::vector<unsigned int> &sortedLeaves, std::size_t cutIndex);
+
+  /**
+   * @brief Returns the index of the cut with the leaves @c sortedLeaves, or
+   * @c NoCut if there is none.
+   *
+   * @param sortedLeaves
+   * @return std::size_t
+   */
+  std::size_t find (const std::vector<unsigned int> &sortedLeaves) const;
+
+  /**
+   * @brief Returns @c true if the trie has a cut whose leaves are a proper
+   * subset of @c sortedLeaves, i.e. if a cut with the leaves
+   * @c sortedLeaves is dominated.
+   *
+   * @param sortedLeaves
+   * @return boolean
+   */
+  bool
+  containsProperSubsetOf (const std::vector<unsigned int> &sortedLeaves) const;
+
+  /**
+   * @brief Returns the number of cuts in the trie.
+   *
+   * @return std::size_t
+   */
+  std::size_t getNumCuts () const noexcept;
+
+  /**
+   * @brief Returns the number of trie nodes, i.e. the number of leaves
+   * indexed, with the common prefixes counted once.
+   *
+   * @return std::size_t
+   */
+  std::size_t getNumNodes () const noexcept;
+
+  /**
+   * @brief Removes every cut from the trie.
+   *
+   */
+  void clear () noexcept;
+
+private:
+  // Index of the trie nodes that do not exist (e.g. the child of a leaf)
+  static constexpr unsigned int NoNode
+      = std::numeric_limits<unsigned int>::max ();
+
+  // Children are kept in a list sorted by variable
+  struct Node
+  {
+    unsigned int variable;
+    unsigned int firstChild;
+    unsigned int nextSibling;
+    std::size_t cutIndex;
+  };
+
+  // Node 0 is the root and holds the cut with no leaves, if any
+  std::pmr::vector<Node> _nodeVector;
+  std::size_t _numCuts = 0;
+
+  /**
+   * @brief Returns @c true if the cut at @c nodeIndex, @c depth leaves below
+   * the root, or a cut below it has leaves that are a subset of the leaves
+   * matched so far and the leaves from @c first on, and fewer than
+   * @c numLeaves of them.
+   *
+   * @param nodeIndex
+   * @param first
+   * @param last
+   * @param depth
+   * @param numLeaves
+   * @return boolean
+   */
+  bool containsSubsetBelow (unsigned int nodeIndex,
+                            std::vector<unsigned int>::const_iterator first,
+                            std::vector<unsigned int>::const_iterator last,
+                            std::size_t depth, std::size_t numLeaves) const;
+};
+
+#endif
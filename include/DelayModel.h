@@ -0,0 +1,51 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _DELAYMODEL_H
+#define _DELAYMODEL_H
+
+/**
+ * @brief Delay of a lookup table and of the net driven by it.
+ *
+ * A signal reaches the inputs of the lookup tables it drives after
+ * getNetDelay(fanout) units, so a lookup table output is available
+ * @c lutDelay units after the latest of its inputs arrives. The default
+ * values (lutDelay = 1, wireDelay = 0) give the unit delay model, in which
+ * the delay of a mapping is its number of levels.
+ *
+ */
+struct DelayModel
+{
+  // Delay of a lookup table, from its inputs to its output
+  unsigned int lutDelay = 1;
+
+  // Routing delay added to a net each time its fanout doubles
+  unsigned int wireDelay = 0;
+
+  /**
+   * @brief Returns the routing delay of a net with @c fanout sinks, which is
+   * @c wireDelay times the ceiling of log2(fanout). Nets with fanout up to 1
+   * have no routing delay.
+   *
+   * @param fanout
+   * @return unsigned int
+   */
+  unsigned int getNetDelay (unsigned int fanout) const noexcept;
+
+  /**
+   * @brief Returns @c true if the delay of a net depends on its fanout, i.e.
+   * if @c wireDelay is not zero.
+   *
+   * @return boolean
+   */
+  bool dependsOnFanout () const noexcept;
+};
+
+#endif
@@ -0,0 +1,256 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _EXACTREMAPPER_H
+#define _EXACTREMAPPER_H
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "AndInverterGraph.h"
+#include "JsonWriter.h"
+#include "LutNetwork.h"
+#include "MappingEngine.h"
+#include "TechMapper.h"
+#include "WorkerPool.h"
+
+/**
+ * @brief Remaps small cones of the critical paths of a cover exactly, with
+ * a SAT solver: each cone gets a cover of minimum depth and then, at that
+ * depth, of minimum area.
+ *
+ * A cone is a critical lookup table and the lookup tables below it, at most
+ * MaxConeLuts of them within ConeLevels levels, and covers the and-nodes of
+ * their cuts (at most MaxConeAnds). Its boundary is made of the inputs and
+ * the lookup tables outside the cone that its and-nodes read, which keep
+ * their levels. Every K-feasible cut of each and-node over the cone (at
+ * most MaxCutsPerNode) is a candidate lookup table, and a SAT problem
+ * chooses which and-nodes are implemented, with which cut, so that the root
+ * of the cone and the lookup tables read from outside it are ready by given
+ * levels. The level of the root is lowered until the problem is
+ * unsatisfiable, then the number of lookup tables, under a conflict budget
+ * per cone. Lookup tables read from outside the cone must not get later, so
+ * no other path gets longer.
+ *
+ * Each pass picks cones from the critical lookup tables, from the outputs
+ * down, solves them in parallel and applies the better covers in order,
+ * skipping a cone that overlaps one applied before it. Passes repeat while
+ * a cone improves. The result does not depend on the number of threads.
+ *
+ */
+class ExactRemapper
+{
+public:
+  // Bounds of a cone
+  static constexpr unsigned int MaxConeLuts = 6;
+  static constexpr unsigned int ConeLevels = 3;
+  static constexpr unsigned int MaxConeAnds = 48;
+  // Candidate cuts kept per and-node of a cone, the smallest first
+  static constexpr unsigned int MaxCutsPerNode = 64;
+  // Cones solved per pass, and passes
+  static constexpr unsigned int MaxConesPerPass = 512;
+  static constexpr unsigned int MaxPasses = 8;
+  // Default number of conflicts allowed for the SAT problems of one cone
+  static constexpr std::uint64_t DefaultConflictBudget = 20000;
+
+  ExactRemapper () = delete;
+  ExactRemapper (const ExactRemapper &) = delete;
+  ExactRemapper &operator= (const ExactRemapper &) = delete;
+
+  /**
+   * @brief Construct a new ExactRemapper object from the cover of a
+   * TechMapper.
+   *
+   * @param mappingEngine The engine the cover was built from
+   * @param techMapper A TechMapper object, after run() has been called
+   * @param k Number of inputs of the lookup tables
+   */
+  ExactRemapper (const MappingEngine &mappingEngine,
+                 const TechMapper &techMapper, unsigned int k = 6);
+
+  /**
+   * @brief Sets the number of threads that solve cones (1 by default).
+   *
+   * @param numThreads
+   */
+  void setNumThreads (unsigned int numThreads) noexcept;
+
+  /**
+   * @brief Sets the number of conflicts allowed for the SAT problems of one
+   * cone. A cone over its budget keeps the best cover found so far.
+   *
+   * @param conflictBudget
+   */
+  void setConflictBudget (std::uint64_t conflictBudget) noexcept;
+
+  /**
+   * @brief Remaps cones until no cone improves, or MaxPasses passes.
+   *
+   */
+  void run ();
+
+  /**
+   * @brief Returns the number of lookup tables of the cover, including the
+   * ones that implement outputs driven by an input, GND or VDD.
+   *
+   * @return unsigned int
+   */
+  unsigned int getMappingAreaCost () const noexcept;
+
+  /**
+   * @brief Returns the number of lookup table levels of the cover.
+   *
+   * @return unsigned int
+   */
+  unsigned int getMappingDelayCost () const noexcept;
+
+  /**
+   * @brief Returns the number of cones solved, the number of cones whose
+   * cover was replaced and the number of cones that ran out of budget.
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumCones () const noexcept;
+  unsigned int getNumRemappedCones () const noexcept;
+  unsigned int getNumConesOverBudget () const noexcept;
+
+  /**
+   * @brief Returns a 64-bit hash of the cover (each lookup table and its
+   * inputs).
+   *
+   * @return std::uint64_t
+   */
+  std::uint64_t getFingerprint () const;
+
+  /**
+   * @brief Print the remapping results to a C++ output stream
+   *
+   * @param os A std::ostream object
+   */
+  void printResults (std::ostream &os) const;
+
+  /**
+   * @brief Writes the remapping results as the members of the current
+   * object of a JsonWriter.
+   *
+   * @param writer A JsonWriter object, inside an object
+   */
+  void writeReport (JsonWriter &writer) const;
+
+  /**
+   * @brief Print the lookup tables of the cover to a C++ output stream, each
+   * with its inputs and, up to TruthTable::MaxVariables inputs, its truth
+   * table
+   *
+   * @param os A std::ostream object
+   */
+  void printImplementation (std::ostream &os) const;
+
+private:
+  // Lookup tables of a cone, with the and-nodes they cover and the lookup
+  // tables that must be ready by their current level
+  struct Cone
+  {
+    unsigned int root;
+    std::vector<unsigned int> lutVector;
+    std::vector<unsigned int> nodeVector;
+    std::vector<unsigned int> requiredVector;
+  };
+
+  // New cover of a cone: the inputs of each lookup table
+  struct ConeCover
+  {
+    bool improved = false;
+    bool overBudget = false;
+    std::vector<std::pair<unsigned int, std::vector<unsigned int>>> lutVector
+        = {};
+  };
+
+  const AndInverterGraph &_aig;
+  unsigned int _k;
+  unsigned int _numThreads = 1;
+  std::uint64_t _conflictBudget = DefaultConflictBudget;
+  std::unique_ptr<WorkerPool> _workerPool = nullptr;
+  // Indexed by node variable
+  std::vector<bool> _isLutVector = {};
+  std::vector<std::vector<unsigned int>> _lutInputVector = {};
+  std::vector<unsigned int> _levelVector = {};
+  std::vector<unsigned int> _requiredLevelVector = {};
+  std::vector<std::vector<unsigned int>> _fanoutVector = {};
+  std::vector<bool> _drivesOutput = {};
+  std::vector<unsigned int> _topologicalOrder = {};
+  unsigned int _mappingAreaCost = 0;
+  unsigned int _mappingDelayCost = 0;
+  unsigned int _numCones = 0;
+  unsigned int _numRemappedCones = 0;
+  unsigned int _numConesOverBudget = 0;
+
+  /**
+   * @brief Removes the lookup tables no output depends on and evaluates the
+   * levels, required levels, fanouts and costs of the others.
+   *
+   */
+  void evaluateTiming ();
+
+  /**
+   * @brief Returns the and-nodes covered by the lookup table of @c lut: the
+   * ones reached from it without crossing another lookup table or an input.
+   * Returns an empty vector if there are more than MaxConeAnds.
+   *
+   * @param lut
+   * @return std::vector<unsigned int>
+   */
+  std::vector<unsigned int> coveredNodes (unsigned int lut) const;
+
+  /**
+   * @brief Builds the cone of a critical lookup table. Its lookup table
+   * vector is empty if the lookup table alone covers too many and-nodes.
+   *
+   * @param root
+   * @return Cone
+   */
+  Cone buildCone (unsigned int root) const;
+
+  /**
+   * @brief Finds the cover of minimum depth, then minimum area, of a cone.
+   *
+   * @param cone
+   * @return ConeCover
+   */
+  ConeCover solveCone (const Cone &cone) const;
+
+  /**
+   * @brief Replaces the lookup tables of a cone with a new cover, unless the
+   * cone has a node marked in @c touchedVector (the nodes and the inputs of
+   * the cones replaced before it in the pass) or an input of the cover is no
+   * longer a lookup table. Returns @c true if the cover was replaced.
+   *
+   * @param cone
+   * @param cover
+   * @param touchedVector
+   * @return boolean
+   */
+  bool applyCover (const Cone &cone, const ConeCover &cover,
+                   std::vector<bool> &touchedVector);
+
+  /**
+   * @brief Runs @c task on the threads of the remapper, passing the thread
+   * number.
+   *
+   * @param task
+   */
+  void runOnThreads (const std::function<void (unsigned int)> &task);
+};
+
+#endif
@@ -0,0 +1,224 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _FLOWMAPENGINE_H
+#define _FLOWMAPENGINE_H
+
+#include <vector>
+
+#include "AndInverterGraph.h"
+#include "Cut.h"
+#include "CutSet.h"
+#include "MappingEngine.h"
+
+/**
+ * @brief Depth-optimal mapping engine based on the FlowMap algorithm.
+ *
+ * Instead of enumerating all K-feasible cuts of a node, FlowMapEngine computes
+ * its label (the minimum number of lookup table levels needed to implement
+ * it) and a single K-feasible cut that achieves that label, by solving a
+ * max-flow/min-cut problem on the fanin cone of the node. Its runtime is
+ * polynomial in K, which makes it usable for large lookup tables.
+ *
+ * The flow of a node is reused by the next nodes labeled: the network of a
+ * node whose cone holds the last node with a K-feasible flow at the same
+ * height contains the network of that node, so its flow paths are a valid
+ * starting flow and only the remaining paths are searched.
+ *
+ */
+class FlowMapEngine : public MappingEngine
+{
+public:
+  // Label of the and-nodes that have not been labeled yet
+  static constexpr unsigned int NoLabel = -1;
+
+  FlowMapEngine () = delete;
+
+  /**
+   * @brief Construct a new FlowMapEngine object from an AndInverterGraph
+   * object.
+   *
+   * @param aig An AndInverterGraph object
+   * @param k Number of inputs of the lookup tables
+   */
+  FlowMapEngine (const AndInverterGraph &aig, unsigned int k = 6);
+
+  /**
+   * @brief Returns a read-only reference for the AndInverterGraph object used
+   * to initialize the FlowMapEngine.
+   *
+   * @return const AndInverterGraph&
+   */
+  const AndInverterGraph &getAndInverterGraph () const noexcept override;
+
+  /**
+   * @brief Returns the label of a node, i.e. the depth of the optimal lookup
+   * table implementation of the node. Inputs and latches have label zero.
+   * Throws an exception if @c nodeLiteral is an and-node that has not been
+   * labeled yet.
+   *
+   * @param nodeLiteral The literal of an input, latch or and-node
+   * @return unsigned int
+   */
+  unsigned int getLabel (unsigned int nodeLiteral) const;
+
+  /**
+   * @brief Boolean predicate that returns @c true if @c andLiteral has been
+   * labeled (and thus has its best cut defined). Returns @c false otherwise.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return boolean
+   */
+  bool hasBestCut (unsigned int andLiteral) const override;
+
+  /**
+   * @brief Returns a read-only reference for the CutSet of an and-node. The
+   * CutSet holds a single cut, the one found when labeling the node. If the
+   * node has not been labeled it returns a reference for an empty CutSet.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return const CutSet&
+   */
+  const CutSet &getCutSet (unsigned int andLiteral) const override;
+
+  /**
+   * @brief Returns a read-only reference for the cut found when labeling
+   * @c andLiteral. Its delay cost is the label of the node. Throws an
+   * exception if the node has not been labeled yet.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return const Cut&
+   */
+  const Cut &getBestCut (unsigned int andLiteral) const override;
+
+  /**
+   * @brief Labels @c andLiteral and all unlabeled and-nodes in its transitive
+   * fanin, in topological order. Returns the CutSet of @c andLiteral.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return const CutSet&
+   */
+  const CutSet &findCuts (const unsigned int &andLiteral) override;
+
+  /**
+   * @brief Labels all and-nodes that drive an output of the AndInverterGraph.
+   *
+   */
+  void run () override;
+
+  /**
+   * @brief Counts the and-nodes labeled by findCuts() in @c progress and
+   * checks it between nodes. When it is cancelled, the labels and cuts found
+   * are discarded and findCuts() throws MappingCancelled.
+   *
+   * @param progress A MappingProgress object, or @c nullptr
+   */
+  void setProgress (MappingProgress *progress) noexcept override;
+
+private:
+  const AndInverterGraph &_aig;
+  unsigned int _k = 6;
+  MappingProgress *_progress = nullptr;
+  std::vector<CutSet> _cutSetVector = {};
+
+  // Label of each variable index. Unlabeled and-nodes hold NoLabel
+  std::vector<unsigned int> _labelVector = {};
+
+  // Flow network of the node being labeled. These buffers are kept between
+  // nodes so that labeling does not allocate once they have grown to the size
+  // of the largest cone
+  std::vector<unsigned int> _coneVector = {};
+  std::vector<unsigned int> _coneStamp = {};
+  std::vector<unsigned int> _vertexOfVariable = {};
+  std::vector<int> _edgeHead = {};
+  std::vector<int> _edgeNext = {};
+  std::vector<unsigned int> _edgeTarget = {};
+  std::vector<unsigned int> _edgeCapacity = {};
+  std::vector<int> _parentEdge = {};
+  std::vector<unsigned int> _bfsQueue = {};
+  unsigned int _currentStamp = 0;
+
+  // Flow of the last node whose min-cut was K-feasible, as one path of
+  // variables per unit of flow (from a source to the last node before the
+  // sink), and the node and height it was computed for
+  std::vector<std::vector<unsigned int>> _flowPathVector = {};
+  unsigned int _flowVariable = 0;
+  unsigned int _flowHeight = NoLabel;
+
+  /**
+   * @brief Converts an and-literal into an index to access _cutSetVector.
+   * Throws @c std::overflow_error() if the index is equal or greater than the
+   * size of the vector.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return unsigned int
+   */
+  unsigned int vectorIndexFromAndLiteral (unsigned int andLiteral) const;
+
+  /**
+   * @brief If the run is cancelled (see setProgress()), discards the labels
+   * and cuts found and throws MappingCancelled.
+   *
+   */
+  void stopIfCancelled ();
+
+  /**
+   * @brief Computes the label and the cut of an and-node whose fanins are
+   * already labeled.
+   *
+   * Let p be the largest label among the fanins. If the fanins whose label is
+   * p can be merged with the node in a single lookup table, the node also
+   * gets label p; otherwise it gets label p + 1 and its fanins as cut. Two
+   * tests are done, from the cheapest to the most expensive:
+   * - the union of the cuts of the fanins with label p and of the other
+   * fanins is already K-feasible (no flow computation is needed);
+   * - the min-cut between the sources and the nodes with label p in the
+   * fanin cone has at most K nodes.
+   *
+   * @param andVariable The variable index of an and-node
+   */
+  void labelNode (unsigned int andVariable);
+
+  /**
+   * @brief Computes a node-capacitated min-cut between the sources of the
+   * fanin cone of @c andVariable and the and-nodes of the cone with label
+   * @c height, which are collapsed into the sink. The search starts from the
+   * last flow kept (see _flowPathVector) if its node is in the cone with
+   * label @c height, and stops as soon as the flow exceeds K. Returns
+   * @c true and fills @c cutVariables if a cut with at most K nodes exists;
+   * its flow is then kept for the next nodes.
+   *
+   * @param andVariable The variable index of the and-node being labeled
+   * @param height The largest label among the fanins of the node
+   * @param cutVariables Receives the variable indexes of the cut nodes
+   * @return boolean
+   */
+  bool findMinCut (unsigned int andVariable, unsigned int height,
+                   std::set<unsigned int> &cutVariables);
+
+  /**
+   * @brief Adds an edge and its residual edge to the flow network.
+   *
+   * @param from Source vertex
+   * @param to Target vertex
+   * @param capacity Capacity of the edge
+   */
+  void addFlowEdge (unsigned int from, unsigned int to, unsigned int capacity);
+
+  /**
+   * @brief Pushes one unit of flow along the edge from @c from to @c to.
+   *
+   * @param from Source vertex
+   * @param to Target vertex
+   */
+  void pushFlow (unsigned int from, unsigned int to);
+};
+
+#endif
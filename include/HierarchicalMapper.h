@@ -0,0 +1,268 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _HIERARCHICALMAPPER_H
+#define _HIERARCHICALMAPPER_H
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AndInverterGraph.h"
+#include "CutEngine.h"
+#include "DelayModel.h"
+
+/**
+ * @brief Maps a hierarchical design: modules given as AIGs and instances of
+ * them connected to each other, as listed in a manifest. Each module is
+ * mapped once with CutEngine and TechMapper, however many instances it has,
+ * and its cover is reused by every instance.
+ *
+ * The manifest has one statement per line (text after '#' is ignored).
+ * Module files are relative to the directory of the manifest, and ports are
+ * given by index or by symbol name:
+ *
+ * @code
+ * module <name> <file.aig|file.aag|file.blif>
+ * instance <name> <module>
+ * connect <instance>.<input> <instance>.<output>
+ * output <instance>.<output>
+ * @endcode
+ *
+ * Instance inputs that are not connected are primary inputs. Instance
+ * outputs that no input is connected to, or that an @c output statement
+ * lists, are primary outputs.
+ *
+ * With boundary remapping enabled, the lookup tables on both sides of a
+ * connection are mapped again across the boundary: a table that drives an
+ * output of its instance and feeds a single table of the instance it is
+ * connected to is merged into that table when their leaves fit in K
+ * inputs, and a table that only passes an input (or a constant) through to
+ * another instance becomes a wire.
+ *
+ */
+class HierarchicalMapper
+{
+public:
+  HierarchicalMapper () = delete;
+
+  /**
+   * @brief Construct a new HierarchicalMapper object from a manifest,
+   * loading the AIG of each module. Throws @c std::runtime_error() if the
+   * manifest or a module cannot be read, or if it refers to unknown modules,
+   * instances or ports.
+   *
+   * @param manifestPath
+   * @param mappingGoal
+   * @param k Number of inputs of the lookup tables
+   * @param c Number of cuts kept per node (0 keeps all)
+   */
+  HierarchicalMapper (const std::string &manifestPath,
+                      MappingGoal mappingGoal = MappingGoal::MinimizeArea,
+                      unsigned int k = 6, unsigned int c = 0);
+
+  /**
+   * @brief Enables or disables the remapping of the lookup tables at the
+   * instance boundaries (disabled by default).
+   *
+   * @param boundaryRemapping
+   */
+  void setBoundaryRemapping (bool boundaryRemapping) noexcept;
+
+  /**
+   * @brief Sets the number of threads used to map each module (see
+   * CutEngineBase::setNumThreads()).
+   *
+   * @param numThreads
+   */
+  void setNumThreads (unsigned int numThreads) noexcept;
+
+  /**
+   * @brief Enables or disables support reduction (see
+   * CutEngineBase::setSupportReduction()).
+   *
+   * @param supportReduction
+   */
+  void setSupportReduction (bool supportReduction) noexcept;
+
+  /**
+   * @brief Maps every module once and composes the covers of the instances.
+   * Throws @c std::runtime_error() if the connections of the instances form
+   * a loop.
+   *
+   */
+  void run ();
+
+  /**
+   * @brief Returns the number of lookup tables of the design. Only valid
+   * after run() has been called.
+   *
+   * @return unsigned int
+   */
+  unsigned int getMappingAreaCost () const noexcept;
+
+  /**
+   * @brief Returns the number of lookup table levels of the design, from
+   * primary inputs (and latches) to primary outputs. Only valid after run()
+   * has been called.
+   *
+   * @return unsigned int
+   */
+  unsigned int getMappingDelayCost () const noexcept;
+
+  /**
+   * @brief Returns the number of lookup tables removed by boundary
+   * remapping.
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumMergedLuts () const noexcept;
+
+  /**
+   * @brief Returns the number of modules.
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumModules () const noexcept;
+
+  /**
+   * @brief Returns the number of instances.
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumInstances () const noexcept;
+
+  /**
+   * @brief Returns a 64-bit hash of the design: the fingerprint of the cover
+   * of each module (see TechMapperBase::getFingerprint()), the instances and
+   * the lookup tables merged at their boundaries.
+   *
+   * @return std::uint64_t
+   */
+  std::uint64_t getFingerprint () const;
+
+  /**
+   * @brief Print the mapping results to a C++ output stream
+   *
+   * @param os A std::ostream object
+   */
+  void printResults (std::ostream &os) const;
+
+private:
+  // Lookup table of a module cover driving a module output
+  struct OutputCover
+  {
+    // The output is driven by an and-node, by an input or a constant (a
+    // lookup table that passes it through), or by a latch (no table)
+    enum class Driver
+    {
+      AndNode,
+      PassThrough,
+      Latch
+    };
+    Driver driver = Driver::Latch;
+    unsigned int numLeaves = 0;
+    // Levels from each input (-1 if the output does not depend on it) and
+    // from the latches and constants
+    std::vector<int> inputDepthVector = {};
+    int sourceDepth = 0;
+    // The table also feeds tables of the module, or drives other outputs
+    bool isShared = false;
+  };
+
+  // Lookup tables of a module cover fed by a module input
+  struct InputCover
+  {
+    unsigned int numConsumers = 0;
+    // Leaves of the consumer and its key (its and-literal, or the number of
+    // and-nodes plus the output index for a pass-through table), if there is
+    // a single one
+    unsigned int consumerNumLeaves = 0;
+    unsigned int consumerKey = 0;
+  };
+
+  struct Module
+  {
+    std::string name;
+    std::unique_ptr<AndInverterGraph> aig;
+    unsigned int numLuts = 0;
+    std::uint64_t fingerprint = 0;
+    std::vector<OutputCover> outputVector = {};
+    std::vector<InputCover> inputVector = {};
+  };
+
+  // An output port of an instance
+  struct PortReference
+  {
+    unsigned int instance;
+    unsigned int port;
+  };
+  static constexpr unsigned int Unconnected = -1;
+
+  struct Instance
+  {
+    std::string name;
+    unsigned int module;
+    // Driver of each input (instance Unconnected for primary inputs)
+    std::vector<PortReference> inputDriverVector = {};
+    std::vector<bool> primaryOutputVector = {};
+  };
+
+  std::string _manifestPath = "";
+  MappingGoal _mappingGoal = MappingGoal::MinimizeArea;
+  unsigned int _k = 6;
+  unsigned int _c = 0;
+  unsigned int _numThreads = 1;
+  bool _supportReduction = true;
+  bool _boundaryRemapping = false;
+  std::vector<Module> _moduleVector = {};
+  std::vector<Instance> _instanceVector = {};
+  std::vector<std::pair<PortReference, PortReference>> _mergedVector = {};
+  unsigned int _mappingAreaCost = 0;
+  unsigned int _mappingDelayCost = 0;
+
+  /**
+   * @brief Reads the manifest and loads the modules.
+   *
+   */
+  void parseManifest ();
+
+  /**
+   * @brief Resolves a port given by index or by symbol name. Throws
+   * @c std::runtime_error() if the module has no such port.
+   *
+   * @param module
+   * @param port
+   * @param isInput
+   * @return unsigned int
+   */
+  unsigned int findPort (const Module &module, const std::string &port,
+                         bool isInput) const;
+
+  /**
+   * @brief Maps a module and summarizes its cover: its lookup tables, the
+   * tables at its inputs and outputs and the levels between them.
+   *
+   * @param module
+   */
+  void mapModule (Module &module);
+
+  /**
+   * @brief Returns the instances in topological order of their connections.
+   * Throws @c std::runtime_error() on a loop.
+   *
+   * @return std::vector<unsigned int>
+   */
+  std::vector<unsigned int> sortInstances () const;
+};
+
+#endif
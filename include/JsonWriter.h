@@ -0,0 +1,121 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _JSONWRITER_H
+#define _JSONWRITER_H
+
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Writes a JSON document to a C++ output stream as it is built, one
+ * token at a time, so that reports of very wide designs are never held in
+ * memory as a whole.
+ *
+ * Objects and arrays are opened and closed explicitly, and every value in
+ * an object is preceded by its key. Separators are inserted by the writer.
+ * Breaking these rules throws @c std::runtime_error().
+ *
+ */
+class JsonWriter
+{
+public:
+  JsonWriter () = delete;
+
+  /**
+   * @brief Construct a new JsonWriter object that writes to @c os.
+   *
+   * @param os A std::ostream object
+   */
+  explicit JsonWriter (std::ostream &os);
+
+  JsonWriter &beginObject ();
+  JsonWriter &endObject ();
+  JsonWriter &beginArray ();
+  JsonWriter &endArray ();
+
+  /**
+   * @brief Writes the key of the next value of the current object.
+   *
+   * @param name
+   * @return JsonWriter&
+   */
+  JsonWriter &key (std::string_view name);
+
+  /**
+   * @brief Writes a value: a string (escaped), a number or a boolean.
+   * Non-finite doubles are written as @c null.
+   *
+   * @return JsonWriter&
+   */
+  JsonWriter &value (std::string_view string);
+  JsonWriter &value (const char *string);
+  JsonWriter &value (bool boolean);
+  JsonWriter &value (int number);
+  JsonWriter &value (unsigned int number);
+  JsonWriter &value (std::uint64_t number);
+  JsonWriter &value (double number);
+
+  /**
+   * @brief Writes @c null.
+   *
+   * @return JsonWriter&
+   */
+  JsonWriter &null ();
+
+  /**
+   * @brief Returns @c true when a whole document has been written (every
+   * object and array is closed).
+   *
+   * @return boolean
+   */
+  bool isComplete () const noexcept;
+
+private:
+  enum class Scope
+  {
+    Object,
+    Array
+  };
+
+  std::ostream &_os;
+  std::vector<Scope> _scopeStack = {};
+  // No value written yet in the current object or array
+  bool _isFirst = true;
+  // A key has been written and waits for its value
+  bool _hasKey = false;
+  bool _isComplete = false;
+
+  /**
+   * @brief Checks that a value may be written here and writes the separator
+   * that goes before it.
+   *
+   */
+  void beginValue ();
+
+  /**
+   * @brief Closes the current object or array, which must be of @c scope.
+   *
+   * @param scope
+   * @param closingCharacter
+   */
+  void endScope (Scope scope, char closingCharacter);
+
+  /**
+   * @brief Writes a string between quotes, escaping it.
+   *
+   * @param string
+   */
+  void writeString (std::string_view string);
+};
+
+#endif
@@ -0,0 +1,250 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _LUTNETWORK_H
+#define _LUTNETWORK_H
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "AndInverterGraph.h"
+#include "CutEngine.h"
+#include "JsonWriter.h"
+#include "MappingEngine.h"
+#include "TechMapper.h"
+#include "TruthTable.h"
+
+/**
+ * @brief The lookup tables of a cover, with their functions as truth tables,
+ * and the moves that resynthesize them after the cover has been selected.
+ *
+ * Each pass evaluates the levels and the slack of every lookup table and
+ * then tries two kinds of moves:
+ *
+ * - collapse: a lookup table whose fanouts can all absorb it within @c k
+ *   inputs is merged into them and removed (one lookup table less). A
+ *   critical lookup table is also merged into a single fanout when it is the
+ *   only critical input of that fanout, which shortens the path at no area
+ *   cost;
+ * - decomposition: when a critical input does not fit, the fanout is split
+ *   along an Ashenhurst decomposition @c f = g(h(B), F), where the bound set
+ *   @c B holds inputs that arrive early. The new lookup table @c h makes
+ *   room for the critical input, which is then collapsed. Decompositions
+ *   that add a lookup table are only made when minimizing delay.
+ *
+ * No move makes a lookup table arrive later, so the number of levels never
+ * grows. Passes are repeated until no move applies.
+ *
+ */
+class LutNetwork
+{
+public:
+  LutNetwork () = delete;
+
+  /**
+   * @brief Construct a new LutNetwork object from the cover of a TechMapper,
+   * computing the function of each lookup table from the and-nodes of its
+   * cone. Throws @c std::runtime_error() if @c k is larger than
+   * TruthTable::MaxVariables.
+   *
+   * @param mappingEngine The engine the cover was built from
+   * @param techMapper A TechMapper object, after run() has been called
+   * @param mappingGoal
+   * @param k Number of inputs of the lookup tables
+   */
+  LutNetwork (const MappingEngine &mappingEngine,
+              const TechMapper &techMapper,
+              MappingGoal mappingGoal = MappingGoal::MinimizeArea,
+              unsigned int k = 6);
+
+  /**
+   * @brief Runs collapse and decomposition passes until no move applies.
+   *
+   */
+  void run ();
+
+  /**
+   * @brief Returns the number of lookup tables of the network, including the
+   * ones that implement outputs driven by an input, GND or VDD.
+   *
+   * @return unsigned int
+   */
+  unsigned int getMappingAreaCost () const noexcept;
+
+  /**
+   * @brief Returns the number of lookup table levels of the network.
+   *
+   * @return unsigned int
+   */
+  unsigned int getMappingDelayCost () const noexcept;
+
+  /**
+   * @brief Returns the number of collapse moves made by run().
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumCollapses () const noexcept;
+
+  /**
+   * @brief Returns the number of decomposition moves made by run().
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumDecompositions () const noexcept;
+
+  /**
+   * @brief Returns a 64-bit hash of the network: every lookup table, its
+   * inputs and its truth table, in node order.
+   *
+   * @return std::uint64_t
+   */
+  std::uint64_t getFingerprint () const;
+
+  /**
+   * @brief Print the resynthesis results to a C++ output stream
+   *
+   * @param os A std::ostream object
+   */
+  void printResults (std::ostream &os) const;
+
+  /**
+   * @brief Writes the resynthesis results as the members of the current
+   * object of a JsonWriter.
+   *
+   * @param writer A JsonWriter object, inside an object
+   */
+  void writeReport (JsonWriter &writer) const;
+
+  /**
+   * @brief Prints each lookup table with its inputs and its truth table.
+   * Lookup tables created by decompositions are numbered after the nodes of
+   * the AndInverterGraph.
+   *
+   * @param os A std::ostream object
+   */
+  void printImplementation (std::ostream &os) const;
+
+  /**
+   * @brief Returns the function of an and-node over the leaves of its cone,
+   * by simulating the and-nodes between them. Variable i of the truth table
+   * is @c leafVector[i]. Throws @c std::runtime_error() if the leaves do not
+   * separate the node from the inputs.
+   *
+   * @param aig An AndInverterGraph object
+   * @param rootVariable The variable index of an and-node
+   * @param leafVector Variable indexes of the leaves, at most
+   * TruthTable::MaxVariables
+   * @return TruthTable
+   */
+  static TruthTable coneFunction (const AndInverterGraph &aig,
+                                  unsigned int rootVariable,
+                                  const std::vector<unsigned int> &leafVector);
+
+private:
+  // Node ids are the variable indexes of the AndInverterGraph, followed by
+  // the lookup tables created by decompositions
+  struct Lut
+  {
+    // Input node ids, in increasing order; input i is variable i of the
+    // truth table
+    std::vector<unsigned int> inputVector = {};
+    TruthTable function = {};
+  };
+
+  static constexpr unsigned int MaxPasses = 16;
+
+  const AndInverterGraph &_aig;
+  MappingGoal _mappingGoal = MappingGoal::MinimizeArea;
+  unsigned int _k = 6;
+  // Lookup table of each node id; nodes that are not lookup tables (inputs,
+  // GND, dead nodes) have an empty truth table
+  std::vector<Lut> _lutVector = {};
+  // Timing of the last call to evaluateTiming(), indexed by node id
+  std::vector<unsigned int> _levelVector = {};
+  std::vector<unsigned int> _requiredVector = {};
+  std::vector<std::vector<unsigned int>> _fanoutVector = {};
+  std::vector<bool> _drivesOutput = {};
+  // Live lookup tables, inputs first
+  std::vector<unsigned int> _topologicalOrder = {};
+  unsigned int _mappingAreaCost = 0;
+  unsigned int _mappingDelayCost = 0;
+  unsigned int _numCollapses = 0;
+  unsigned int _numDecompositions = 0;
+
+  /**
+   * @brief Returns @c true if a node id is a lookup table.
+   *
+   * @param node
+   * @return boolean
+   */
+  bool isLut (unsigned int node) const noexcept;
+
+  /**
+   * @brief Drops the lookup tables that no longer reach an output and
+   * computes the level, required level and fanouts of every lookup table,
+   * as well as the area and delay costs.
+   *
+   */
+  void evaluateTiming ();
+
+  /**
+   * @brief Returns the inputs of @c lut with @c fanin replaced by the inputs
+   * of @c fanin, in increasing order.
+   *
+   * @param lut
+   * @param fanin An input of @c lut that is a lookup table
+   * @return std::vector<unsigned int>
+   */
+  std::vector<unsigned int> mergedInputs (unsigned int lut,
+                                          unsigned int fanin) const;
+
+  /**
+   * @brief Replaces the input @c fanin of @c lut by the function of
+   * @c fanin, and removes the inputs the result does not depend on.
+   *
+   * @param lut
+   * @param fanin
+   */
+  void collapse (unsigned int lut, unsigned int fanin);
+
+  /**
+   * @brief Tries to split @c lut into @c g(h(B), F), where the bound set
+   * @c B is a subset of @c boundCandidates of at least @c minBoundInputs
+   * inputs (and at least two). The candidates are tried all together first,
+   * then leaving one out. On success @c h becomes a new lookup table, @c lut
+   * becomes @c g, and the node id of @c h is returned; otherwise nothing
+   * changes and 0 is returned.
+   *
+   * @param lut
+   * @param boundCandidates Inputs of @c lut that may be in the bound set
+   * @param minBoundInputs
+   * @return unsigned int
+   */
+  unsigned int decompose (unsigned int lut,
+                          const std::vector<unsigned int> &boundCandidates,
+                          unsigned int minBoundInputs);
+
+  /**
+   * @brief Removes the inputs a lookup table does not depend on.
+   *
+   * @param lut
+   */
+  void removeVacuousInputs (unsigned int lut);
+
+  /**
+   * @brief Runs one pass of moves. Returns @c true if any move was made.
+   *
+   * @return boolean
+   */
+  bool runPass ();
+};
+
+#endif
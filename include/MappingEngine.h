@@ -0,0 +1,155 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _MAPPINGENGINE_H
+#define _MAPPINGENGINE_H
+
+#include <vector>
+
+#include "AndInverterGraph.h"
+#include "Cut.h"
+#include "CutSet.h"
+#include "DelayModel.h"
+#include "MappingProgress.h"
+
+/**
+ * @brief Interface between TechMapper and the engines that choose a cut for
+ * each and-node of an AndInverterGraph (CutEngine, FlowMapEngine, ...).
+ *
+ */
+class MappingEngine
+{
+public:
+  virtual ~MappingEngine () = default;
+
+  /**
+   * @brief Returns a read-only reference for the AndInverterGraph object
+   * mapped by the engine.
+   *
+   * @return const AndInverterGraph&
+   */
+  virtual const AndInverterGraph &getAndInverterGraph () const noexcept = 0;
+
+  /**
+   * @brief Boolean predicate that returns @c true if the best cut has been
+   * found for @c andLiteral. Returns @c false otherwise.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return boolean
+   */
+  virtual bool hasBestCut (unsigned int andLiteral) const = 0;
+
+  /**
+   * @brief Returns a read-only reference for the CutSet of an and-node. If the
+   * CutSet has not been evaluated it returns a reference for an empty CutSet.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return const CutSet&
+   */
+  virtual const CutSet &getCutSet (unsigned int andLiteral) const = 0;
+
+  /**
+   * @brief Returns a read-only reference for the best Cut of an and-node.
+   * Throws an exception if the best Cut of @c andLiteral has not been defined
+   * yet.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return const Cut&
+   */
+  virtual const Cut &getBestCut (unsigned int andLiteral) const = 0;
+
+  /**
+   * @brief Returns a read-only reference for the cut that implements an
+   * and-node in the cover. By default it is the best cut; engines may refine
+   * it after choosing it (e.g. CutEngine removes the leaves the function of
+   * the cut does not depend on).
+   *
+   * @param andLiteral The literal of an and-node
+   * @return const Cut&
+   */
+  virtual const Cut &
+  getSelectedCut (unsigned int andLiteral) const
+  {
+    return getBestCut (andLiteral);
+  }
+
+  /**
+   * @brief Returns the delay model the engine uses to evaluate the delay cost
+   * of cuts. By default it is the unit delay model.
+   *
+   * @return DelayModel
+   */
+  virtual DelayModel
+  getDelayModel () const noexcept
+  {
+    return DelayModel ();
+  }
+
+  /**
+   * @brief Returns the fanout estimates the cuts of the engine were found
+   * with, indexed by variable index, or an empty vector if the engine does
+   * not use them (the default).
+   *
+   * @return std::vector<unsigned int>
+   */
+  virtual std::vector<unsigned int>
+  getFanoutEstimates () const
+  {
+    return {};
+  }
+
+  /**
+   * @brief Gives the engine the fanout of every variable index in the cover
+   * built from its cuts, to be used as fanout estimates in the next pass.
+   * Engines whose delay costs depend on fanout discard their cuts and return
+   * @c true, so that the cover is built again; the others ignore the
+   * estimates and return @c false (the default).
+   *
+   * @param fanoutVector Fanout in the cover, indexed by variable index
+   * @return boolean
+   */
+  virtual bool
+  updateFanoutEstimates (const std::vector<unsigned int> &)
+  {
+    return false;
+  }
+
+  /**
+   * @brief Gives the engine a MappingProgress object (or @c nullptr), not
+   * owned, in which run() counts the and-nodes it enumerates. Engines that
+   * support cancellation also check it between nodes: once it is cancelled
+   * they discard the cuts found and throw MappingCancelled. The others
+   * ignore it (the default), and can only be cancelled between runs.
+   *
+   * @param progress
+   */
+  virtual void
+  setProgress (MappingProgress *) noexcept
+  {
+  }
+
+  /**
+   * @brief Finds the cuts of @c andLiteral and of every and-node in its
+   * transitive fanin, returning the CutSet of @c andLiteral.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return const CutSet&
+   */
+  virtual const CutSet &findCuts (const unsigned int &andLiteral) = 0;
+
+  /**
+   * @brief Finds cuts for all and-nodes that drive an output of the
+   * AndInverterGraph.
+   *
+   */
+  virtual void run () = 0;
+};
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _MAPPINGJOB_H
+#define _MAPPINGJOB_H
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+#include "MappingEngine.h"
+#include "MappingProgress.h"
+#include "TechMapper.h"
+
+/**
+ * @brief Runs a mapping (the engine, then the cover) on a thread of its own,
+ * for programs that embed the mapper and must not block on it.
+ *
+ * start() returns a future that becomes ready when the mapping is done, and
+ * the job itself is the handle of the run: it reports the phase and the
+ * number of and-nodes enumerated, and cancel() (or the deadline) stops the
+ * run between two and-nodes. A cancelled engine discards the cuts it found
+ * and the future throws MappingCancelled. Engines that do not support
+ * cancellation (see MappingEngine::setProgress()) are only stopped between
+ * the phases.
+ *
+ * The engine and the TechMapper are not owned, must outlive the job, and
+ * must not be used until the future is ready. After a cancellation the
+ * results of the TechMapper are not valid.
+ *
+ */
+class MappingJob
+{
+public:
+  enum class Phase
+  {
+    NotStarted,
+    Enumeration,
+    Cover,
+    Done,
+    Cancelled,
+    Failed
+  };
+
+  MappingJob () = delete;
+  MappingJob (const MappingJob &) = delete;
+  MappingJob &operator= (const MappingJob &) = delete;
+
+  /**
+   * @brief Construct a new MappingJob object for an engine and the
+   * TechMapper built on it.
+   *
+   * @param mappingEngine
+   * @param techMapper A TechMapper object constructed from @c mappingEngine
+   */
+  MappingJob (MappingEngine &mappingEngine, TechMapper &techMapper);
+
+  /**
+   * @brief Cancels the run if it is not done and waits for its thread.
+   *
+   */
+  ~MappingJob ();
+
+  /**
+   * @brief Sets a time after which the run is cancelled. May be called
+   * before or after start().
+   *
+   * @param deadline
+   */
+  void setDeadline (MappingProgress::Clock::time_point deadline) noexcept;
+
+  /**
+   * @brief Starts the run on a new thread and returns its future. Throws
+   * @c std::runtime_error() if the job was already started.
+   *
+   * @return std::shared_future<void>
+   */
+  std::shared_future<void> start ();
+
+  /**
+   * @brief Asks the run to stop. Returns immediately; the future becomes
+   * ready once the engine has stopped and cleaned up.
+   *
+   */
+  void cancel () noexcept;
+
+  /**
+   * @brief Returns the phase of the run.
+   *
+   * @return Phase
+   */
+  Phase getPhase () const noexcept;
+
+  /**
+   * @brief Returns the progress of the run: the and-nodes to enumerate and
+   * the ones done, over every pass of the engine.
+   *
+   * @return const MappingProgress&
+   */
+  const MappingProgress &getProgress () const noexcept;
+
+  /**
+   * @brief Returns the time spent enumerating cuts, in seconds. Only valid
+   * once the future is ready.
+   *
+   * @return double
+   */
+  double getEnumerationSeconds () const noexcept;
+
+  /**
+   * @brief Returns the time spent building the cover, in seconds. Only valid
+   * once the future is ready.
+   *
+   * @return double
+   */
+  double getCoverSeconds () const noexcept;
+
+private:
+  MappingEngine &_mappingEngine;
+  TechMapper &_techMapper;
+  MappingProgress _progress = {};
+  std::atomic<Phase> _phase = Phase::NotStarted;
+  std::promise<void> _promise = {};
+  std::shared_future<void> _future = {};
+  std::thread _thread = {};
+  // Written by the thread of the job before the future is made ready
+  double _enumerationSeconds = 0;
+  double _coverSeconds = 0;
+
+  /**
+   * @brief Body of the thread of the job: runs the engine and the
+   * TechMapper and makes the future ready with the outcome.
+   *
+   */
+  void runJob ();
+
+  /**
+   * @brief Throws MappingCancelled if the run is cancelled.
+   *
+   */
+  void stopIfCancelled () const;
+};
+
+#endif
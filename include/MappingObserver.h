@@ -0,0 +1,218 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _MAPPINGOBSERVER_H
+#define _MAPPINGOBSERVER_H
+
+#include <cstddef>
+
+#include "Cut.h"
+#include "CutSet.h"
+
+/**
+ * @brief Interface for objects that receive the events of a mapping (e.g.
+ * profilers). Every callback does nothing by default, so observers only
+ * override the events they need.
+ *
+ */
+class MappingObserver
+{
+public:
+  virtual ~MappingObserver () = default;
+
+  /**
+   * @brief Called before the cuts of an and-node are enumerated.
+   *
+   * @param andLiteral The literal of the and-node
+   */
+  virtual void
+  onNodeEnumerationStart (unsigned int)
+  {
+  }
+
+  /**
+   * @brief Called after the Diamond operation of an and-node, with the number
+   * of K-feasible cuts it produced.
+   *
+   * @param andLiteral The literal of the and-node
+   * @param numCuts Number of cuts in the Diamond product
+   */
+  virtual void
+  onDiamondProduct (unsigned int, std::size_t)
+  {
+  }
+
+  /**
+   * @brief Called when cuts of an and-node are discarded to keep only the
+   * best ones.
+   *
+   * @param andLiteral The literal of the and-node
+   * @param numPrunedCuts Number of cuts discarded
+   */
+  virtual void
+  onCutsPruned (unsigned int, std::size_t)
+  {
+  }
+
+  /**
+   * @brief Called after the cuts of an and-node are enumerated and stored.
+   *
+   * @param andLiteral The literal of the and-node
+   * @param cutSet The cuts kept for the and-node
+   */
+  virtual void
+  onNodeEnumerationEnd (unsigned int, const CutSet &)
+  {
+  }
+
+  /**
+   * @brief Called when the cut that implements an and-node is chosen.
+   *
+   * @param andLiteral The literal of the and-node
+   * @param cut The selected cut
+   */
+  virtual void
+  onCutSelected (unsigned int, const Cut &)
+  {
+  }
+
+  /**
+   * @brief Called when the cover of a mapping is done.
+   *
+   * @param numLuts Number of lookup tables of the cover
+   * @param numLevels Number of lookup table levels of the cover
+   * @param estimatedDelay Delay of the critical path of the cover
+   */
+  virtual void
+  onCoverFinalized (unsigned int, unsigned int, unsigned int)
+  {
+  }
+};
+
+/**
+ * @brief Observer policy of mapping classes without observers. All its
+ * methods are empty and inlined, so notifications compile to nothing.
+ *
+ */
+struct NullObserverPolicy
+{
+  void
+  notifyNodeEnumerationStart (unsigned int) const noexcept
+  {
+  }
+
+  void
+  notifyDiamondProduct (unsigned int, std::size_t) const noexcept
+  {
+  }
+
+  void
+  notifyCutsPruned (unsigned int, std::size_t) const noexcept
+  {
+  }
+
+  void
+  notifyNodeEnumerationEnd (unsigned int, const CutSet &) const noexcept
+  {
+  }
+
+  void
+  notifyCutSelected (unsigned int, const Cut &) const noexcept
+  {
+  }
+
+  void
+  notifyCoverFinalized (unsigned int, unsigned int,
+                        unsigned int) const noexcept
+  {
+  }
+};
+
+/**
+ * @brief Observer policy that forwards notifications to a MappingObserver
+ * registered at run time with setObserver(). Notifications are ignored while
+ * no observer is registered.
+ *
+ */
+class DynamicObserverPolicy
+{
+public:
+  /**
+   * @brief Registers the observer that receives notifications (@c nullptr
+   * unregisters it). The observer is not owned and must outlive the mapping.
+   *
+   * @param observer
+   */
+  void
+  setObserver (MappingObserver *observer) noexcept
+  {
+    _observer = observer;
+  }
+
+  /**
+   * @brief Returns the registered observer, or @c nullptr.
+   *
+   * @return MappingObserver*
+   */
+  MappingObserver *
+  getObserver () const noexcept
+  {
+    return _observer;
+  }
+
+  void
+  notifyNodeEnumerationStart (unsigned int andLiteral) const
+  {
+    if (_observer)
+      _observer->onNodeEnumerationStart (andLiteral);
+  }
+
+  void
+  notifyDiamondProduct (unsigned int andLiteral, std::size_t numCuts) const
+  {
+    if (_observer)
+      _observer->onDiamondProduct (andLiteral, numCuts);
+  }
+
+  void
+  notifyCutsPruned (unsigned int andLiteral, std::size_t numPrunedCuts) const
+  {
+    if (_observer)
+      _observer->onCutsPruned (andLiteral, numPrunedCuts);
+  }
+
+  void
+  notifyNodeEnumerationEnd (unsigned int andLiteral,
+                            const CutSet &cutSet) const
+  {
+    if (_observer)
+      _observer->onNodeEnumerationEnd (andLiteral, cutSet);
+  }
+
+  void
+  notifyCutSelected (unsigned int andLiteral, const Cut &cut) const
+  {
+    if (_observer)
+      _observer->onCutSelected (andLiteral, cut);
+  }
+
+  void
+  notifyCoverFinalized (unsigned int numLuts, unsigned int numLevels,
+                        unsigned int estimatedDelay) const
+  {
+    if (_observer)
+      _observer->onCoverFinalized (numLuts, numLevels, estimatedDelay);
+  }
+
+private:
+  MappingObserver *_observer = nullptr;
+};
+
+#endif
@@ -0,0 +1,233 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _MAPPINGPROFILER_H
+#define _MAPPINGPROFILER_H
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "AndInverterGraph.h"
+#include "CutEngine.h"
+#include "JsonWriter.h"
+
+/**
+ * @brief Fast profiling pass that predicts the enumeration time and the cut
+ * set memory of the cuts engine for several values of c, and chooses the
+ * largest c that fits a time and memory budget.
+ *
+ * The profile has two parts:
+ *
+ * - the shape of the graph: histograms of the levels and the fanouts of the
+ *   and-nodes, and the fraction of sampled and-nodes whose children share a
+ *   node a few levels below (reconvergence);
+ * - sampled enumeration: the fanin cones of and-nodes spread over the graph
+ *   are cut at a bounded depth and size and gathered into a small graph,
+ *   whose cuts are enumerated for each candidate c. Only the nodes close to
+ *   the roots of the cones are measured, since their cuts come from deep
+ *   enough cones to be those of the whole graph. Their average time and
+ *   memory per node, times the number of and-nodes, is the prediction.
+ *
+ * Predictions are for one enumeration pass with one thread. Candidates are
+ * profiled in increasing order of c and profiling stops at the first one
+ * that exceeds the budget.
+ *
+ */
+class MappingProfiler
+{
+public:
+  // Values of c that are profiled, in increasing order
+  static constexpr unsigned int CandidateCs[] = { 4, 8, 12, 16, 24, 32 };
+
+  /**
+   * @brief Predicted cost of the cuts engine with one value of c.
+   *
+   */
+  struct Prediction
+  {
+    unsigned int c;
+    double enumerationSeconds;
+    std::uint64_t cutSetBytes;
+    double cutsPerNode;
+  };
+
+  MappingProfiler () = delete;
+  MappingProfiler (const MappingProfiler &) = delete;
+  MappingProfiler &operator= (const MappingProfiler &) = delete;
+
+  /**
+   * @brief Construct a new MappingProfiler object for the cuts engine.
+   *
+   * @param aig The AndInverterGraph to be mapped
+   * @param mappingGoal
+   * @param k Number of inputs of the lookup tables
+   */
+  MappingProfiler (const AndInverterGraph &aig,
+                   MappingGoal mappingGoal = MappingGoal::MinimizeArea,
+                   unsigned int k = 6);
+
+  /**
+   * @brief Sets the enumeration time, in seconds, that the chosen c must
+   * not exceed (no limit by default).
+   *
+   * @param seconds
+   */
+  void setTimeBudget (double seconds) noexcept;
+
+  /**
+   * @brief Sets the cut set memory, in bytes, that the chosen c must not
+   * exceed (no limit by default).
+   *
+   * @param bytes
+   */
+  void setMemoryBudget (std::uint64_t bytes) noexcept;
+
+  /**
+   * @brief Profiles the graph, predicts the cost of the candidates and
+   * chooses c.
+   *
+   */
+  void run ();
+
+  /**
+   * @brief Returns the number of and-nodes per level, from level 1.
+   *
+   * @return const std::vector<unsigned int>&
+   */
+  const std::vector<unsigned int> &getLevelHistogram () const noexcept;
+
+  /**
+   * @brief Returns the number of and-nodes per fanout bucket: bucket 0
+   * counts fanout 0, and bucket @c b > 0 counts fanouts from @c 2^(b-1) to
+   * @c 2^b - 1.
+   *
+   * @return const std::vector<unsigned int>&
+   */
+  const std::vector<unsigned int> &getFanoutHistogram () const noexcept;
+
+  /**
+   * @brief Returns the fraction of the sampled and-nodes whose children
+   * share a node at most ReconvergenceDepth levels below them.
+   *
+   * @return double
+   */
+  double getReconvergenceRatio () const noexcept;
+
+  /**
+   * @brief Returns the predictions of the candidates profiled, in
+   * increasing order of c.
+   *
+   * @return const std::vector<Prediction>&
+   */
+  const std::vector<Prediction> &getPredictionVector () const noexcept;
+
+  /**
+   * @brief Returns the chosen c: the largest candidate whose prediction
+   * fits the budget, or the smallest candidate if none does.
+   *
+   * @return unsigned int
+   */
+  unsigned int getSelectedC () const noexcept;
+
+  /**
+   * @brief Returns @c true if the prediction of the chosen c fits the
+   * budget.
+   *
+   * @return boolean
+   */
+  bool fitsBudget () const noexcept;
+
+  /**
+   * @brief Print the profile and the predictions to a C++ output stream
+   *
+   * @param os A std::ostream object
+   */
+  void printResults (std::ostream &os) const;
+
+  /**
+   * @brief Writes the profile and the predictions as the members of the
+   * current object of a JsonWriter.
+   *
+   * @param writer A JsonWriter object, inside an object
+   */
+  void writeReport (JsonWriter &writer) const;
+
+private:
+  // Number of and-nodes whose fanin cones are sampled
+  static constexpr unsigned int NumSampleRoots = 32;
+  // Bounds of a sampled cone, in levels below its root and in and-nodes
+  static constexpr unsigned int MaxConeDepth = 12;
+  static constexpr unsigned int MaxConeNodes = 48;
+  // Levels below the root of a cone whose nodes are measured
+  static constexpr unsigned int MeasuredDepth = 2;
+  // Levels below a sampled node searched for reconvergence
+  static constexpr unsigned int ReconvergenceDepth = 4;
+  // Approximate size of a node of the std::set of leaves of a cut
+  static constexpr std::uint64_t LeafBytes = 40;
+
+  const AndInverterGraph &_aig;
+  MappingGoal _mappingGoal;
+  unsigned int _k;
+  double _timeBudget = std::numeric_limits<double>::infinity ();
+  std::uint64_t _memoryBudget = std::numeric_limits<std::uint64_t>::max ();
+  std::vector<unsigned int> _levelHistogram = {};
+  std::vector<unsigned int> _fanoutHistogram = {};
+  std::vector<unsigned int> _sampleRootVector = {};
+  double _reconvergenceRatio = 0;
+  unsigned int _numSampleAnds = 0;
+  unsigned int _numMeasuredAnds = 0;
+  std::vector<Prediction> _predictionVector = {};
+  unsigned int _selectedC = CandidateCs[0];
+  bool _fitsBudget = false;
+
+  /**
+   * @brief Computes the level and fanout histograms and chooses the sampled
+   * and-nodes.
+   *
+   */
+  void profileShape ();
+
+  /**
+   * @brief Computes the fraction of sampled and-nodes with reconvergent
+   * children.
+   *
+   */
+  void sampleReconvergence ();
+
+  /**
+   * @brief Adds the and-nodes at most @c depth levels below @c literal (or
+   * the inputs and latches reached) to @c variables.
+   *
+   * @param literal
+   * @param depth
+   * @param variables
+   */
+  void collectFanin (unsigned int literal, unsigned int depth,
+                     std::vector<unsigned int> &variables) const;
+
+  /**
+   * @brief Builds the graph of the sampled cones and enumerates its cuts
+   * with each candidate c until one exceeds the budget.
+   *
+   */
+  void predictCandidates ();
+
+  /**
+   * @brief Returns @c true if a prediction fits the time and memory budget.
+   *
+   * @param prediction
+   * @return boolean
+   */
+  bool fits (const Prediction &prediction) const noexcept;
+};
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _MAPPINGPROGRESS_H
+#define _MAPPINGPROGRESS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Thrown by a mapping run that stops because it was cancelled or its
+ * deadline passed. The engine has discarded its partial state by then.
+ *
+ */
+class MappingCancelled : public std::runtime_error
+{
+public:
+  explicit MappingCancelled (const std::string &what)
+      : std::runtime_error (what)
+  {
+  }
+};
+
+/**
+ * @brief Progress and cancellation of a mapping run, shared between the
+ * threads that map and the threads that watch them. Every method may be
+ * called from any thread.
+ *
+ * Engines add the number of and-nodes they are about to enumerate, count
+ * them as they are done, and check isCancelled() between nodes.
+ *
+ */
+class MappingProgress
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Asks the run to stop. It stops at the next check, between two
+   * and-nodes.
+   *
+   */
+  void requestCancellation () noexcept;
+
+  /**
+   * @brief Sets a time after which the run stops as if it was cancelled.
+   *
+   * @param deadline
+   */
+  void setDeadline (Clock::time_point deadline) noexcept;
+
+  /**
+   * @brief Returns @c true if cancellation was requested or the deadline
+   * has passed.
+   *
+   * @return boolean
+   */
+  bool isCancelled () const noexcept;
+
+  /**
+   * @brief Returns @c true if the run stops because of its deadline rather
+   * than of requestCancellation().
+   *
+   * @return boolean
+   */
+  bool isPastDeadline () const noexcept;
+
+  /**
+   * @brief Adds and-nodes to the work of the run (an engine may enumerate
+   * several times, e.g. once per mapping pass).
+   *
+   * @param numNodes
+   */
+  void addNodes (std::size_t numNodes) noexcept;
+
+  /**
+   * @brief Counts an and-node as done.
+   *
+   */
+  void nodeDone () noexcept;
+
+  /**
+   * @brief Returns the number of and-nodes added with addNodes().
+   *
+   * @return std::size_t
+   */
+  std::size_t getNumNodes () const noexcept;
+
+  /**
+   * @brief Returns the number of and-nodes done.
+   *
+   * @return std::size_t
+   */
+  std::size_t getNumDoneNodes () const noexcept;
+
+  /**
+   * @brief Returns the fraction of the and-nodes added that are done, from
+   * 0 to 1 (0 before any node is added).
+   *
+   * @return double
+   */
+  double getFraction () const noexcept;
+
+private:
+  std::atomic<bool> _cancelRequested = false;
+  // Deadline in ticks of Clock, or the largest tick count if there is none
+  std::atomic<std::int64_t> _deadline
+      = Clock::time_point::max ().time_since_epoch ().count ();
+  std::atomic<std::size_t> _numNodes = 0;
+  std::atomic<std::size_t> _numDoneNodes = 0;
+};
+
+#endif
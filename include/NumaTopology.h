@@ -0,0 +1,80 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _NUMATOPOLOGY_H
+#define _NUMATOPOLOGY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief NUMA nodes of the machine and the CPUs attached to them, read from
+ * sysfs on Linux. Elsewhere (or if sysfs cannot be read) the machine is seen
+ * as a single node 0 and binding does nothing.
+ *
+ */
+class NumaTopology
+{
+public:
+  /**
+   * @brief Returns the NUMA nodes that have CPUs, in increasing order. There
+   * is always at least one node.
+   *
+   * @return const std::vector<unsigned int>&
+   */
+  static const std::vector<unsigned int> &getNodes ();
+
+  /**
+   * @brief Returns the number of NUMA nodes that have CPUs.
+   *
+   * @return unsigned int
+   */
+  static unsigned int getNumNodes ();
+
+  /**
+   * @brief Returns the CPUs attached to a NUMA node (empty if unknown).
+   *
+   * @param node
+   * @return std::vector<unsigned int>
+   */
+  static std::vector<unsigned int> getNodeCpus (unsigned int node);
+
+  /**
+   * @brief Restricts the calling thread to the CPUs of a NUMA node. Returns
+   * @c false if the thread could not be bound.
+   *
+   * @param node
+   * @return boolean
+   */
+  static bool bindCurrentThread (unsigned int node);
+
+  /**
+   * @brief Asks the kernel to place the pages of a memory region (mapped with
+   * mmap and not touched yet) on a NUMA node. Returns @c false if the policy
+   * could not be set; the memory is usable anyway.
+   *
+   * @param address Page aligned address
+   * @param size
+   * @param node
+   * @return boolean
+   */
+  static bool bindMemory (void *address, std::size_t size, unsigned int node);
+
+  /**
+   * @brief Parses a Linux CPU or node list, such as "0-3,8,10-11".
+   *
+   * @param list
+   * @return std::vector<unsigned int>
+   */
+  static std::vector<unsigned int> parseList (const std::string &list);
+};
+
+#endif
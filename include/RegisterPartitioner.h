@@ -0,0 +1,210 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _REGISTERPARTITIONER_H
+#define _REGISTERPARTITIONER_H
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AndInverterGraph.h"
+#include "CutEngine.h"
+#include "DelayModel.h"
+
+/**
+ * @brief Maps a sequential design by cutting it at its registers.
+ *
+ * Latch outputs and primary inputs are sources, latch next-state inputs and
+ * primary outputs are sinks, and the combinational logic between them splits
+ * into islands: the connected components of the and-nodes that reach a
+ * sink. Each island becomes a combinational AndInverterGraph of its own
+ * (its sources as inputs, its sinks as outputs) and is mapped with a mapping
+ * engine (CutEngine by default, see setEngine()) and TechMapper; islands are
+ * handed to the threads one at a time, largest first. The covers are then
+ * stitched back in terms of the nodes of the design, and the latches are
+ * kept as they are: each still reads the node that drives its next state.
+ * The cover does not depend on the number of threads.
+ *
+ */
+class RegisterPartitioner
+{
+public:
+  RegisterPartitioner () = delete;
+
+  /**
+   * @brief Construct a new RegisterPartitioner object and split the design
+   * into islands.
+   *
+   * @param aig An AndInverterGraph object
+   * @param mappingGoal
+   * @param k Number of inputs of the lookup tables
+   * @param c Number of cuts kept per node (0 keeps all)
+   */
+  RegisterPartitioner (const AndInverterGraph &aig,
+                       MappingGoal mappingGoal = MappingGoal::MinimizeArea,
+                       unsigned int k = 6, unsigned int c = 0);
+
+  /**
+   * @brief Sets the engine that maps the islands: "cuts" (CutEngine, the
+   * default), "flowmap" (FlowMapEngine) or "zdd" (ZddCutEngine). Support
+   * reduction, the delay model and @c c only apply to "cuts". Throws
+   * @c std::runtime_error() for any other name.
+   *
+   * @param engine
+   */
+  void setEngine (const std::string &engine);
+
+  /**
+   * @brief Sets the number of threads that map the islands (1 by default).
+   *
+   * @param numThreads
+   */
+  void setNumThreads (unsigned int numThreads) noexcept;
+
+  /**
+   * @brief Enables or disables support reduction (see
+   * CutEngineBase::setSupportReduction()).
+   *
+   * @param supportReduction
+   */
+  void setSupportReduction (bool supportReduction) noexcept;
+
+  /**
+   * @brief Sets the delay model of the islands (see
+   * CutEngineBase::setDelayModel()).
+   *
+   * @param delayModel
+   */
+  void setDelayModel (const DelayModel &delayModel) noexcept;
+
+  /**
+   * @brief Maps every island and stitches the covers.
+   *
+   */
+  void run ();
+
+  /**
+   * @brief Returns the number of combinational islands.
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumIslands () const noexcept;
+
+  /**
+   * @brief Returns the number of lookup tables of the design. Only valid
+   * after run() has been called.
+   *
+   * @return unsigned int
+   */
+  unsigned int getMappingAreaCost () const noexcept;
+
+  /**
+   * @brief Returns the largest number of lookup table levels between two
+   * registers (or inputs and outputs). Only valid after run() has been
+   * called.
+   *
+   * @return unsigned int
+   */
+  unsigned int getMappingDelayCost () const noexcept;
+
+  /**
+   * @brief Returns @c true if an and-node of the design is implemented by a
+   * lookup table of the stitched cover.
+   *
+   * @param andLiteral The literal of an and-node of the design
+   * @return boolean
+   */
+  bool isImplemented (unsigned int andLiteral) const;
+
+  /**
+   * @brief Returns the inputs (variable indexes of inputs, latches or
+   * and-nodes of the design) of the lookup table of an and-node, or an empty
+   * vector if the node is not implemented or its function is constant.
+   *
+   * @param andLiteral The literal of an and-node of the design
+   * @return const std::vector<unsigned int>&
+   */
+  const std::vector<unsigned int> &
+  getLutInputs (unsigned int andLiteral) const;
+
+  /**
+   * @brief Returns a 64-bit hash of the stitched cover (see
+   * TechMapperBase::getFingerprint()).
+   *
+   * @return std::uint64_t
+   */
+  std::uint64_t getFingerprint () const;
+
+  /**
+   * @brief Print the mapping results to a C++ output stream
+   *
+   * @param os A std::ostream object
+   */
+  void printResults (std::ostream &os) const;
+
+  /**
+   * @brief Prints the lookup tables of the stitched cover and the latches.
+   *
+   * @param os A std::ostream object
+   */
+  void printImplementation (std::ostream &os) const;
+
+private:
+  struct Island
+  {
+    // Nodes of the design: sources (inputs of the island), and-nodes in
+    // topological order, and sink literals (outputs of the island)
+    std::vector<unsigned int> sourceVector = {};
+    std::vector<unsigned int> andVector = {};
+    std::vector<unsigned int> sinkVector = {};
+    std::unique_ptr<AndInverterGraph> aig = nullptr;
+    // And-nodes of the design implemented by the cover of the island
+    std::vector<unsigned int> lutVector = {};
+    unsigned int numLuts = 0;
+    unsigned int levels = 0;
+  };
+
+  const AndInverterGraph &_aig;
+  MappingGoal _mappingGoal = MappingGoal::MinimizeArea;
+  unsigned int _k = 6;
+  unsigned int _c = 0;
+  std::string _engine = "cuts";
+  unsigned int _numThreads = 1;
+  bool _supportReduction = true;
+  DelayModel _delayModel = {};
+  unsigned int _firstAndVariable = 0;
+  std::vector<Island> _islandVector = {};
+  // Lookup table inputs of each and-node of the design (empty if it is not
+  // implemented, or if its function is constant)
+  std::vector<std::vector<unsigned int>> _lutInputVector = {};
+  std::vector<bool> _implementedVector = {};
+  unsigned int _mappingAreaCost = 0;
+  unsigned int _mappingDelayCost = 0;
+
+  /**
+   * @brief Splits the design into islands and builds their graphs.
+   *
+   */
+  void partition ();
+
+  /**
+   * @brief Maps an island and stores the inputs of its lookup tables in
+   * _lutInputVector. Islands share no and-node, so islands can be mapped
+   * concurrently.
+   *
+   * @param island
+   */
+  void mapIsland (Island &island);
+};
+
+#endif
@@ -0,0 +1,240 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _SATSOLVER_H
+#define _SATSOLVER_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Conflict-driven clause learning SAT solver, for the small exact
+ * problems of the mapper (see ExactRemapper).
+ *
+ * Literals follow the AIGER convention: the positive literal of variable
+ * @c v is @c 2v and its negation is @c 2v+1. Clauses are watched by two
+ * literals; conflicts are analyzed up to the first unique implication point
+ * and the learnt clause is minimized against the reasons of its literals.
+ * Decisions follow variable activities (VSIDS) with saved phases, which
+ * start false, and the search restarts after a Luby sequence of conflicts.
+ * Learnt clauses are kept: the problems are small and each solve() has a
+ * conflict budget.
+ *
+ */
+class SatSolver
+{
+public:
+  enum class Result
+  {
+    Satisfiable,
+    Unsatisfiable,
+    Unknown
+  };
+
+  // Conflicts after which the first restart happens (the unit of the Luby
+  // sequence)
+  static constexpr unsigned int RestartUnit = 100;
+
+  SatSolver () = default;
+  SatSolver (const SatSolver &) = delete;
+  SatSolver &operator= (const SatSolver &) = delete;
+
+  /**
+   * @brief Adds a variable and returns its index.
+   *
+   * @return unsigned int
+   */
+  unsigned int newVariable ();
+
+  /**
+   * @brief Returns the number of variables.
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumVariables () const noexcept;
+
+  /**
+   * @brief Returns the literal of a variable, negated or not.
+   *
+   * @param variable
+   * @param negated
+   * @return unsigned int
+   */
+  static unsigned int literal (unsigned int variable,
+                               bool negated = false) noexcept;
+
+  /**
+   * @brief Adds a clause (a disjunction of literals). Returns @c false if
+   * the problem is now unsatisfiable at the top level. Throws
+   * @c std::runtime_error() if a literal is of an unknown variable.
+   *
+   * @param clause
+   * @return boolean
+   */
+  bool addClause (std::vector<unsigned int> clause);
+
+  /**
+   * @brief Adds the constraint that at most @c bound of @c literals are
+   * true, as a sequential counter (new auxiliary variables and
+   * O(literals x bound) clauses).
+   *
+   * @param literals
+   * @param bound
+   * @return boolean @c false if the problem is now unsatisfiable at the top
+   * level
+   */
+  bool addAtMost (const std::vector<unsigned int> &literals,
+                  unsigned int bound);
+
+  /**
+   * @brief Searches for an assignment that satisfies every clause, and
+   * gives up with Result::Unknown after @c conflictBudget conflicts.
+   *
+   * @param conflictBudget
+   * @return Result
+   */
+  Result
+  solve (std::uint64_t conflictBudget
+         = std::numeric_limits<std::uint64_t>::max ());
+
+  /**
+   * @brief Returns the value of a variable in the last satisfying
+   * assignment found by solve().
+   *
+   * @param variable
+   * @return boolean
+   */
+  bool getValue (unsigned int variable) const;
+
+  /**
+   * @brief Returns the number of conflicts over every call to solve().
+   *
+   * @return std::uint64_t
+   */
+  std::uint64_t getNumConflicts () const noexcept;
+
+private:
+  static constexpr unsigned int NoClause
+      = std::numeric_limits<unsigned int>::max ();
+  // Values of variables (and of literals, see literalValue())
+  static constexpr unsigned char False = 0;
+  static constexpr unsigned char True = 1;
+  static constexpr unsigned char Unassigned = 2;
+
+  // A clause in which the literal it is listed for is watched. If the
+  // blocker is true the clause is satisfied and need not be visited
+  struct Watcher
+  {
+    unsigned int clause;
+    unsigned int blocker;
+  };
+
+  bool _ok = true;
+  std::vector<std::vector<unsigned int>> _clauseVector = {};
+  std::vector<std::vector<Watcher>> _watchVector = {};
+  std::vector<unsigned char> _assignmentVector = {};
+  std::vector<unsigned char> _phaseVector = {};
+  std::vector<unsigned int> _levelVector = {};
+  std::vector<unsigned int> _reasonVector = {};
+  std::vector<unsigned int> _trail = {};
+  std::vector<unsigned int> _trailLimitVector = {};
+  std::size_t _propagationHead = 0;
+  std::vector<bool> _seenVector = {};
+  std::vector<bool> _modelVector = {};
+  std::uint64_t _numConflicts = 0;
+
+  // Variable activities, with a max-heap of the unassigned variables
+  std::vector<double> _activityVector = {};
+  double _activityIncrement = 1;
+  std::vector<unsigned int> _heap = {};
+  std::vector<int> _heapPositionVector = {};
+
+  unsigned char literalValue (unsigned int literal) const noexcept;
+  unsigned int decisionLevel () const noexcept;
+
+  /**
+   * @brief Makes @c literal true, implied by @c reason (or decided if it is
+   * NoClause).
+   *
+   * @param literal
+   * @param reason
+   */
+  void enqueue (unsigned int literal, unsigned int reason);
+
+  /**
+   * @brief Adds a clause of two literals or more to the clause vector and
+   * watches its first two literals.
+   *
+   * @param clause
+   * @return unsigned int The index of the clause
+   */
+  unsigned int attachClause (std::vector<unsigned int> clause);
+
+  /**
+   * @brief Propagates the literals of the trail not propagated yet. Returns
+   * the index of a clause whose literals are all false, or NoClause.
+   *
+   * @return unsigned int
+   */
+  unsigned int propagate ();
+
+  /**
+   * @brief Derives a learnt clause from a conflict. Its first literal is the
+   * one asserted after backtracking, and its second one is of the level to
+   * backtrack to.
+   *
+   * @param conflict
+   * @return std::vector<unsigned int>
+   */
+  std::vector<unsigned int> analyze (unsigned int conflict);
+
+  /**
+   * @brief Returns @c true if @c literal of the learnt clause is implied by
+   * the other literals of the clause (marked as seen).
+   *
+   * @param literal
+   * @return boolean
+   */
+  bool isRedundant (unsigned int literal) const;
+
+  /**
+   * @brief Undoes the assignments above decision level @c level.
+   *
+   * @param level
+   */
+  void backtrack (unsigned int level);
+
+  void bumpActivity (unsigned int variable);
+  void decayActivities () noexcept;
+
+  /**
+   * @brief Returns the unassigned variable of largest activity, or the
+   * number of variables if every variable is assigned.
+   *
+   * @return unsigned int
+   */
+  unsigned int pickBranchVariable ();
+
+  void heapInsert (unsigned int variable);
+  void heapSiftUp (std::size_t position);
+  void heapSiftDown (std::size_t position);
+
+  /**
+   * @brief Returns the i-th element (from 0) of the Luby sequence 1, 1, 2,
+   * 1, 1, 2, 4, ...
+   *
+   * @param i
+   * @return std::uint64_t
+   */
+  static std::uint64_t luby (std::uint64_t i) noexcept;
+};
+
+#endif
@@ -0,0 +1,248 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _SEQUENTIALMAPPER_H
+#define _SEQUENTIALMAPPER_H
+
+#include <iostream>
+#include <vector>
+
+#include "AndInverterGraph.h"
+
+/**
+ * @brief Sequential mapping with retiming, after SeqMapII: the latches are
+ * not fixed cut boundaries, and the mapper looks for the lookup table cover
+ * and the register positions that minimize the clock period.
+ *
+ * Each latch is collapsed into the edge it drives, so the and-nodes form a
+ * graph whose edges carry a number of registers (a weight). Cuts are taken
+ * in this graph: a leaf is a node and the number of registers between it and
+ * the root. For a clock period @c p, the sequential label of a node is
+ * computed from the best of its priority cuts as the largest
+ * @c label(leaf) - p * weight(leaf) over the leaves, plus one. Labels start
+ * at 0 (as if every node was reachable from the inputs at time 0) and are
+ * raised until they no longer change. The period is feasible if they
+ * converge with every output at most @c p. Labels never decrease, so the
+ * period is rejected as soon as an output exceeds it, or when they still
+ * change after one pass per mapped node (a positive cycle makes them grow
+ * without bound). The smallest feasible period is found by binary search, up to the period of the unretimed mapping, and the retiming lag of
+ * each lookup table is @c ceil(label / p) - 1.
+ *
+ * Latch initial values are not carried over to the retimed registers.
+ *
+ */
+class SequentialMapper
+{
+public:
+  SequentialMapper () = delete;
+
+  /**
+   * @brief Construct a new SequentialMapper object from an AndInverterGraph
+   * object.
+   *
+   * @param aig An AndInverterGraph object
+   * @param k Number of inputs of the lookup tables
+   * @param c Number of priority cuts kept per node
+   */
+  SequentialMapper (const AndInverterGraph &aig, unsigned int k = 6,
+                    unsigned int c = 8);
+
+  /**
+   * @brief Finds the smallest clock period, its cover and its retiming.
+   *
+   */
+  void run ();
+
+  /**
+   * @brief Returns the clock period after retiming, in lookup table levels.
+   * Only valid after run() has been called.
+   *
+   * @return unsigned int
+   */
+  unsigned int getClockPeriod () const noexcept;
+
+  /**
+   * @brief Returns the clock period of the mapping that keeps the latches in
+   * place, in lookup table levels. Only valid after run() has been called.
+   *
+   * @return unsigned int
+   */
+  unsigned int getUnretimedClockPeriod () const noexcept;
+
+  /**
+   * @brief Returns the number of lookup tables of the cover. Only valid
+   * after run() has been called.
+   *
+   * @return unsigned int
+   */
+  unsigned int getMappingAreaCost () const noexcept;
+
+  /**
+   * @brief Returns the number of registers after retiming (registers on the
+   * fanouts of a node are shared). Only valid after run() has been called.
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumRegisters () const noexcept;
+
+  /**
+   * @brief Returns the sequential label of a node for the clock period found
+   * by run(). Inputs have label 0.
+   *
+   * @param nodeLiteral The literal of an input or and-node
+   * @return int
+   */
+  int getLabel (unsigned int nodeLiteral) const;
+
+  /**
+   * @brief Returns @c true if an and-node is the root of a lookup table of
+   * the cover. Only valid after run() has been called.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return boolean
+   */
+  bool isImplemented (unsigned int andLiteral) const;
+
+  /**
+   * @brief Returns the retiming lag of the lookup table rooted at an
+   * and-node: the number of registers moved from its outputs to its inputs.
+   * Throws an exception if the and-node is not implemented.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return int
+   */
+  int getLag (unsigned int andLiteral) const;
+
+  /**
+   * @brief Print the mapping results to a C++ output stream
+   *
+   * @param os A std::ostream object
+   */
+  void printResults (std::ostream &os) const;
+
+  /**
+   * @brief Print the lookup tables of the cover to a C++ output stream, each
+   * with the leaves of its cut (a leaf read through @c w registers is
+   * printed as @c literal@w) and its retiming lag
+   *
+   * @param os A std::ostream object
+   */
+  void printImplementation (std::ostream &os) const;
+
+private:
+  // Largest number of registers between a leaf and the root of a cut,
+  // except for the leaves that are fanins of the root
+  static constexpr unsigned int MaxLeafWeight = 3;
+
+  // A node and the number of registers between it and the root of a cut
+  struct SequentialLeaf
+  {
+    unsigned int variable;
+    unsigned int weight;
+    bool
+    operator< (const SequentialLeaf &rhs) const noexcept
+    {
+      return variable != rhs.variable ? variable < rhs.variable
+                                      : weight < rhs.weight;
+    }
+    bool
+    operator== (const SequentialLeaf &rhs) const noexcept
+    {
+      return variable == rhs.variable && weight == rhs.weight;
+    }
+  };
+  // Sorted leaves
+  using SequentialCut = std::vector<SequentialLeaf>;
+  static constexpr unsigned int ConstantVariable = -1;
+
+  const AndInverterGraph &_aig;
+  unsigned int _k = 6;
+  unsigned int _c = 8;
+  unsigned int _firstAndVariable = 0;
+  // Fanins of each and-node, with the latches between them and the node
+  std::vector<SequentialLeaf> _faninVector = {};
+  // Output drivers, with the latches between them and the output
+  std::vector<SequentialLeaf> _outputDriverVector = {};
+  // Fewest latches between each variable and an output it drives, or
+  // NoOutput if it drives none
+  static constexpr unsigned int NoOutput = -1;
+  std::vector<unsigned int> _outputWeightVector = {};
+  // Priority cuts of each and-node, the best one first
+  std::vector<std::vector<SequentialCut>> _cutSetVector = {};
+  // Label of each variable index
+  std::vector<int> _labelVector = {};
+  // Variables that reach an output; the others are not mapped
+  std::vector<bool> _isLive = {};
+  unsigned int _numLiveAnds = 0;
+  // Roots of the lookup tables of the cover and their retiming lags,
+  // indexed by variable
+  std::vector<bool> _isImplementedVector = {};
+  std::vector<int> _lagVector = {};
+  unsigned int _clockPeriod = 0;
+  unsigned int _unretimedClockPeriod = 0;
+  unsigned int _mappingAreaCost = 0;
+  unsigned int _numRegisters = 0;
+
+  /**
+   * @brief Follows a literal through latches to the input or and-node that
+   * drives it. Throws @c std::runtime_error() on a loop of latches.
+   *
+   * @param literal
+   * @return SequentialLeaf
+   */
+  SequentialLeaf resolveDriver (unsigned int literal) const;
+
+  /**
+   * @brief Returns the label of a cut for a clock period.
+   *
+   * @param cut
+   * @param period
+   * @return int
+   */
+  int cutLabel (const SequentialCut &cut, int period) const;
+
+  /**
+   * @brief Computes the priority cuts of an and-node from the cuts of its
+   * fanins and returns the label of the best one. Without retiming, cuts
+   * stop at the latches and a latch is a leaf of label 0.
+   *
+   * @param andVariable
+   * @param period
+   * @param retime
+   * @return int
+   */
+  int enumerateCuts (unsigned int andVariable, int period, bool retime);
+
+  /**
+   * @brief Computes the sequential labels for a clock period. Returns
+   * @c true if they converge and meet the period at the outputs.
+   *
+   * @param period
+   * @return boolean
+   */
+  bool computeLabels (int period);
+
+  /**
+   * @brief Maps the design with the latches in place and returns its clock
+   * period.
+   *
+   * @return unsigned int
+   */
+  unsigned int computeUnretimedPeriod ();
+
+  /**
+   * @brief Builds the cover for the labels of the clock period found, and
+   * counts its lookup tables and the registers of its retiming.
+   *
+   */
+  void buildCover ();
+};
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _STRINGPOOL_H
+#define _STRINGPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Stores strings once each, packed in large blocks, and identifies
+ * them by an integer. Interning a string already in the pool returns its
+ * existing identifier, so a name that appears many times is stored once and
+ * no string costs a heap allocation of its own.
+ *
+ */
+class StringPool
+{
+public:
+  StringPool () = default;
+  StringPool (const StringPool &) = delete;
+  StringPool &operator= (const StringPool &) = delete;
+
+  /**
+   * @brief Returns the identifier of @c text, copying it into the pool if it
+   * is not there yet. Identifiers are consecutive, starting from 0.
+   *
+   * @param text
+   * @return unsigned int
+   */
+  unsigned int intern (std::string_view text);
+
+  /**
+   * @brief Returns the string of an identifier. The view is valid as long as
+   * the pool exists. Throws @c std::out_of_range if the identifier is not in
+   * the pool.
+   *
+   * @param id
+   * @return std::string_view
+   */
+  std::string_view getString (unsigned int id) const;
+
+  /**
+   * @brief Returns the number of distinct strings in the pool.
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumStrings () const noexcept;
+
+  /**
+   * @brief Returns the number of bytes used by the strings of the pool.
+   *
+   * @return std::size_t
+   */
+  std::size_t getNumBytes () const noexcept;
+
+  /**
+   * @brief Removes all strings from the pool.
+   *
+   */
+  void clear () noexcept;
+
+private:
+  // Size of the blocks; longer strings get a block of their own
+  static constexpr std::size_t BlockSize = 64 * 1024;
+
+  std::vector<std::unique_ptr<char[]>> _blockVector = {};
+  std::size_t _blockUsed = BlockSize;
+  std::size_t _numBytes = 0;
+  std::vector<std::string_view> _stringVector = {};
+  std::unordered_map<std::string_view, unsigned int> _idMap = {};
+};
+
+#endif
@@ -8,31 +8,148 @@
  *
  */
 
+#ifndef _TECHMAPPER_H
+#define _TECHMAPPER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
 #include "AndInverterGraph.h"
-#include "CutEngine.h"
+#include "JsonWriter.h"
+#include "MappingEngine.h"
+#include "MappingObserver.h"
+#include "WorkerPool.h"
 
-class TechMapper
+/**
+ * @brief Builds the lookup table cover of an AndInverterGraph from the cuts
+ * chosen by a mapping engine.
+ *
+ * As in CutEngineBase, events are notified through @c ObserverPolicy:
+ * TechMapper uses NullObserverPolicy and ObservedTechMapper uses
+ * DynamicObserverPolicy.
+ *
+ */
+template <typename ObserverPolicy> class TechMapperBase : public ObserverPolicy
 {
 public:
-  TechMapper () = delete;
+  TechMapperBase () = delete;
 
   /**
-   * @brief Construct a new TechMapper from a CutEngine object
+   * @brief Construct a new TechMapper from a mapping engine (e.g. a CutEngine
+   * or a FlowMapEngine object)
    *
-   * @param cutEngine
+   * @param mappingEngine
    */
-  TechMapper (CutEngine &cutEngine);
+  TechMapperBase (MappingEngine &mappingEngine);
 
   /**
    * @brief Runs FPGA technology mapping.
    *
-   * This method uses the CutEngine object (passed as argument during
+   * This method uses the mapping engine (passed as argument during
    * construction of the TechMapper object) to find the best implementation of
    * the AndInverterGraph with K-input lookup-tables.
    *
+   * If the delay model of the engine depends on fanout, the first cover is
+   * built from the cuts the engine already has (with the fanout estimates
+   * they were found with), and the next ones with fanout estimates updated
+   * from the previous cover, until the estimates do not change or the
+   * maximum number of passes is reached (see hasConverged()). The cover with
+   * the smallest estimated delay is kept.
+   *
    */
   void run ();
 
+  /**
+   * @brief Sets the maximum number of mapping passes done by run() (default
+   * 8). Values lower than 1 are taken as 1.
+   *
+   * @param maxPasses
+   */
+  void setMaxPasses (unsigned int maxPasses) noexcept;
+
+  /**
+   * @brief Returns the number of mapping passes done by the last call to
+   * run().
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumPasses () const noexcept;
+
+  /**
+   * @brief Returns whether the fanout estimates of the last call to run()
+   * stopped changing before the maximum number of passes was reached. It is
+   * @c true if the delay model does not depend on fanout.
+   *
+   * @return boolean
+   */
+  bool hasConverged () const noexcept;
+
+  /**
+   * @brief Sets the number of threads that extract the cover (1 by default).
+   * The cover is the same for any number of threads. With more than one,
+   * the selected cuts are read from several threads at once, which the
+   * const methods of the mapping engine must allow.
+   *
+   * @param numThreads
+   */
+  void setNumThreads (unsigned int numThreads) noexcept;
+
+  /**
+   * @brief Returns the number of threads that extract the cover.
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumThreads () const noexcept;
+
+  /**
+   * @brief Returns @c true if an and-node is the root of a lookup table of
+   * the cover, or a constant driver (its selected cut has no leaves, e.g.
+   * after support reduction). Only valid after run() has been called.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return boolean
+   */
+  bool isImplemented (unsigned int andLiteral) const;
+
+  /**
+   * @brief Returns the number of lookup tables of the mapping. Only valid
+   * after run() has been called.
+   *
+   * @return unsigned int
+   */
+  unsigned int getMappingAreaCost () const noexcept;
+
+  /**
+   * @brief Returns the number of lookup table levels of the mapping. Only
+   * valid after run() has been called.
+   *
+   * @return unsigned int
+   */
+  unsigned int getMappingDelayCost () const noexcept;
+
+  /**
+   * @brief Returns the delay of the critical path of the mapping, evaluated
+   * with the delay model of the mapping engine and the fanouts in the cover.
+   * With the unit delay model it is equal to the number of levels. Only valid
+   * after run() has been called.
+   *
+   * @return unsigned int
+   */
+  unsigned int getMappingEstimatedDelay () const noexcept;
+
+  /**
+   * @brief Returns a 64-bit hash of the cover: the literal of every
+   * implemented and-node and the leaves of its selected cut, in node order.
+   * Equal covers have equal fingerprints, so runs can be compared without
+   * comparing their implementations. Only valid after run() has been called.
+   *
+   * @return std::uint64_t
+   */
+  std::uint64_t getFingerprint () const;
+
   /**
    * @brief Print the mapping results to a C++ output stream
    *
@@ -40,6 +157,19 @@ public:
    */
   void printResults (std::ostream &os);
 
+  /**
+   * @brief Writes the results as the members of the current object of a
+   * JsonWriter: the costs and the fingerprint, the number of lookup tables
+   * by number of inputs (@c lutsByInputs, index 0 to k), the number of
+   * lookup tables at each level (@c levelHistogram, level 1 first), the
+   * depth of every output (@c outputs) and the indexes of the outputs on a
+   * critical path (@c criticalOutputs). Outputs are streamed one at a time.
+   * Only valid after run() has been called.
+   *
+   * @param writer A JsonWriter object, inside an object
+   */
+  void writeReport (JsonWriter &writer) const;
+
   /**
    * @brief Print the implementation to a C++ output stream
    *
@@ -51,7 +181,72 @@ private:
   unsigned int _mappingAreaCost = 0;
   unsigned int _mappingDelayCost = 0;
   unsigned int _mappingPowerCost = 0;
-  std::map<unsigned int, bool> _implementationMap = {};
+  unsigned int _mappingEstimatedDelay = 0;
+  unsigned int _maxPasses = 8;
+  unsigned int _numPasses = 0;
+  bool _converged = true;
+  unsigned int _numThreads = 1;
+  // One bit per and-node, set when the node is implemented. Bits are set
+  // with fetch_or, so the threads extracting the cover agree on which one
+  // implements each node
+  std::vector<std::atomic<std::uint64_t>> _implementedBitmap = {};
+  std::unique_ptr<WorkerPool> _workerPool = nullptr;
   const AndInverterGraph &_aig;
-  CutEngine &_cutEngine;
-};
\ No newline at end of file
+  MappingEngine &_mappingEngine;
+
+  /**
+   * @brief Marks an and-node as implemented. Returns @c true if it was not
+   * implemented yet, so that exactly one caller sees each node as new.
+   *
+   * @param andLiteral The literal of an and-node (even)
+   * @return boolean
+   */
+  bool markImplemented (unsigned int andLiteral);
+
+  /**
+   * @brief Runs @c task on each of the setNumThreads() threads, passing the
+   * thread number, or on the calling thread alone (as thread 0) if the
+   * cover is extracted by one thread.
+   *
+   * @param task
+   */
+  void runOnThreads (const std::function<void (unsigned int)> &task);
+
+  /**
+   * @brief Builds the cover of the AndInverterGraph from the selected cuts of
+   * the mapping engine, counting its lookup tables. The engine is run first,
+   * so that the cuts are found by its own schedule and not in the order the
+   * outputs are covered.
+   *
+   * The cover is extracted by a breadth-first search from the outputs: the
+   * nodes of each frontier are shared among the threads, each thread
+   * collects the leaves it implements first into its own next frontier and
+   * counts its lookup tables, and the counts are summed afterwards.
+   *
+   */
+  void coverOutputs ();
+
+  /**
+   * @brief Returns the fanout of each variable index in the cover: the
+   * number of lookup tables that have it as input plus the number of outputs
+   * it drives.
+   *
+   * @return std::vector<unsigned int>
+   */
+  std::vector<unsigned int> evaluateCoverFanouts () const;
+
+  /**
+   * @brief Evaluates the number of levels and the estimated delay of the
+   * cover, visiting its lookup tables in topological order. The maxima over
+   * the outputs are reduced per thread.
+   *
+   * @param coverFanoutVector The fanouts returned by evaluateCoverFanouts()
+   */
+  void evaluateCoverDelay (const std::vector<unsigned int> &coverFanoutVector);
+};
+
+using TechMapper = TechMapperBase<NullObserverPolicy>;
+using ObservedTechMapper = TechMapperBase<DynamicObserverPolicy>;
+
+
+#endif
\ No newline at end of file
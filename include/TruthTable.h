@@ -0,0 +1,132 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _TRUTHTABLE_H
+#define _TRUTHTABLE_H
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief Truth table of a boolean function of up to MaxVariables variables,
+ * stored as 64-bit words. Bit @c m of the table is the value of the function
+ * for minterm @c m, where bit @c i of @c m is the value of variable @c i.
+ *
+ * Tables with less than 6 variables use a single word in which the function
+ * is repeated, so that all operations are done on whole words.
+ *
+ */
+class TruthTable
+{
+public:
+  // Largest number of variables supported
+  static constexpr unsigned int MaxVariables = 16;
+
+  /**
+   * @brief Constructs an empty TruthTable object, with no words. Empty tables
+   * stand for "truth table not computed".
+   *
+   */
+  TruthTable () = default;
+
+  /**
+   * @brief Constructs a new TruthTable object of the constant FALSE function.
+   *
+   * @param numVariables Number of variables of the function
+   */
+  explicit TruthTable (unsigned int numVariables);
+
+  /**
+   * @brief Returns the truth table of the function that is equal to variable
+   * @c variable.
+   *
+   * @param numVariables Number of variables of the function
+   * @param variable Index of the variable, lower than @c numVariables
+   * @return TruthTable
+   */
+  static TruthTable nthVariable (unsigned int numVariables,
+                                 unsigned int variable);
+
+  /**
+   * @brief Returns the number of variables of the function.
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumVariables () const noexcept;
+
+  /**
+   * @brief Returns @c true if the table holds no words, which is the case of
+   * default-constructed tables.
+   *
+   * @return boolean
+   */
+  bool isEmpty () const noexcept;
+
+  /**
+   * @brief Returns @c true if the function depends on @c variable, by
+   * comparing its two cofactors with word-level operations.
+   *
+   * @param variable
+   * @return boolean
+   */
+  bool dependsOn (unsigned int variable) const;
+
+  /**
+   * @brief Removes a variable the function does not depend on, halving the
+   * table. Variables above @c variable are renumbered down by one. Throws
+   * @c std::runtime_error() if the function depends on @c variable.
+   *
+   * @param variable
+   */
+  void removeVariable (unsigned int variable);
+
+  /**
+   * @brief Returns the value of the function for a minterm.
+   *
+   * @param minterm A minterm, lower than 2 ^ getNumVariables()
+   * @return boolean
+   */
+  bool getBit (unsigned int minterm) const;
+
+  /**
+   * @brief Sets the value of the function for a minterm (in every copy of
+   * the function, for tables of less than 6 variables).
+   *
+   * @param minterm A minterm, lower than 2 ^ getNumVariables()
+   * @param value
+   */
+  void setBit (unsigned int minterm, bool value);
+
+  /**
+   * @brief Returns a read-only reference to the words of the table.
+   *
+   * @return const std::vector<std::uint64_t>&
+   */
+  const std::vector<std::uint64_t> &getWords () const noexcept;
+
+  TruthTable operator& (const TruthTable &rhs) const;
+  TruthTable operator~ () const;
+  bool operator== (const TruthTable &rhs) const;
+
+  /**
+   * @brief Prints the table in hexadecimal, most significant minterm first.
+   *
+   * @return std::ostream&
+   */
+  friend std::ostream &operator<< (std::ostream &os,
+                                   const TruthTable &truthTable);
+
+private:
+  unsigned int _numVariables = 0;
+  std::vector<std::uint64_t> _words = {};
+};
+
+#endif
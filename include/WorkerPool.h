@@ -0,0 +1,82 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _WORKERPOOL_H
+#define _WORKERPOOL_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads that run the same task together. Each
+ * call to runOnAll() is a parallel step followed by a barrier: it returns
+ * once every worker has finished the task, so the results of a step are
+ * visible to the caller and to the next step.
+ *
+ */
+class WorkerPool
+{
+public:
+  /**
+   * @brief Construct a new WorkerPool object and start its workers. Each
+   * worker calls @c onStart with its number (0 to numWorkers - 1) before
+   * running any task, e.g. to bind itself to a NUMA node.
+   *
+   * @param numWorkers Number of worker threads (at least 1)
+   * @param onStart
+   */
+  explicit WorkerPool (unsigned int numWorkers,
+                       std::function<void (unsigned int)> onStart = {});
+
+  WorkerPool (const WorkerPool &) = delete;
+  WorkerPool &operator= (const WorkerPool &) = delete;
+
+  /**
+   * @brief Stops and joins the workers.
+   *
+   */
+  ~WorkerPool ();
+
+  /**
+   * @brief Returns the number of workers.
+   *
+   * @return unsigned int
+   */
+  unsigned int getNumWorkers () const noexcept;
+
+  /**
+   * @brief Runs @c task on every worker, passing the worker number, and waits
+   * for all of them. If a task throws, the first exception is rethrown here
+   * after all workers finish.
+   *
+   * @param task
+   */
+  void runOnAll (const std::function<void (unsigned int)> &task);
+
+private:
+  std::vector<std::thread> _workerVector = {};
+  std::mutex _mutex;
+  std::condition_variable _startCondition;
+  std::condition_variable _doneCondition;
+  const std::function<void (unsigned int)> *_task = nullptr;
+  unsigned long _generation = 0;
+  unsigned int _numRunning = 0;
+  bool _stopping = false;
+  std::exception_ptr _exception = nullptr;
+
+  void workerLoop (unsigned int worker,
+                   std::function<void (unsigned int)> onStart);
+};
+
+#endif
@@ -0,0 +1,199 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _ZDDCUTENGINE_H
+#define _ZDDCUTENGINE_H
+
+#include <vector>
+
+#include "AndInverterGraph.h"
+#include "CutEngine.h"
+#include "MappingEngine.h"
+#include "ZddManager.h"
+
+/**
+ * @brief Mapping engine that enumerates all K-feasible cuts implicitly.
+ *
+ * The cut family of each and-node is a ZDD whose variables are the variable
+ * indexes of the AIG. All families share the nodes of a single ZddManager, so
+ * cuts with common leaves are stored once. The diamond operation is a ZDD
+ * product filtered by set size, and the best cut of a node is extracted by a
+ * shortest-path query on its ZDD, without ever listing the family.
+ *
+ */
+class ZddCutEngine : public MappingEngine
+{
+public:
+  ZddCutEngine () = delete;
+
+  /**
+   * @brief Construct a new ZddCutEngine object from an AndInverterGraph
+   * object.
+   *
+   * @param aig An AndInverterGraph object
+   * @param mappingGoal The goal used to choose the best cut of each node
+   * @param k Number of inputs of the lookup tables
+   */
+  ZddCutEngine (const AndInverterGraph &aig,
+                MappingGoal mappingGoal = MappingGoal::MinimizeArea,
+                unsigned int k = 6);
+
+  /**
+   * @brief Returns a read-only reference for the AndInverterGraph object used
+   * to initialize the ZddCutEngine.
+   *
+   * @return const AndInverterGraph&
+   */
+  const AndInverterGraph &getAndInverterGraph () const noexcept override;
+
+  /**
+   * @brief Boolean predicate that returns @c true if the cut family of
+   * @c andLiteral has been built. Returns @c false otherwise.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return boolean
+   */
+  bool hasBestCut (unsigned int andLiteral) const override;
+
+  /**
+   * @brief Returns a read-only reference for a CutSet with the best cut of an
+   * and-node (the family itself is kept implicit, see getCutFamily()). If the
+   * family has not been built it returns a reference for an empty CutSet.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return const CutSet&
+   */
+  const CutSet &getCutSet (unsigned int andLiteral) const override;
+
+  /**
+   * @brief Returns a read-only reference for the best Cut of an and-node.
+   * Throws an exception if the family of @c andLiteral has not been built.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return const Cut&
+   */
+  const Cut &getBestCut (unsigned int andLiteral) const override;
+
+  /**
+   * @brief Returns the root of the ZDD with all K-feasible cuts of an
+   * and-node. Throws an exception if the family has not been built.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return unsigned int
+   */
+  unsigned int getCutFamily (unsigned int andLiteral) const;
+
+  /**
+   * @brief Returns the number of K-feasible cuts of an and-node.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return double
+   */
+  double countCuts (unsigned int andLiteral) const;
+
+  /**
+   * @brief Returns a read-only reference for the ZddManager shared by all cut
+   * families.
+   *
+   * @return const ZddManager&
+   */
+  const ZddManager &getZddManager () const noexcept;
+
+  /**
+   * @brief Builds the cut families of @c andLiteral and of all and-nodes in
+   * its transitive fanin, in topological order. Returns the CutSet of
+   * @c andLiteral.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return const CutSet&
+   */
+  const CutSet &findCuts (const unsigned int &andLiteral) override;
+
+  /**
+   * @brief Builds the cut families of all and-nodes that drive an output of
+   * the AndInverterGraph.
+   *
+   */
+  void run () override;
+
+  /**
+   * @brief Counts the and-nodes whose families are built by findCuts() in
+   * @c progress and checks it between nodes. When it is cancelled, the
+   * families and cuts found are discarded and findCuts() throws
+   * MappingCancelled.
+   *
+   * @param progress A MappingProgress object, or @c nullptr
+   */
+  void setProgress (MappingProgress *progress) noexcept override;
+
+private:
+  const AndInverterGraph &_aig;
+  MappingGoal _mappingGoal = MappingGoal::MinimizeArea;
+  unsigned int _k = 6;
+  MappingProgress *_progress = nullptr;
+  ZddManager _zddManager;
+  std::vector<unsigned int> _cutFamilyVector = {};
+  std::vector<CutSet> _cutSetVector = {};
+
+  // Area flow of the best cut of each variable index (zero for sources)
+  std::vector<double> _areaFlowVector = {};
+
+  /**
+   * @brief Converts an and-literal into an index to access internal vectors.
+   * Throws @c std::overflow_error() if the index is equal or greater than the
+   * size of those vectors.
+   *
+   * @param andLiteral The literal of an and-node
+   * @return unsigned int
+   */
+  unsigned int vectorIndexFromAndLiteral (unsigned int andLiteral) const;
+
+  /**
+   * @brief If the run is cancelled (see setProgress()), discards the
+   * families (and the nodes of the ZddManager) and cuts found and throws
+   * MappingCancelled.
+   *
+   */
+  void stopIfCancelled ();
+
+  /**
+   * @brief Builds the cut family of an and-node whose fanins have their
+   * families built, and extracts its best cut.
+   *
+   * @param andVariable The variable index of an and-node
+   */
+  void buildCutFamily (unsigned int andVariable);
+
+  /**
+   * @brief Returns the arrival time of a leaf: 1 for sources and the delay of
+   * the best cut plus 1 for and-nodes.
+   *
+   * @param variable The variable index of the leaf
+   * @return unsigned int
+   */
+  unsigned int leafArrival (unsigned int variable) const;
+
+  /**
+   * @brief Extracts the best cut of a family with shortest-path queries on
+   * its ZDD.
+   *
+   * When minimizing delay, a first query finds the smallest arrival time D
+   * over all cuts (the cost of a path is the largest arrival of its leaves);
+   * a second query finds the cut with the smallest area flow among those
+   * whose leaves all arrive by D. When minimizing area a single query finds
+   * the cut with the smallest area flow.
+   *
+   * @param cutFamily The root of a ZDD
+   * @return std::set<unsigned int> The leaves of the best cut
+   */
+  std::set<unsigned int> extractBestCut (unsigned int cutFamily) const;
+};
+
+#endif
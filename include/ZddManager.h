@@ -0,0 +1,227 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#ifndef _ZDDMANAGER_H
+#define _ZDDMANAGER_H
+
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Zero-suppressed decision diagrams (ZDDs) representing families of
+ * sets of variables. All diagrams created by a ZddManager share a unique table
+ * (so equal families are represented by the same node) and a computed cache
+ * (so operations are not evaluated twice for the same operands).
+ *
+ * A diagram is identified by the index of its root node. Index 0 is the empty
+ * family and index 1 is the family holding only the empty set. Variables with
+ * lower values are closer to the root.
+ *
+ */
+class ZddManager
+{
+public:
+  // The empty family
+  static constexpr unsigned int Empty = 0;
+
+  // The family holding only the empty set
+  static constexpr unsigned int Base = 1;
+
+  /**
+   * @brief Constructs a new ZddManager object with the two terminal nodes.
+   *
+   * @param cacheLimit Number of entries of the computed cache above which the
+   * cache is cleared
+   */
+  ZddManager (std::size_t cacheLimit = 1 << 22);
+
+  /**
+   * @brief Returns the family {{variable}}.
+   *
+   * @param variable
+   * @return unsigned int
+   */
+  unsigned int singleton (unsigned int variable);
+
+  /**
+   * @brief Returns the union of two families.
+   *
+   * @param zddA
+   * @param zddB
+   * @return unsigned int
+   */
+  unsigned int unite (unsigned int zddA, unsigned int zddB);
+
+  /**
+   * @brief Returns the family { a U b : a in zddA, b in zddB, |a U b| <= k },
+   * i.e. the product of two families filtered by set size.
+   *
+   * @param zddA
+   * @param zddB
+   * @param k Maximum number of variables of a set in the result
+   * @return unsigned int
+   */
+  unsigned int product (unsigned int zddA, unsigned int zddB, unsigned int k);
+
+  /**
+   * @brief Returns the sets of @c zdd with at most @c k variables.
+   *
+   * @param zdd
+   * @param k
+   * @return unsigned int
+   */
+  unsigned int restrict (unsigned int zdd, unsigned int k);
+
+  /**
+   * @brief Returns the number of sets in a family.
+   *
+   * @param zdd
+   * @return double
+   */
+  double count (unsigned int zdd) const;
+
+  /**
+   * @brief Returns the variable of a non-terminal node.
+   *
+   * @param zdd
+   * @return unsigned int
+   */
+  unsigned int getVariable (unsigned int zdd) const;
+
+  /**
+   * @brief Returns the child of a non-terminal node for sets without its
+   * variable.
+   *
+   * @param zdd
+   * @return unsigned int
+   */
+  unsigned int getLow (unsigned int zdd) const;
+
+  /**
+   * @brief Returns the child of a non-terminal node for sets with its
+   * variable.
+   *
+   * @param zdd
+   * @return unsigned int
+   */
+  unsigned int getHigh (unsigned int zdd) const;
+
+  /**
+   * @brief Returns @c true if @c zdd is one of the two terminal nodes.
+   *
+   * @param zdd
+   * @return boolean
+   */
+  static bool isTerminal (unsigned int zdd) noexcept;
+
+  /**
+   * @brief Returns the number of nodes created so far, including the
+   * terminals.
+   *
+   * @return std::size_t
+   */
+  std::size_t getNumNodes () const noexcept;
+
+private:
+  struct ZddNode
+  {
+    unsigned int variable;
+    unsigned int low;
+    unsigned int high;
+    bool operator== (const ZddNode &rhs) const
+    {
+      return variable == rhs.variable && low == rhs.low && high == rhs.high;
+    }
+  };
+
+  struct ZddNodeHash
+  {
+    std::size_t
+    operator() (const ZddNode &node) const noexcept
+    {
+      std::size_t hash = node.variable;
+      hash = hash * 0x9e3779b97f4a7c15ULL + node.low;
+      hash = hash * 0x9e3779b97f4a7c15ULL + node.high;
+      return hash ^ (hash >> 29);
+    }
+  };
+
+  enum class Operation : unsigned int
+  {
+    Unite,
+    Product,
+    Restrict
+  };
+
+  struct CacheKey
+  {
+    Operation operation;
+    unsigned int first;
+    unsigned int second;
+    unsigned int k;
+    bool operator== (const CacheKey &rhs) const
+    {
+      return operation == rhs.operation && first == rhs.first
+             && second == rhs.second && k == rhs.k;
+    }
+  };
+
+  struct CacheKeyHash
+  {
+    std::size_t
+    operator() (const CacheKey &key) const noexcept
+    {
+      std::size_t hash = static_cast<std::size_t> (key.operation);
+      hash = hash * 0x9e3779b97f4a7c15ULL + key.first;
+      hash = hash * 0x9e3779b97f4a7c15ULL + key.second;
+      hash = hash * 0x9e3779b97f4a7c15ULL + key.k;
+      return hash ^ (hash >> 29);
+    }
+  };
+
+  std::vector<ZddNode> _nodeVector = {};
+  std::unordered_map<ZddNode, unsigned int, ZddNodeHash> _uniqueTable = {};
+  std::unordered_map<CacheKey, unsigned int, CacheKeyHash> _computedCache
+      = {};
+  std::size_t _cacheLimit = 1 << 22;
+
+  /**
+   * @brief Returns the node (variable, low, high), creating it if it does not
+   * exist. Nodes whose high child is the empty family are suppressed.
+   *
+   * @param variable
+   * @param low
+   * @param high
+   * @return unsigned int
+   */
+  unsigned int makeNode (unsigned int variable, unsigned int low,
+                         unsigned int high);
+
+  /**
+   * @brief Looks up the computed cache. Returns @c true and sets @c result on
+   * a hit.
+   *
+   * @param key
+   * @param result
+   * @return boolean
+   */
+  bool lookupCache (const CacheKey &key, unsigned int &result) const;
+
+  /**
+   * @brief Stores a result in the computed cache, clearing it first if it has
+   * reached its size limit.
+   *
+   * @param key
+   * @param result
+   */
+  void insertCache (const CacheKey &key, unsigned int result);
+};
+
+#endif
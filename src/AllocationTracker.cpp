@@ -0,0 +1,330 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/AllocationTracker.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+namespace
+{
+
+// Tags 0 and 1 stand for "no phase" and "no subsystem"
+const unsigned int NoPhaseTag = 0;
+const unsigned int NoSubsystemTag = 1;
+
+// Counters are plain arrays of atomics with static storage, so they are
+// zero-initialized before any allocation happens
+struct Counters
+{
+  std::atomic<std::uint64_t> allocations;
+  std::atomic<std::uint64_t> bytes;
+  std::atomic<std::uint64_t> liveBytes;
+  std::atomic<std::uint64_t> peakLiveBytes;
+};
+
+Counters tagCounters[AllocationTracker::MaxTags];
+Counters totalCounters;
+const char *tagNames[AllocationTracker::MaxTags]
+    = { "(no phase)", "(no subsystem)" };
+AllocationTracker::TagKind tagKinds[AllocationTracker::MaxTags]
+    = { AllocationTracker::TagKind::Phase,
+        AllocationTracker::TagKind::Subsystem };
+std::atomic<unsigned int> numTags (2);
+std::mutex registrationMutex;
+
+thread_local unsigned int currentPhaseTag = NoPhaseTag;
+thread_local unsigned int currentSubsystemTag = NoSubsystemTag;
+
+void
+chargeAllocation (Counters &counters, std::size_t size) noexcept
+{
+  counters.allocations.fetch_add (1, std::memory_order_relaxed);
+  counters.bytes.fetch_add (size, std::memory_order_relaxed);
+  std::uint64_t live
+      = counters.liveBytes.fetch_add (size, std::memory_order_relaxed) + size;
+  std::uint64_t peak = counters.peakLiveBytes.load (std::memory_order_relaxed);
+  while (live > peak
+         && !counters.peakLiveBytes.compare_exchange_weak (
+             peak, live, std::memory_order_relaxed))
+    ;
+}
+
+AllocationTracker::Statistics
+readCounters (const Counters &counters) noexcept
+{
+  AllocationTracker::Statistics statistics;
+  statistics.allocations = counters.allocations.load ();
+  statistics.bytes = counters.bytes.load ();
+  statistics.liveBytes = counters.liveBytes.load ();
+  statistics.peakLiveBytes = counters.peakLiveBytes.load ();
+  return statistics;
+}
+
+void
+printStatistics (std::ostream &os, const char *name,
+                 const AllocationTracker::Statistics &statistics)
+{
+  os << std::left << std::setw (24) << name << std::right << std::setw (14)
+     << statistics.allocations << std::setw (16) << statistics.bytes
+     << std::setw (16) << statistics.peakLiveBytes << std::endl;
+}
+
+} // namespace
+
+bool
+AllocationTracker::isEnabled () noexcept
+{
+#ifdef TMAP_ALLOCATION_TRACKING
+  return true;
+#else
+  return false;
+#endif
+}
+
+unsigned int
+AllocationTracker::registerTag (const char *name, TagKind kind)
+{
+  std::lock_guard<std::mutex> lock (registrationMutex);
+  unsigned int tagCount = numTags.load ();
+  for (unsigned int tag = 0; tag < tagCount; tag++)
+    if (tagKinds[tag] == kind && std::strcmp (tagNames[tag], name) == 0)
+      return tag;
+  if (tagCount == MaxTags)
+    throw std::overflow_error (
+        "Runtime error (registerTag): maximum number of allocation tags "
+        "reached.");
+  tagNames[tagCount] = name;
+  tagKinds[tagCount] = kind;
+  numTags.store (tagCount + 1);
+  return tagCount;
+}
+
+AllocationTracker::TagKind
+AllocationTracker::getTagKind (unsigned int tag)
+{
+  if (tag >= numTags.load ())
+    throw std::runtime_error (
+        "Runtime error (getTagKind): the allocation tag is not registered.");
+  return tagKinds[tag];
+}
+
+unsigned int
+AllocationTracker::getCurrentTag (TagKind kind) noexcept
+{
+  return kind == TagKind::Phase ? currentPhaseTag : currentSubsystemTag;
+}
+
+void
+AllocationTracker::setCurrentTag (unsigned int tag)
+{
+  if (getTagKind (tag) == TagKind::Phase)
+    currentPhaseTag = tag;
+  else
+    currentSubsystemTag = tag;
+}
+
+AllocationTracker::Statistics
+AllocationTracker::getStatistics (unsigned int tag)
+{
+  if (tag >= numTags.load ())
+    throw std::runtime_error (
+        "Runtime error (getStatistics): the allocation tag is not "
+        "registered.");
+  return readCounters (tagCounters[tag]);
+}
+
+AllocationTracker::Statistics
+AllocationTracker::getTotalStatistics () noexcept
+{
+  return readCounters (totalCounters);
+}
+
+void
+AllocationTracker::print (std::ostream &os)
+{
+  os << ">> Allocations" << std::endl;
+  if (!isEnabled ())
+    {
+      os << "# Allocation tracking is disabled (configure with "
+            "-DTMAP_ALLOCATION_TRACKING=ON)"
+         << std::endl;
+      return;
+    }
+
+  // Snapshot the statistics before printing, since printing allocates
+  unsigned int tagCount = numTags.load ();
+  Statistics statistics[MaxTags];
+  for (unsigned int tag = 0; tag < tagCount; tag++)
+    statistics[tag] = getStatistics (tag);
+  Statistics totalStatistics = getTotalStatistics ();
+
+  for (TagKind kind : { TagKind::Phase, TagKind::Subsystem })
+    {
+      os << std::left << std::setw (24)
+         << (kind == TagKind::Phase ? "Phase" : "Subsystem") << std::right
+         << std::setw (14) << "Allocations" << std::setw (16) << "Bytes"
+         << std::setw (16) << "Peak live" << std::endl;
+      for (unsigned int tag = 0; tag < tagCount; tag++)
+        if (tagKinds[tag] == kind && statistics[tag].allocations > 0)
+          printStatistics (os, tagNames[tag], statistics[tag]);
+    }
+  printStatistics (os, "Total", totalStatistics);
+}
+
+void
+AllocationTracker::recordAllocation (std::size_t size, unsigned int phaseTag,
+                                     unsigned int subsystemTag) noexcept
+{
+  chargeAllocation (tagCounters[phaseTag], size);
+  chargeAllocation (tagCounters[subsystemTag], size);
+  chargeAllocation (totalCounters, size);
+}
+
+void
+AllocationTracker::recordRelease (std::size_t size, unsigned int phaseTag,
+                                  unsigned int subsystemTag) noexcept
+{
+  tagCounters[phaseTag].liveBytes.fetch_sub (size, std::memory_order_relaxed);
+  tagCounters[subsystemTag].liveBytes.fetch_sub (size,
+                                                 std::memory_order_relaxed);
+  totalCounters.liveBytes.fetch_sub (size, std::memory_order_relaxed);
+}
+
+AllocationScope::AllocationScope (unsigned int tag)
+    : _previousTag (
+        AllocationTracker::getCurrentTag (AllocationTracker::getTagKind (tag)))
+{
+  AllocationTracker::setCurrentTag (tag);
+}
+
+AllocationScope::~AllocationScope ()
+{
+  AllocationTracker::setCurrentTag (_previousTag);
+}
+
+#ifdef TMAP_ALLOCATION_TRACKING
+
+namespace
+{
+
+// Every tracked block starts with a header that records its size and tags.
+// The header keeps the alignment of the block returned by std::malloc
+struct alignas (alignof (std::max_align_t)) AllocationHeader
+{
+  std::size_t size;
+  unsigned int phaseTag;
+  unsigned int subsystemTag;
+};
+
+void *
+trackedAllocate (std::size_t size) noexcept
+{
+  void *block = std::malloc (sizeof (AllocationHeader) + size);
+  if (block == nullptr)
+    return nullptr;
+  AllocationHeader *header = static_cast<AllocationHeader *> (block);
+  header->size = size;
+  header->phaseTag = currentPhaseTag;
+  header->subsystemTag = currentSubsystemTag;
+  AllocationTracker::recordAllocation (size, header->phaseTag,
+                                       header->subsystemTag);
+  return header + 1;
+}
+
+void
+trackedRelease (void *pointer) noexcept
+{
+  if (pointer == nullptr)
+    return;
+  AllocationHeader *header = static_cast<AllocationHeader *> (pointer) - 1;
+  AllocationTracker::recordRelease (header->size, header->phaseTag,
+                                    header->subsystemTag);
+  std::free (header);
+}
+
+void *
+trackedAllocateOrThrow (std::size_t size)
+{
+  void *pointer = trackedAllocate (size);
+  if (pointer == nullptr)
+    throw std::bad_alloc ();
+  return pointer;
+}
+
+} // namespace
+
+void *
+operator new (std::size_t size)
+{
+  return trackedAllocateOrThrow (size);
+}
+
+void *
+operator new[] (std::size_t size)
+{
+  return trackedAllocateOrThrow (size);
+}
+
+void *
+operator new (std::size_t size, const std::nothrow_t &) noexcept
+{
+  return trackedAllocate (size);
+}
+
+void *
+operator new[] (std::size_t size, const std::nothrow_t &) noexcept
+{
+  return trackedAllocate (size);
+}
+
+void
+operator delete (void *pointer) noexcept
+{
+  trackedRelease (pointer);
+}
+
+void
+operator delete[] (void *pointer) noexcept
+{
+  trackedRelease (pointer);
+}
+
+void
+operator delete (void *pointer, std::size_t) noexcept
+{
+  trackedRelease (pointer);
+}
+
+void
+operator delete[] (void *pointer, std::size_t) noexcept
+{
+  trackedRelease (pointer);
+}
+
+void
+operator delete (void *pointer, const std::nothrow_t &) noexcept
+{
+  trackedRelease (pointer);
+}
+
+void
+operator delete[] (void *pointer, const std::nothrow_t &) noexcept
+{
+  trackedRelease (pointer);
+}
+
+#endif
@@ -10,9 +10,74 @@
 
 #include "../include/AndInverterGraph.h"
 
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <sstream>
+#include <type_traits>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+// Snapshot layout: a SnapshotHeader followed by the sections it points to,
+// each aligned to SnapshotAlignment bytes. Integers are in the byte order of
+// the machine that wrote the snapshot
+const char SnapshotMagic[8] = { 'T', 'M', 'A', 'P', 'S', 'N', 'A', 'P' };
+const std::uint32_t SnapshotByteOrderMark = 0x01020304;
+const std::uint64_t SnapshotAlignment = 64;
+
+enum SnapshotFlags : std::uint32_t
+{
+  SnapshotBinary = 1,
+  SnapshotBlif = 2,
+  SnapshotNamedInputs = 4,
+  SnapshotNamedLatches = 8,
+  SnapshotNamedOutputs = 16,
+  SnapshotComments = 32
+};
+
+struct SnapshotHeader
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byteOrderMark;
+  std::uint32_t andNodeSize;
+  std::uint32_t latchNodeSize;
+  std::uint32_t maxVariableIndex;
+  std::uint32_t numInputs;
+  std::uint32_t numLatches;
+  std::uint32_t numOutputs;
+  std::uint32_t numAnds;
+  std::uint32_t flags;
+  std::uint32_t reserved;
+  std::uint64_t andOffset;
+  std::uint64_t latchOffset;
+  std::uint64_t outputOffset;
+  std::uint64_t symbolOffset;
+  std::uint64_t symbolSize;
+  std::uint64_t numComments;
+  std::uint64_t fileSize;
+};
+
+// Nodes are used in place, so they must be plain arrays of integers
+static_assert (std::is_trivially_copyable<AndNode>::value
+                   && std::is_trivially_copyable<LatchNode>::value,
+               "Snapshots require trivially copyable nodes");
+
+std::uint64_t
+alignSnapshotOffset (std::uint64_t offset)
+{
+  return (offset + SnapshotAlignment - 1) / SnapshotAlignment
+         * SnapshotAlignment;
+}
+}
 
 AndInverterGraph::AndInverterGraph (const std::string &filePath)
 {
@@ -26,16 +91,10 @@ AndInverterGraph::AndInverterGraph (const std::string &filePath)
   _outputLiteralVector.clear ();
   _andVector.clear ();
   _latchVector.clear ();
-  _inputNameVector.clear ();
-  _latchNameVector.clear ();
-  _outputNameVector.clear ();
-  _commentVector.clear ();
-  _hasNamedInputs = false;
-  _hasNamedLatches = false;
-  _hasNamedOutputs = false;
-  _hasComments = false;
+  _symbolOffset = -1;
   _initialized = false;
   _isBinary = false;
+  _isBlif = false;
   unsigned int lineNumber = 0;
 
   // Opens the input file
@@ -45,6 +104,35 @@ AndInverterGraph::AndInverterGraph (const std::string &filePath)
     throw std::runtime_error ("Unable to open '" + filePath + "'");
   _filePath = filePath;
 
+  // BLIF netlists are recognized by their extension, since the format has no
+  // magic header
+  const std::string blifExtension = ".blif";
+  if (filePath.size () > blifExtension.size ()
+      && filePath.compare (filePath.size () - blifExtension.size (),
+                           blifExtension.size (), blifExtension)
+             == 0)
+    {
+      initializeFromBlif (inputFile);
+      _andNodes = _andVector.data ();
+      _latchNodes = _latchVector.data ();
+      _initialized = true;
+      return;
+    }
+
+  // Snapshots are recognized by their magic number
+  char magic[sizeof (SnapshotMagic)] = {};
+  inputFile.read (magic, sizeof (magic));
+  if (inputFile.gcount () == sizeof (magic)
+      && std::memcmp (magic, SnapshotMagic, sizeof (magic)) == 0)
+    {
+      inputFile.close ();
+      initializeFromSnapshot (filePath);
+      _initialized = true;
+      return;
+    }
+  inputFile.clear ();
+  inputFile.seekg (0);
+
   // Gets a line
   std::string buf;
   std::getline (inputFile, buf);
@@ -451,116 +539,11 @@ AndInverterGraph::AndInverterGraph (const std::string &filePath)
         _latchVector[latchVectorIndexFromLiteral (rhs1Literal)].incFanout ();
     }
 
-  // Saves named inputs, latches and outputs and comments
-  while (std::getline (inputFile, buf))
-    {
-      // Saves comments
-      if (_hasComments)
-        {
-          _commentVector.push_back (buf);
-        }
-
-      // Input, output and latch processing
-      else
-        {
-          // Indicate that the comment section started
-          if (buf[0] == 'c')
-            _hasComments = true;
-
-          // Input label processing
-          if (buf[0] == 'i')
-            {
-              try
-                {
-                  if (!_hasNamedInputs)
-                    _inputNameVector.reserve (_numInputs);
-                  _hasNamedInputs = true;
-                  std::stringstream ss (buf);
-                  std::getline (ss, buf, ' ');
-                  unsigned int inum = std::stoul (buf.substr (1));
-                  if (inum > _inputNameVector.size ())
-                    throw std::exception ();
-                  std::getline (ss, buf, ' ');
-                  _inputNameVector.push_back (buf);
-                }
-              catch (const std::exception &e)
-                {
-                  throw std::runtime_error (
-                      "In " + filePath + ": error reading input symbols.");
-                }
-            }
-
-          // Latch label processing
-          if (buf[0] == 'l')
-            {
-              try
-                {
-                  if (!_hasNamedLatches)
-                    _latchNameVector.reserve (_numLatches);
-                  _hasNamedLatches = true;
-                  std::stringstream ss (buf);
-                  std::getline (ss, buf, ' ');
-                  unsigned int lnum = std::stoul (buf.substr (1));
-                  if (lnum > _latchNameVector.size ())
-                    throw std::exception ();
-                  std::getline (ss, buf, ' ');
-                  _latchNameVector.push_back (buf);
-                }
-              catch (const std::exception &e)
-                {
-                  throw std::runtime_error (
-                      "In " + filePath + ": error reading latch symbols.");
-                }
-            }
-
-          // Output label processing
-          if (buf[0] == 'o')
-            {
-              try
-                {
-                  if (!_hasNamedOutputs)
-                    _outputNameVector.reserve (_numOutputs);
-                  _hasNamedOutputs = true;
-                  std::stringstream ss (buf);
-                  std::getline (ss, buf, ' ');
-                  unsigned int onum = std::stoul (buf.substr (1));
-                  if (onum > _outputNameVector.size ())
-                    throw std::exception ();
-                  std::getline (ss, buf, ' ');
-                  _outputNameVector.push_back (buf);
-                }
-              catch (const std::exception &e)
-                {
-                  throw std::runtime_error (
-                      "In " + filePath + ": error reading output symbols.");
-                }
-            }
-        }
-    }
-
-  // Integrity check
-  if (_hasNamedInputs && _inputNameVector.size () != _numInputs)
-    throw std::runtime_error ("Incomplete specified input symbols. AIG has "
-                              + std::to_string (_numInputs)
-                              + " inputs but only "
-                              + std::to_string (_inputNameVector.size ())
-                              + " input symbols were declared.");
-
-  // Integrity check
-  if (_hasNamedLatches && _latchNameVector.size () != _numLatches)
-    throw std::runtime_error ("Incomplete specified latch symbols. AIG has "
-                              + std::to_string (_numLatches)
-                              + " latches but only "
-                              + std::to_string (_latchNameVector.size ())
-                              + " latch symbols were declared.");
-
-  // Integrity check
-  if (_hasNamedOutputs && _outputNameVector.size () != _numOutputs)
-    throw std::runtime_error ("Incomplete specified output symbols. AIG has "
-                              + std::to_string (_numOutputs)
-                              + " outputs but only "
-                              + std::to_string (_outputNameVector.size ())
-                              + " output symbols declared.");
+  // The symbol table and comments are only parsed when needed (see
+  // loadSymbolTable()); their position in the file is kept
+  std::streamoff symbolOffset = inputFile.tellg ();
+  if (symbolOffset >= 0)
+    _symbolOffset = symbolOffset;
 
   // Updates the fanout of output latches, ANDs and next state literals
   for (const auto &outputLiteral : _outputLiteralVector)
@@ -588,9 +571,396 @@ AndInverterGraph::AndInverterGraph (const std::string &filePath)
   delete nextQLiterals;
 
   // Sets the AndInverterGraph object as initialized
+  _andNodes = _andVector.data ();
+  _latchNodes = _latchVector.data ();
+  _initialized = true;
+}
+
+AndInverterGraph::AndInverterGraph (
+    const std::string &name, unsigned int numInputs,
+    const std::vector<std::pair<unsigned int, unsigned int>> &andChildVector,
+    const std::vector<unsigned int> &outputLiteralVector)
+{
+  _filePath = name;
+  _numInputs = numInputs;
+  _numAnds = andChildVector.size ();
+  _numOutputs = outputLiteralVector.size ();
+  _maxVariableIndex = _numInputs + _numAnds;
+  _andVector.reserve (_numAnds);
+  for (unsigned int i = 0; i < _numAnds; i++)
+    {
+      auto [rhs0Literal, rhs1Literal] = andChildVector[i];
+      unsigned int andLiteral = literalFromAndVectorIndex (i);
+      if (rhs0Literal < rhs1Literal || andLiteral <= rhs0Literal
+          || rhs1Literal < 2)
+        throw std::runtime_error (
+            "Runtime error (AndInverterGraph): and-node "
+            + std::to_string (andLiteral) + " of " + name
+            + " does not comply with AIGER specification.");
+      _andVector.emplace_back (rhs0Literal, rhs1Literal, 0);
+      if (nodeIsAnd (rhs0Literal))
+        _andVector[andVectorIndexFromLiteral (rhs0Literal)].incFanout ();
+      if (nodeIsAnd (rhs1Literal))
+        _andVector[andVectorIndexFromLiteral (rhs1Literal)].incFanout ();
+    }
+  for (const auto &outputLiteral : outputLiteralVector)
+    {
+      if (outputLiteral > literalFromIndex (_maxVariableIndex) + 1)
+        throw std::runtime_error ("Runtime error (AndInverterGraph): output "
+                                  + std::to_string (outputLiteral) + " of "
+                                  + name + " is not a node literal.");
+      if (nodeIsAnd (outputLiteral))
+        _andVector[andVectorIndexFromLiteral (outputLiteral)].incFanout ();
+      _outputLiteralVector.push_back (outputLiteral);
+    }
+  _andNodes = _andVector.data ();
+  _latchNodes = _latchVector.data ();
   _initialized = true;
 }
 
+void
+AndInverterGraph::initializeFromBlif (std::ifstream &inputFile)
+{
+  _isBlif = true;
+  const std::string &filePath = _filePath;
+
+  // A .names statement: its fanin nets, the net it drives and the input part
+  // of each cube of its single-output cover
+  struct BlifNames
+  {
+    std::vector<std::string> fanins;
+    std::string output;
+    std::vector<std::string> cubes;
+    char outputValue = '1';
+  };
+
+  std::vector<std::string> inputNames;
+  std::vector<std::string> outputNames;
+  std::vector<std::pair<std::string, std::string> > latchNets; // (D, Q)
+  std::vector<BlifNames> namesVector;
+  std::unordered_map<std::string, std::size_t> namesDriver;
+
+  // Reads logical lines: comments are stripped and lines ending with '\' are
+  // joined with the following one
+  unsigned int lineNumber = 0;
+  bool modelStarted = false;
+  bool readingCover = false;
+  std::string buf;
+  std::string line;
+  while (std::getline (inputFile, buf))
+    {
+      lineNumber++;
+      if (!buf.empty () && buf.back () == '\r')
+        buf.pop_back ();
+      std::size_t commentStart = buf.find ('#');
+      if (commentStart != std::string::npos)
+        buf.erase (commentStart);
+      if (!buf.empty () && buf.back () == '\\')
+        {
+          buf.pop_back ();
+          line += buf + " ";
+          continue;
+        }
+      line += buf;
+
+      std::vector<std::string> tokens;
+      std::stringstream ss (line);
+      std::string token;
+      while (ss >> token)
+        tokens.push_back (token);
+      line.clear ();
+      if (tokens.empty ())
+        continue;
+
+      // Cube of the last .names statement
+      if (tokens[0][0] != '.')
+        {
+          if (!readingCover)
+            throw std::runtime_error (
+                "In " + filePath + ": unexpected cube at line "
+                + std::to_string (lineNumber)
+                + " outside a .names statement.");
+          BlifNames &names = namesVector.back ();
+          std::string inputPart = names.fanins.empty () ? "" : tokens[0];
+          std::string outputPart
+              = names.fanins.empty () ? tokens[0]
+                                      : (tokens.size () > 1 ? tokens[1] : "");
+          if (tokens.size () != (names.fanins.empty () ? 1 : 2)
+              || inputPart.size () != names.fanins.size ()
+              || inputPart.find_first_not_of ("01-") != std::string::npos
+              || (outputPart != "0" && outputPart != "1"))
+            throw std::runtime_error ("In " + filePath + ": malformed cube at "
+                                      + "line " + std::to_string (lineNumber));
+          if (names.cubes.empty ())
+            names.outputValue = outputPart[0];
+          else if (names.outputValue != outputPart[0])
+            throw std::runtime_error (
+                "In " + filePath + ": cover of net '" + names.output
+                + "' mixes on-set and off-set cubes at line "
+                + std::to_string (lineNumber));
+          names.cubes.push_back (inputPart);
+          continue;
+        }
+
+      readingCover = false;
+      const std::string &keyword = tokens[0];
+      if (keyword == ".model")
+        {
+          // Only the first model is read
+          if (modelStarted)
+            break;
+          modelStarted = true;
+        }
+      else if (keyword == ".end")
+        break;
+      else if (keyword == ".inputs")
+        inputNames.insert (inputNames.end (), tokens.begin () + 1,
+                           tokens.end ());
+      else if (keyword == ".outputs")
+        outputNames.insert (outputNames.end (), tokens.begin () + 1,
+                            tokens.end ());
+      else if (keyword == ".latch")
+        {
+          // .latch <input> <output> [<type> <control>] [<init-val>]
+          if (tokens.size () < 3 || tokens.size () > 6)
+            throw std::runtime_error ("In " + filePath
+                                      + ": malformed .latch at line "
+                                      + std::to_string (lineNumber));
+          latchNets.emplace_back (tokens[1], tokens[2]);
+        }
+      else if (keyword == ".names")
+        {
+          if (tokens.size () < 2)
+            throw std::runtime_error ("In " + filePath
+                                      + ": malformed .names at line "
+                                      + std::to_string (lineNumber));
+          BlifNames names;
+          names.fanins.assign (tokens.begin () + 1, tokens.end () - 1);
+          names.output = tokens.back ();
+          if (!namesDriver.emplace (names.output, namesVector.size ()).second)
+            throw std::runtime_error ("In " + filePath + ": net '"
+                                      + names.output
+                                      + "' has more than one driver (line "
+                                      + std::to_string (lineNumber) + ").");
+          namesVector.push_back (names);
+          readingCover = true;
+        }
+      else if (keyword == ".subckt" || keyword == ".gate"
+               || keyword == ".mlatch" || keyword == ".exdc"
+               || keyword == ".search")
+        throw std::runtime_error ("In " + filePath + ": " + keyword
+                                  + " at line " + std::to_string (lineNumber)
+                                  + " is not supported. Flatten the netlist "
+                                    "before mapping.");
+      // Other commands (.clock, .area, .delay, ...) carry no logic
+    }
+
+  // Inputs and latches are the sources of the graph. Their literals are
+  // assigned before any and-node, as in AIGER
+  _numInputs = inputNames.size ();
+  _numLatches = latchNets.size ();
+  _numOutputs = outputNames.size ();
+  std::unordered_map<std::string, unsigned int> sourceLiterals;
+  for (unsigned int i = 0; i < _numInputs; i++)
+    if (!sourceLiterals.emplace (inputNames[i], literalFromIndex (i + 1))
+             .second)
+      throw std::runtime_error ("In " + filePath + ": input '" + inputNames[i]
+                                + "' declared more than once.");
+  for (unsigned int i = 0; i < _numLatches; i++)
+    if (!sourceLiterals
+             .emplace (latchNets[i].second,
+                       literalFromIndex (_numInputs + i + 1))
+             .second)
+      throw std::runtime_error ("In " + filePath + ": latch output '"
+                                + latchNets[i].second
+                                + "' is also an input or another latch.");
+  for (const auto &names : namesVector)
+    if (sourceLiterals.count (names.output))
+      throw std::runtime_error ("In " + filePath + ": net '" + names.output
+                                + "' is driven by .names but is also an input "
+                                  "or a latch output.");
+
+  // Creates an and-node, or reuses an existing one with the same children.
+  // Children are ordered so that rhs0 >= rhs1, and constants and trivial
+  // cases are folded so that no and-node is tied to FALSE or TRUE
+  unsigned int firstAndVariable = _numInputs + _numLatches + 1;
+  std::unordered_map<unsigned long long, unsigned int> strashTable;
+  auto createAnd = [&] (unsigned int rhs0, unsigned int rhs1) {
+    if (rhs0 < rhs1)
+      std::swap (rhs0, rhs1);
+    if (rhs1 == 0 || rhs0 == (rhs1 ^ 1))
+      return 0u;
+    if (rhs1 == 1 || rhs0 == rhs1)
+      return rhs0;
+    unsigned long long key = ((unsigned long long)rhs0 << 32) | rhs1;
+    auto found = strashTable.find (key);
+    if (found != strashTable.end ())
+      return found->second;
+    unsigned int andLiteral
+        = literalFromIndex (firstAndVariable + _andVector.size ());
+    _andVector.push_back (AndNode (rhs0, rhs1));
+    strashTable.emplace (key, andLiteral);
+    return andLiteral;
+  };
+
+  // Balanced and-tree over a list of literals, keeping the depth of wide
+  // cubes and covers logarithmic
+  auto createAndTree = [&] (std::vector<unsigned int> &literals) {
+    if (literals.empty ())
+      return 1u;
+    while (literals.size () > 1)
+      {
+        std::vector<unsigned int> nextLevel;
+        nextLevel.reserve ((literals.size () + 1) / 2);
+        for (std::size_t i = 0; i + 1 < literals.size (); i += 2)
+          nextLevel.push_back (createAnd (literals[i], literals[i + 1]));
+        if (literals.size () % 2 == 1)
+          nextLevel.push_back (literals.back ());
+        literals.swap (nextLevel);
+      }
+    return literals[0];
+  };
+
+  // Resolves the literal of a net, building the and-nodes of every .names
+  // statement in its transitive fanin. An explicit stack is used so that
+  // deep netlists do not overflow the call stack
+  enum : unsigned char
+  {
+    NotVisited,
+    InProgress,
+    Done
+  };
+  std::vector<unsigned char> namesState (namesVector.size (), NotVisited);
+  std::vector<unsigned int> namesLiteral (namesVector.size (), 0);
+  auto findDriver = [&] (const std::string &net) {
+    auto driver = namesDriver.find (net);
+    if (driver == namesDriver.end ())
+      throw std::runtime_error ("In " + filePath + ": net '" + net
+                                + "' has no driver.");
+    return driver->second;
+  };
+  auto resolveNet = [&] (const std::string &net) {
+    auto source = sourceLiterals.find (net);
+    if (source != sourceLiterals.end ())
+      return source->second;
+
+    std::size_t rootNames = findDriver (net);
+    std::vector<std::size_t> processingStack = { rootNames };
+    while (!processingStack.empty ())
+      {
+        std::size_t current = processingStack.back ();
+        if (namesState[current] == Done)
+          {
+            processingStack.pop_back ();
+            continue;
+          }
+        namesState[current] = InProgress;
+
+        // Put off the current statement until all fanins are resolved
+        bool faninsResolved = true;
+        for (const auto &fanin : namesVector[current].fanins)
+          {
+            if (sourceLiterals.count (fanin))
+              continue;
+            std::size_t faninNames = findDriver (fanin);
+            if (namesState[faninNames] == InProgress)
+              throw std::runtime_error ("In " + filePath
+                                        + ": combinational loop through net '"
+                                        + fanin + "'.");
+            if (namesState[faninNames] == NotVisited)
+              {
+                processingStack.push_back (faninNames);
+                faninsResolved = false;
+              }
+          }
+        if (!faninsResolved)
+          continue;
+
+        // Decomposes the cover: each cube is an and-tree of its literals and
+        // the cover is the or of its cubes, i.e. the complement of the
+        // and-tree of the complemented cubes
+        const BlifNames &names = namesVector[current];
+        std::vector<unsigned int> faninLiterals;
+        faninLiterals.reserve (names.fanins.size ());
+        for (const auto &fanin : names.fanins)
+          {
+            auto source = sourceLiterals.find (fanin);
+            faninLiterals.push_back (source != sourceLiterals.end ()
+                                         ? source->second
+                                         : namesLiteral[findDriver (fanin)]);
+          }
+        std::vector<unsigned int> complementedCubes;
+        complementedCubes.reserve (names.cubes.size ());
+        for (const auto &cube : names.cubes)
+          {
+            std::vector<unsigned int> cubeLiterals;
+            for (std::size_t i = 0; i < cube.size (); i++)
+              if (cube[i] != '-')
+                cubeLiterals.push_back (faninLiterals[i]
+                                        ^ (cube[i] == '0' ? 1 : 0));
+            complementedCubes.push_back (createAndTree (cubeLiterals) ^ 1);
+          }
+        unsigned int coverLiteral
+            = names.cubes.empty () ? 0
+                                   : createAndTree (complementedCubes) ^ 1;
+        if (names.outputValue == '0')
+          coverLiteral ^= 1;
+
+        namesLiteral[current] = coverLiteral;
+        namesState[current] = Done;
+        processingStack.pop_back ();
+      }
+
+    return namesLiteral[rootNames];
+  };
+
+  // Builds the logic of outputs and next state functions
+  _outputLiteralVector.reserve (_numOutputs);
+  for (const auto &outputName : outputNames)
+    _outputLiteralVector.push_back (resolveNet (outputName));
+  _latchVector.reserve (_numLatches);
+  for (const auto &latch : latchNets)
+    {
+      unsigned int nextQLiteral = resolveNet (latch.first);
+      if (nextQLiteral < 2)
+        throw std::runtime_error ("In " + filePath + ": latch '" + latch.second
+                                  + "' tied to logic FALSE (0) or TRUE (1). "
+                                    "Constant latches are not supported.");
+      _latchVector.push_back (LatchNode (nextQLiteral));
+    }
+  _numAnds = _andVector.size ();
+  _maxVariableIndex = _numInputs + _numLatches + _numAnds;
+
+  // Updates the fanout of child nodes, outputs and next state literals
+  auto incFanout = [&] (unsigned int literal) {
+    if (nodeIsAnd (literal))
+      _andVector[andVectorIndexFromLiteral (literal)].incFanout ();
+    else if (nodeIsLatch (literal))
+      _latchVector[latchVectorIndexFromLiteral (literal)].incFanout ();
+  };
+  for (const auto &andNode : _andVector)
+    {
+      incFanout (andNode.getFirstChild ());
+      incFanout (andNode.getSecondChild ());
+    }
+  for (const auto &outputLiteral : _outputLiteralVector)
+    incFanout (outputLiteral);
+  for (const auto &latch : _latchVector)
+    incFanout (latch.getNextQ ());
+
+  // Saves the symbols, which are already parsed
+  std::call_once (_symbolTableLoaded, [&] {
+    for (const auto &inputName : inputNames)
+      _symbolTable.inputNames.push_back (_symbolTable.pool.intern (inputName));
+    for (const auto &latch : latchNets)
+      _symbolTable.latchNames.push_back (
+          _symbolTable.pool.intern (latch.second));
+    for (const auto &outputName : outputNames)
+      _symbolTable.outputNames.push_back (
+          _symbolTable.pool.intern (outputName));
+  });
+}
+
 bool
 AndInverterGraph::successfullyInitialized () const noexcept
 {
@@ -670,11 +1040,11 @@ AndInverterGraph::getAndNodeFromLiteral (const unsigned int &andLiteral) const
   unsigned int andVectorIndex
       = nodeVariableIndex - _numInputs - _numLatches - 1;
 
-  if (andVectorIndex >= _andVector.size ())
+  if (andVectorIndex >= _numAnds)
     throw std::runtime_error (
         "getAndNodeFromLiteral() : andVectorIndex out of range");
 
-  return _andVector.at (andVectorIndex);
+  return _andNodes[andVectorIndex];
 }
 
 const LatchNode &
@@ -688,11 +1058,11 @@ AndInverterGraph::getLatchNodeFromLiteral (
   unsigned int nodeVariableIndex = indexFromLiteral (latchLiteral);
   unsigned int latchVectorIndex = nodeVariableIndex - _numInputs - 1;
 
-  if (latchVectorIndex >= _latchVector.size ())
+  if (latchVectorIndex >= _numLatches)
     throw std::runtime_error (
         "getLatchNodeFromLiteral() : latchVectorIndex out of range");
 
-  return _latchVector.at (latchVectorIndex);
+  return _latchNodes[latchVectorIndex];
 }
 
 unsigned int
@@ -761,6 +1131,420 @@ AndInverterGraph::getFirstLatchLiteral () const noexcept
   return literalFromIndex (0 + _numInputs + 1);
 }
 
+bool
+AndInverterGraph::isSnapshot () const noexcept
+{
+  return _isSnapshot;
+}
+
+void
+AndInverterGraph::saveSnapshot (const std::string &filePath,
+                                bool includeSymbols) const
+{
+  // Symbols are stored as strings prefixed by their length
+  std::string symbols;
+  const SymbolTable &symbolTable = getSymbolTable ();
+  auto appendSymbols = [&] (const std::vector<unsigned int> &nameIds) {
+    for (const auto &nameId : nameIds)
+      {
+        std::string_view name = symbolTable.pool.getString (nameId);
+        std::uint32_t length = name.size ();
+        symbols.append (reinterpret_cast<const char *> (&length),
+                        sizeof (length));
+        symbols.append (name);
+      }
+  };
+
+  SnapshotHeader header = {};
+  std::memcpy (header.magic, SnapshotMagic, sizeof (SnapshotMagic));
+  header.version = SnapshotVersion;
+  header.byteOrderMark = SnapshotByteOrderMark;
+  header.andNodeSize = sizeof (AndNode);
+  header.latchNodeSize = sizeof (LatchNode);
+  header.maxVariableIndex = _maxVariableIndex;
+  header.numInputs = _numInputs;
+  header.numLatches = _numLatches;
+  header.numOutputs = _numOutputs;
+  header.numAnds = _numAnds;
+  header.flags = (_isBinary ? std::uint32_t (SnapshotBinary) : 0)
+                 | (_isBlif ? std::uint32_t (SnapshotBlif) : 0);
+  if (includeSymbols)
+    {
+      if (!symbolTable.inputNames.empty ())
+        {
+          header.flags |= SnapshotNamedInputs;
+          appendSymbols (symbolTable.inputNames);
+        }
+      if (!symbolTable.latchNames.empty ())
+        {
+          header.flags |= SnapshotNamedLatches;
+          appendSymbols (symbolTable.latchNames);
+        }
+      if (!symbolTable.outputNames.empty ())
+        {
+          header.flags |= SnapshotNamedOutputs;
+          appendSymbols (symbolTable.outputNames);
+        }
+      if (!symbolTable.comments.empty ())
+        {
+          header.flags |= SnapshotComments;
+          header.numComments = symbolTable.comments.size ();
+          appendSymbols (symbolTable.comments);
+        }
+    }
+  header.andOffset = alignSnapshotOffset (sizeof (SnapshotHeader));
+  header.latchOffset
+      = alignSnapshotOffset (header.andOffset + _numAnds * sizeof (AndNode));
+  header.outputOffset = alignSnapshotOffset (
+      header.latchOffset + _numLatches * sizeof (LatchNode));
+  header.symbolOffset = alignSnapshotOffset (
+      header.outputOffset + _numOutputs * sizeof (std::uint32_t));
+  header.symbolSize = symbols.size ();
+  header.fileSize = header.symbolOffset + header.symbolSize;
+
+  std::ofstream outputFile (filePath, std::ios::binary | std::ios::out
+                                          | std::ios::trunc);
+  if (!outputFile.is_open ())
+    throw std::runtime_error ("Unable to open '" + filePath
+                              + "' for writing.");
+  auto writeSection = [&outputFile] (std::uint64_t offset, const void *data,
+                                     std::uint64_t size) {
+    std::uint64_t position = outputFile.tellp ();
+    std::string padding (offset - position, '\0');
+    outputFile.write (padding.data (), padding.size ());
+    outputFile.write (static_cast<const char *> (data), size);
+  };
+  std::vector<std::uint32_t> outputs (_outputLiteralVector.begin (),
+                                      _outputLiteralVector.end ());
+  writeSection (0, &header, sizeof (header));
+  writeSection (header.andOffset, _andNodes, _numAnds * sizeof (AndNode));
+  writeSection (header.latchOffset, _latchNodes,
+                _numLatches * sizeof (LatchNode));
+  writeSection (header.outputOffset, outputs.data (),
+                outputs.size () * sizeof (std::uint32_t));
+  writeSection (header.symbolOffset, symbols.data (), symbols.size ());
+  outputFile.close ();
+  if (outputFile.fail ())
+    throw std::runtime_error ("Failed to write the snapshot '" + filePath
+                              + "'.");
+}
+
+void
+AndInverterGraph::initializeFromSnapshot (const std::string &filePath)
+{
+  // Map the whole file; the mapping lives as long as _snapshotData
+  int fileDescriptor = open (filePath.c_str (), O_RDONLY);
+  if (fileDescriptor < 0)
+    throw std::runtime_error ("Unable to open '" + filePath + "'");
+  struct stat fileStatus;
+  if (fstat (fileDescriptor, &fileStatus) != 0
+      || fileStatus.st_size < static_cast<off_t> (sizeof (SnapshotHeader)))
+    {
+      close (fileDescriptor);
+      throw std::runtime_error ("Unable to read '" + filePath
+                                + "'. Truncated snapshot.");
+    }
+  std::size_t fileSize = fileStatus.st_size;
+  void *mapping
+      = mmap (nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+  close (fileDescriptor);
+  if (mapping == MAP_FAILED)
+    throw std::runtime_error ("Unable to map '" + filePath + "' into memory.");
+  _snapshotData = std::shared_ptr<const char> (
+      static_cast<const char *> (mapping),
+      [fileSize] (const char *data) {
+        munmap (const_cast<char *> (data), fileSize);
+      });
+
+  // Integrity checks: format and bounds of the sections
+  const SnapshotHeader &header
+      = *reinterpret_cast<const SnapshotHeader *> (_snapshotData.get ());
+  if (header.version != SnapshotVersion)
+    throw std::runtime_error (
+        "Unable to read '" + filePath + "'. Snapshot version "
+        + std::to_string (header.version) + " is not supported (expected "
+        + std::to_string (SnapshotVersion) + ").");
+  if (header.byteOrderMark != SnapshotByteOrderMark
+      || header.andNodeSize != sizeof (AndNode)
+      || header.latchNodeSize != sizeof (LatchNode))
+    throw std::runtime_error ("Unable to read '" + filePath
+                              + "'. The snapshot was written by a machine "
+                                "with another byte order or node layout.");
+  // A section fits if it ends before the next one starts; written as a
+  // difference, so that corrupted offsets cannot overflow
+  auto fitsBefore
+      = [] (std::uint64_t offset, std::uint64_t size, std::uint64_t end) {
+          return offset <= end && size <= end - offset;
+        };
+  if (header.fileSize != fileSize
+      || !fitsBefore (header.andOffset, header.numAnds * sizeof (AndNode),
+                      header.latchOffset)
+      || !fitsBefore (header.latchOffset,
+                      header.numLatches * sizeof (LatchNode),
+                      header.outputOffset)
+      || !fitsBefore (header.outputOffset,
+                      header.numOutputs * sizeof (std::uint32_t),
+                      header.symbolOffset)
+      || !fitsBefore (header.symbolOffset, header.symbolSize, fileSize)
+      || header.andOffset % SnapshotAlignment != 0
+      || header.latchOffset % SnapshotAlignment != 0
+      || header.outputOffset % SnapshotAlignment != 0)
+    throw std::runtime_error ("Unable to read '" + filePath
+                              + "'. Truncated or corrupted snapshot.");
+  if (header.maxVariableIndex
+      != std::uint64_t (header.numInputs) + header.numLatches
+             + header.numAnds)
+    throw std::runtime_error (
+        "Invalid checksum for '" + filePath
+        + "'. The sum of the number of inputs, latches and and-nodes must be "
+          "equal to the maximum variable index.");
+
+  _isSnapshot = true;
+  _isBinary = header.flags & SnapshotBinary;
+  _isBlif = header.flags & SnapshotBlif;
+  _maxVariableIndex = header.maxVariableIndex;
+  _numInputs = header.numInputs;
+  _numLatches = header.numLatches;
+  _numOutputs = header.numOutputs;
+  _numAnds = header.numAnds;
+  _andNodes = reinterpret_cast<const AndNode *> (_snapshotData.get ()
+                                                 + header.andOffset);
+  _latchNodes = reinterpret_cast<const LatchNode *> (_snapshotData.get ()
+                                                     + header.latchOffset);
+  const std::uint32_t *outputs = reinterpret_cast<const std::uint32_t *> (
+      _snapshotData.get () + header.outputOffset);
+  _outputLiteralVector.assign (outputs, outputs + _numOutputs);
+
+  // Integrity checks: the literals are used as indices, so they get the same
+  // checks as when parsing an AIGER file
+  if (_maxVariableIndex >= (std::numeric_limits<unsigned int>::max () >> 1))
+    throw std::runtime_error ("Unable to read '" + filePath
+                              + "'. Too many variables in snapshot.");
+  unsigned int maxLiteral = literalFromIndex (_maxVariableIndex) + 1;
+  for (unsigned int i = 0; i < _numAnds; i++)
+    {
+      unsigned int andLiteral = literalFromAndVectorIndex (i);
+      unsigned int rhs0Literal = _andNodes[i].getFirstChild ();
+      unsigned int rhs1Literal = _andNodes[i].getSecondChild ();
+      if (rhs0Literal < rhs1Literal || andLiteral <= rhs0Literal
+          || rhs1Literal < 2)
+        throw std::runtime_error (
+            "Unable to read '" + filePath + "'. And-node "
+            + std::to_string (andLiteral)
+            + " does not comply with AIGER specification.");
+    }
+  for (unsigned int i = 0; i < _numLatches; i++)
+    {
+      unsigned int nextQLiteral = _latchNodes[i].getNextQ ();
+      if (nextQLiteral < 2 || nextQLiteral > maxLiteral)
+        throw std::runtime_error (
+            "Unable to read '" + filePath + "'. Unexpected next Q literal "
+            + std::to_string (nextQLiteral) + " of latch "
+            + std::to_string (literalFromLatchVectorIndex (i)));
+    }
+  for (const auto &outputLiteral : _outputLiteralVector)
+    if (outputLiteral > maxLiteral)
+      throw std::runtime_error ("Unable to read '" + filePath
+                                + "'. Unexpected output literal "
+                                + std::to_string (outputLiteral));
+
+  // Symbols are decoded when needed (see loadSymbolTable())
+  _symbolOffset = header.symbolOffset;
+  _snapshotSymbolSize = header.symbolSize;
+  _snapshotNumComments = header.numComments;
+  _snapshotFlags = header.flags;
+}
+
+std::string_view
+AndInverterGraph::getInputName (unsigned int inputIndex) const
+{
+  const SymbolTable &symbolTable = getSymbolTable ();
+  if (symbolTable.inputNames.empty ())
+    return {};
+  return symbolTable.pool.getString (symbolTable.inputNames.at (inputIndex));
+}
+
+std::string_view
+AndInverterGraph::getLatchName (unsigned int latchIndex) const
+{
+  const SymbolTable &symbolTable = getSymbolTable ();
+  if (symbolTable.latchNames.empty ())
+    return {};
+  return symbolTable.pool.getString (symbolTable.latchNames.at (latchIndex));
+}
+
+std::string_view
+AndInverterGraph::getOutputName (unsigned int outputIndex) const
+{
+  const SymbolTable &symbolTable = getSymbolTable ();
+  if (symbolTable.outputNames.empty ())
+    return {};
+  return symbolTable.pool.getString (
+      symbolTable.outputNames.at (outputIndex));
+}
+
+std::vector<std::string_view>
+AndInverterGraph::getComments () const
+{
+  const SymbolTable &symbolTable = getSymbolTable ();
+  std::vector<std::string_view> comments;
+  comments.reserve (symbolTable.comments.size ());
+  for (const auto &commentId : symbolTable.comments)
+    comments.push_back (symbolTable.pool.getString (commentId));
+  return comments;
+}
+
+const AndInverterGraph::SymbolTable &
+AndInverterGraph::getSymbolTable () const
+{
+  std::call_once (_symbolTableLoaded, [this] {
+    // A failed attempt leaves nothing behind, so that it can be retried
+    try
+      {
+        loadSymbolTable ();
+      }
+    catch (...)
+      {
+        _symbolTable.pool.clear ();
+        _symbolTable.inputNames.clear ();
+        _symbolTable.latchNames.clear ();
+        _symbolTable.outputNames.clear ();
+        _symbolTable.comments.clear ();
+        throw;
+      }
+  });
+  return _symbolTable;
+}
+
+void
+AndInverterGraph::loadSymbolTable () const
+{
+  if (_symbolOffset < 0)
+    return;
+  if (_isSnapshot)
+    loadSnapshotSymbolTable ();
+  else
+    loadAigerSymbolTable ();
+
+  // Integrity check
+  if (!_symbolTable.inputNames.empty ()
+      && _symbolTable.inputNames.size () != _numInputs)
+    throw std::runtime_error (
+        "Incomplete specified input symbols. AIG has "
+        + std::to_string (_numInputs) + " inputs but only "
+        + std::to_string (_symbolTable.inputNames.size ())
+        + " input symbols were declared.");
+  if (!_symbolTable.latchNames.empty ()
+      && _symbolTable.latchNames.size () != _numLatches)
+    throw std::runtime_error (
+        "Incomplete specified latch symbols. AIG has "
+        + std::to_string (_numLatches) + " latches but only "
+        + std::to_string (_symbolTable.latchNames.size ())
+        + " latch symbols were declared.");
+  if (!_symbolTable.outputNames.empty ()
+      && _symbolTable.outputNames.size () != _numOutputs)
+    throw std::runtime_error (
+        "Incomplete specified output symbols. AIG has "
+        + std::to_string (_numOutputs) + " outputs but only "
+        + std::to_string (_symbolTable.outputNames.size ())
+        + " output symbols were declared.");
+}
+
+void
+AndInverterGraph::loadAigerSymbolTable () const
+{
+  std::ifstream inputFile (_filePath, std::ios::binary | std::ios::in);
+  if (!inputFile.is_open ())
+    throw std::runtime_error ("Unable to open '" + _filePath + "'");
+  inputFile.seekg (_symbolOffset);
+
+  // Symbols are "i<index> <name>", "l<index> <name>" and "o<index> <name>",
+  // in increasing index order. The comment section starts with "c" and
+  // takes the rest of the file
+  std::string line;
+  bool inComments = false;
+  while (std::getline (inputFile, line))
+    {
+      if (inComments)
+        {
+          _symbolTable.comments.push_back (_symbolTable.pool.intern (line));
+          continue;
+        }
+      if (line.empty ())
+        continue;
+      if (line[0] == 'c')
+        {
+          inComments = true;
+          continue;
+        }
+
+      std::vector<unsigned int> *nameIds = nullptr;
+      std::string kind;
+      if (line[0] == 'i')
+        nameIds = &_symbolTable.inputNames, kind = "input";
+      else if (line[0] == 'l')
+        nameIds = &_symbolTable.latchNames, kind = "latch";
+      else if (line[0] == 'o')
+        nameIds = &_symbolTable.outputNames, kind = "output";
+      else
+        continue;
+      try
+        {
+          std::size_t space = line.find (' ');
+          if (space == std::string::npos)
+            throw std::exception ();
+          unsigned int index = std::stoul (line.substr (1, space - 1));
+          if (index > nameIds->size ())
+            throw std::exception ();
+          std::size_t nameEnd = line.find (' ', space + 1);
+          nameIds->push_back (_symbolTable.pool.intern (
+              std::string_view (line).substr (space + 1,
+                                              nameEnd == std::string::npos
+                                                  ? std::string::npos
+                                                  : nameEnd - space - 1)));
+        }
+      catch (const std::exception &e)
+        {
+          throw std::runtime_error ("In " + _filePath + ": error reading "
+                                    + kind + " symbols.");
+        }
+    }
+}
+
+void
+AndInverterGraph::loadSnapshotSymbolTable () const
+{
+  const char *symbol = _snapshotData.get () + _symbolOffset;
+  const char *symbolEnd = symbol + _snapshotSymbolSize;
+  auto readSymbols = [&] (std::vector<unsigned int> &nameIds,
+                          std::uint64_t count) {
+    nameIds.reserve (count);
+    for (std::uint64_t i = 0; i < count; i++)
+      {
+        std::uint32_t length;
+        if (symbolEnd - symbol < static_cast<long> (sizeof (length)))
+          throw std::runtime_error ("Unable to read '" + _filePath
+                                    + "'. Truncated snapshot symbols.");
+        std::memcpy (&length, symbol, sizeof (length));
+        symbol += sizeof (length);
+        if (symbolEnd - symbol < static_cast<long> (length))
+          throw std::runtime_error ("Unable to read '" + _filePath
+                                    + "'. Truncated snapshot symbols.");
+        nameIds.push_back (
+            _symbolTable.pool.intern (std::string_view (symbol, length)));
+        symbol += length;
+      }
+  };
+  if (_snapshotFlags & SnapshotNamedInputs)
+    readSymbols (_symbolTable.inputNames, _numInputs);
+  if (_snapshotFlags & SnapshotNamedLatches)
+    readSymbols (_symbolTable.latchNames, _numLatches);
+  if (_snapshotFlags & SnapshotNamedOutputs)
+    readSymbols (_symbolTable.outputNames, _numOutputs);
+  if (_snapshotFlags & SnapshotComments)
+    readSymbols (_symbolTable.comments, _snapshotNumComments);
+}
+
 void
 AndInverterGraph::print (std::ostream &os) const
 {
@@ -773,7 +1557,11 @@ operator<< (std::ostream &os, const AndInverterGraph &aig)
   os << ">> Start of AIG information." << std::endl;
   os << std::endl;
 
-  if (aig._isBinary)
+  if (aig._isSnapshot)
+    os << "Input format: tmap snapshot" << std::endl;
+  else if (aig._isBlif)
+    os << "Input format: BLIF" << std::endl;
+  else if (aig._isBinary)
     os << "AIGER format: binary" << std::endl;
   else
     os << "AIGER format: ASCII" << std::endl;
@@ -793,7 +1581,7 @@ operator<< (std::ostream &os, const AndInverterGraph &aig)
   os << "Latches: " << std::endl;
   for (int i = 0; i < aig._numLatches; i++)
     os << aig.literalFromLatchVectorIndex (i) << " "
-       << aig._latchVector.at (i).getNextQ () << " " << std::endl;
+       << aig._latchNodes[i].getNextQ () << " " << std::endl;
 
   os << std::endl;
   os << "Outputs: " << std::endl;
@@ -804,32 +1592,29 @@ operator<< (std::ostream &os, const AndInverterGraph &aig)
   os << "And nodes: " << std::endl;
   for (int i = 0; i < aig._numAnds; i++)
     os << aig.literalFromAndVectorIndex (i) << " "
-       << aig._andVector.at (i).getFirstChild () << " "
-       << aig._andVector.at (i).getSecondChild () << " " << std::endl;
+       << aig._andNodes[i].getFirstChild () << " "
+       << aig._andNodes[i].getSecondChild () << " " << std::endl;
 
   os << std::endl;
+  const AndInverterGraph::SymbolTable &symbolTable = aig.getSymbolTable ();
   os << "Input names (if any):" << std::endl;
-  if (aig._hasNamedInputs)
-    for (const auto &inputName : aig._inputNameVector)
-      os << inputName << std::endl;
+  for (const auto &inputName : symbolTable.inputNames)
+    os << symbolTable.pool.getString (inputName) << std::endl;
 
   os << std::endl;
   os << "Latch names (if any):" << std::endl;
-  if (aig._hasNamedLatches)
-    for (const auto &latchName : aig._latchNameVector)
-      os << latchName << std::endl;
+  for (const auto &latchName : symbolTable.latchNames)
+    os << symbolTable.pool.getString (latchName) << std::endl;
 
   os << std::endl;
   os << "Output names (if any):" << std::endl;
-  if (aig._hasNamedOutputs)
-    for (const auto &outputName : aig._outputNameVector)
-      os << outputName << std::endl;
+  for (const auto &outputName : symbolTable.outputNames)
+    os << symbolTable.pool.getString (outputName) << std::endl;
 
   os << std::endl;
   os << "Comments (if any):" << std::endl;
-  if (aig._hasComments)
-    for (const auto &comment : aig._commentVector)
-      os << comment << std::endl;
+  for (const auto &comment : symbolTable.comments)
+    os << symbolTable.pool.getString (comment) << std::endl;
 
   os << std::endl;
   os << ">> End of AIG information." << std::endl;
@@ -882,7 +1667,7 @@ AndInverterGraph::literalFromLatchVectorIndex (
 {
   unsigned int latchLiteral
       = literalFromIndex (latchVectorIndex + _numInputs + 1);
-  if (latchLiteral > literalFromIndex (_numInputs + 1))
+  if (latchVectorIndex >= _numLatches)
     throw std::runtime_error (
         "Runtime error. " + std::to_string (latchLiteral)
         + " is not a valid latch literal for the given AIG.");
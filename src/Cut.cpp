@@ -10,6 +10,8 @@
 
 #include "../include/Cut.h"
 
+#include <iterator>
+
 Cut::Cut (std::set<unsigned int> nodeVariables, unsigned int areaCost,
           unsigned int delayCost, unsigned int powerCost)
 {
@@ -97,6 +99,54 @@ Cut::unsetPowerCost () noexcept
   _powerCost = -1;
 }
 
+void
+Cut::setTruthTable (const TruthTable &truthTable)
+{
+  if (truthTable.getNumVariables () != _nodeVariables.size ())
+    throw std::runtime_error ("The truth table of a cut must have one "
+                              "variable per node variable of the cut.");
+  _truthTable = truthTable;
+}
+
+const TruthTable &
+Cut::getTruthTable () const noexcept
+{
+  return _truthTable;
+}
+
+bool
+Cut::hasTruthTable () const noexcept
+{
+  return !_truthTable.isEmpty ();
+}
+
+unsigned int
+Cut::removeVacuousVariables ()
+{
+  if (!hasTruthTable ())
+    throw std::runtime_error ("Vacuous variables can only be removed from "
+                              "cuts with a truth table.");
+
+  // Walk the variables from the last to the first, so that removing one does
+  // not renumber the variables still to be tested
+  unsigned int numRemoved = 0;
+  unsigned int variable = _nodeVariables.size ();
+  for (auto it = _nodeVariables.rbegin (); it != _nodeVariables.rend ();)
+    {
+      variable--;
+      if (_truthTable.dependsOn (variable))
+        {
+          ++it;
+          continue;
+        }
+      _truthTable.removeVariable (variable);
+      it = std::make_reverse_iterator (
+          _nodeVariables.erase (std::next (it).base ()));
+      numRemoved++;
+    }
+  return numRemoved;
+}
+
 bool
 Cut::isEmptyCut () const noexcept
 {
@@ -162,6 +212,8 @@ operator<< (std::ostream &os, const Cut &cut)
 
   os << " : area = " << cut._areaCost << " : delay = " << cut._delayCost
      << " : power = " << cut._powerCost;
+  if (cut.hasTruthTable ())
+    os << " : function = " << cut._truthTable;
 
   return os;
 }
@@ -0,0 +1,90 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/CutArena.h"
+#include "../include/NumaTopology.h"
+
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+CutArena::CutArena (unsigned int numaNode)
+    : _numaNode (numaNode), _chunkResource (numaNode),
+      _arena (InitialChunkSize, &_chunkResource)
+{
+}
+
+std::pmr::memory_resource *
+CutArena::getResource () noexcept
+{
+  return &_arena;
+}
+
+unsigned int
+CutArena::getNumaNode () const noexcept
+{
+  return _numaNode;
+}
+
+void
+CutArena::release ()
+{
+  _arena.release ();
+}
+
+CutArena::ChunkResource::ChunkResource (unsigned int numaNode)
+    : _numaNode (numaNode)
+{
+#ifdef __linux__
+  _bindChunks = NumaTopology::getNumNodes () > 1;
+#endif
+}
+
+void *
+CutArena::ChunkResource::do_allocate (std::size_t bytes, std::size_t alignment)
+{
+#ifdef __linux__
+  // Mapped chunks are page aligned, and their pages are placed on the node
+  // when first touched by the worker
+  if (_bindChunks)
+    {
+      void *chunk = mmap (nullptr, bytes, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (chunk == MAP_FAILED)
+        throw std::bad_alloc ();
+      NumaTopology::bindMemory (chunk, bytes, _numaNode);
+      return chunk;
+    }
+#endif
+  return ::operator new (bytes, std::align_val_t (alignment));
+}
+
+void
+CutArena::ChunkResource::do_deallocate (void *chunk, std::size_t bytes,
+                                        std::size_t alignment)
+{
+#ifdef __linux__
+  if (_bindChunks)
+    {
+      munmap (chunk, bytes);
+      return;
+    }
+#endif
+  ::operator delete (chunk, bytes, std::align_val_t (alignment));
+}
+
+bool
+CutArena::ChunkResource::do_is_equal (
+    const std::pmr::memory_resource &other) const noexcept
+{
+  return this == &other;
+}
@@ -9,13 +9,24 @@
  */
 
 #include "../include/CutEngine.h"
+#include "../include/AllocationTracker.h"
+#include "../include/CutLeafSet.h"
+#include "../include/CutTrie.h"
+#include "../include/NumaTopology.h"
+#include "../include/WorkerPool.h"
 
 #include <algorithm>
+#include <atomic>
+#include <new>
 #include <stack>
+#include <thread>
+#include <unordered_map>
 
-CutEngine::CutEngine (const AndInverterGraph &aig, MappingGoal mappingGoal,
-                      unsigned int k, unsigned int c)
-    : _aig (aig), _k (k), _c (c), _mappingGoal (mappingGoal)
+template <typename ObserverPolicy>
+CutEngineBase<ObserverPolicy>::CutEngineBase (const AndInverterGraph &aig,
+                                              MappingGoal mappingGoal,
+                                              unsigned int k, unsigned int c)
+    : _mappingGoal (mappingGoal), _aig (aig), _k (k), _c (c)
 {
   // Integrity check
   if (_k < 2)
@@ -26,15 +37,26 @@ CutEngine::CutEngine (const AndInverterGraph &aig, MappingGoal mappingGoal,
   // Memory allocation and vector initialization
   try
     {
-      _cutSetVector.clear ();
-      _cutSetVector.reserve (_aig.getNumAnds ());
-      _cutSetVector.insert (_cutSetVector.begin (), _aig.getNumAnds (), {});
+      TMAP_ALLOCATION_SUBSYSTEM ("cut sets");
+      unsigned int firstNumaNode = NumaTopology::getNodes ().front ();
+      _cutSetVector = std::vector<std::atomic<CutSet *>> (_aig.getNumAnds ());
+      for (auto &cutSet : _cutSetVector)
+        cutSet.store (nullptr, std::memory_order_relaxed);
+      _arenaVector.push_back (std::make_unique<CutArena> (firstNumaNode));
+      _selectedCutVector.assign (_aig.getNumAnds (), Cut ());
+
+      // Fanout estimates start at a single sink per net, so the first cover
+      // is the one of the unit delay model
+      _fanoutEstimateVector.assign (_aig.getMaxVariableIndex () + 1, 1);
       unsigned int firstAndVariable
           = AndInverterGraph::indexFromLiteral (_aig.getFirstAndLiteral ());
       unsigned int lastAndVariable = firstAndVariable + _aig.getNumAnds ();
       for (int i = firstAndVariable; i < lastAndVariable; i++)
-        _implementationMap.emplace (AndInverterGraph::literalFromIndex (i),
-                                    false);
+        {
+          TMAP_ALLOCATION_SUBSYSTEM ("implementation map");
+          unsigned int andLiteral = AndInverterGraph::literalFromIndex (i);
+          _implementationMap.emplace (andLiteral, false);
+        }
     }
   catch (const std::exception &e)
     {
@@ -44,8 +66,16 @@ CutEngine::CutEngine (const AndInverterGraph &aig, MappingGoal mappingGoal,
     }
 }
 
+template <typename ObserverPolicy>
+CutEngineBase<ObserverPolicy>::~CutEngineBase ()
+{
+  clearCutSets ();
+}
+
+template <typename ObserverPolicy>
 bool
-CutEngine::cutAreaComparision (const Cut &cutA, const Cut &cutB)
+CutEngineBase<ObserverPolicy>::cutAreaComparision (const Cut &cutA,
+                                                   const Cut &cutB)
 {
   if (cutA.getAreaCost () < cutB.getAreaCost ())
     return true;
@@ -60,8 +90,10 @@ CutEngine::cutAreaComparision (const Cut &cutA, const Cut &cutB)
     return false;
 }
 
+template <typename ObserverPolicy>
 bool
-CutEngine::cutDelayComparision (const Cut &cutA, const Cut &cutB)
+CutEngineBase<ObserverPolicy>::cutDelayComparision (const Cut &cutA,
+                                                    const Cut &cutB)
 {
   if (cutA.getDelayCost () < cutB.getDelayCost ())
     return true;
@@ -77,9 +109,11 @@ CutEngine::cutDelayComparision (const Cut &cutA, const Cut &cutB)
     return false;
 }
 
+template <typename ObserverPolicy>
 CutSet
-CutEngine::sortAndChooseBestCuts (const CutSet &cutSet, const unsigned int &c,
-                                  MappingGoal mappingGoal)
+CutEngineBase<ObserverPolicy>::sortAndChooseBestCuts (const CutSet &cutSet,
+                                                      const unsigned int &c,
+                                                      MappingGoal mappingGoal)
 {
   // Create a new CutSet object for the best cuts and copies cutSet to it
   CutSet bestCuts = cutSet;
@@ -99,8 +133,10 @@ CutEngine::sortAndChooseBestCuts (const CutSet &cutSet, const unsigned int &c,
   return bestCuts;
 }
 
+template <typename ObserverPolicy>
 CutSet
-CutEngine::sortCutSet (const CutSet &cutSet, MappingGoal mappingGoal)
+CutEngineBase<ObserverPolicy>::sortCutSet (const CutSet &cutSet,
+                                           MappingGoal mappingGoal)
 {
   // Create a new CutSet object for the best cuts and copies cutSet to it
   CutSet bestCuts = cutSet;
@@ -116,78 +152,133 @@ CutEngine::sortCutSet (const CutSet &cutSet, MappingGoal mappingGoal)
   return bestCuts;
 }
 
+template <typename ObserverPolicy>
 CutSet
-CutEngine::diamondOperation (const unsigned int &andLiteral,
-                             const CutSet &cutSetA, const CutSet &cutSetB,
-                             const unsigned int &k)
+CutEngineBase<ObserverPolicy>::diamondOperation (
+    const unsigned int &andLiteral, const CutSet &cutSetA,
+    const CutSet &cutSetB, const unsigned int &k)
 {
   // Initialize a new CutSet
   CutSet diamond = {};
 
-  // Diamond operation
-  // Note: operation + is not the traditional sum.
-  // For a Cut object, operator + evaluates the union of two cuts
+  // The leaves of the cuts are combined as bitsets over the window of
+  // variables below the root (see CutLeafSet), so that the union is an OR and
+  // its size a popcount. The cuts with a leaf outside the window fall back to
+  // sorted arrays
+  unsigned int windowBase = CutLeafSet::windowBaseOf (
+      AndInverterGraph::indexFromLiteral (andLiteral));
+  std::vector<CutLeafSet> leafSetsA, leafSetsB;
+  leafSetsA.reserve (cutSetA.size ());
+  leafSetsB.reserve (cutSetB.size ());
   for (const auto &cutA : cutSetA)
+    leafSetsA.emplace_back (cutA.getVariableSet (), windowBase);
+  for (const auto &cutB : cutSetB)
+    leafSetsB.emplace_back (cutB.getVariableSet (), windowBase);
+
+  // The unions found are indexed by a trie over their sorted leaves, so that
+  // a union already found is a walk down one path instead of a comparison
+  // with every union. The leaves of each union are written into one buffer,
+  // so that only the new unions allocate
+  CutTrie diamondTrie;
+  std::vector<unsigned int> unionLeaves;
+  unionLeaves.reserve (k);
+
+  // Diamond operation: the union of every pair of cuts
+  std::pmr::vector<Cut> *diamondCuts = &diamond;
+  for (std::size_t a = 0; a < cutSetA.size (); a++)
     {
-      for (const auto &cutB : cutSetB)
+      for (std::size_t b = 0; b < cutSetB.size (); b++)
         {
           // Evaluate the union of cutA and cutB
-          Cut unionCut = cutA + cutB;
+          CutLeafSet unionLeafSet = leafSetsA[a] | leafSetsB[b];
 
           // All cuts whose number of variables is greater than k must be
           // discarded
-          if (unionCut.numNodeVariables () > k)
+          if (unionLeafSet.size () > k)
             continue;
 
           // Check if cutA and cutB have valid values for area, delay
           // and power costs
+          const Cut &cutA = cutSetA[a];
+          const Cut &cutB = cutSetB[b];
           if (!cutA.allCostsSet () || !cutB.allCostsSet ())
             throw std::runtime_error ("The cost of the union of two cuts can "
                                       "only be evaluated if the "
                                       "two cuts have their costs for area, "
                                       "delay and power defined.");
 
-          // Add to diamond set
-          auto result = diamond.emplace (unionCut);
-          auto autoCutIterator = result.first;
-          auto wasNotInTheSet = result.second;
+          // Add to diamond set. A union already in the set keeps the costs
+          // of the pair that found it first
+          unionLeafSet.toSortedArray (unionLeaves);
+          if (!diamondTrie.insert (unionLeaves, diamondCuts->size ()).second)
+            continue;
+          Cut unionCut (std::set<unsigned int> (unionLeaves.begin (),
+                                                unionLeaves.end ()));
 
-          if (wasNotInTheSet)
-            {
-              // Evaluate area cost for the union cut
-              unsigned int unionCutAreaCost
-                  = estimateUnionCutAreaCost (andLiteral, unionCut);
+          // Evaluate area cost for the union cut
+          unsigned int unionCutAreaCost
+              = estimateUnionCutAreaCost (andLiteral, unionCut);
 
-              // Evaluate delay cost for the union cut
-              unsigned int unionCutDelayCost
-                  = estimateUnionCutDelayCost (cutA, cutB);
+          // Evaluate delay cost for the union cut
+          unsigned int unionCutDelayCost
+              = estimateUnionCutDelayCost (cutA, cutB);
 
-              // Assign zero to power cost for the union cut
-              unsigned int unionCutPowerCost = 0;
+          // Assign zero to power cost for the union cut
+          unsigned int unionCutPowerCost = 0;
 
-              // Set the costs of the unionCut
-              autoCutIterator->setAreaCost (unionCutAreaCost);
-              autoCutIterator->setDelayCost (unionCutDelayCost);
-              autoCutIterator->setPowerCost (unionCutPowerCost);
-            }
+          // Set the costs of the unionCut
+          unionCut.setAreaCost (unionCutAreaCost);
+          unionCut.setDelayCost (unionCutDelayCost);
+          unionCut.setPowerCost (unionCutPowerCost);
+          diamondCuts->push_back (std::move (unionCut));
+        }
+    }
+
+  // A cut whose leaves are a superset of the leaves of another cut is
+  // dominated: the other cut covers the same cone with fewer leaves
+  if (_pruneDominated)
+    {
+      CutSet undominated = {};
+      std::pmr::vector<Cut> *undominatedCuts = &undominated;
+      for (auto &cut : *diamondCuts)
+        {
+          const std::set<unsigned int> &leaves = cut.getVariableSet ();
+          unionLeaves.assign (leaves.begin (), leaves.end ());
+          if (!diamondTrie.containsProperSubsetOf (unionLeaves))
+            undominatedCuts->push_back (std::move (cut));
         }
+      return undominated;
     }
 
   return diamond;
 }
 
+template <typename ObserverPolicy>
 unsigned int
-CutEngine::estimateUnionCutAreaCost (const unsigned int &andLiteral,
-                                     const Cut &unionCut) const
+CutEngineBase<ObserverPolicy>::estimateUnionCutAreaCost (
+    const unsigned int &andLiteral, const Cut &unionCut) const
 {
+  // During run(), whether a node is implemented is read as of the position
+  // of andLiteral in the order of the run (see runDepthFirst())
+  unsigned int position
+      = _positionVector.empty ()
+            ? NoPosition
+            : _positionVector[vectorIndexFromAndLiteral (andLiteral)];
+  auto isImplemented = [&] (unsigned int nodeLiteral) {
+    if (position == NoPosition)
+      return _implementationMap.at (nodeLiteral);
+    unsigned int i = vectorIndexFromAndLiteral (nodeLiteral);
+    return position
+           < _unimplementedFromVector[i].load (std::memory_order_relaxed);
+  };
+
   // Count the number of unimplemented and-nodes in the union cut
   std::set<unsigned int> unimplementedNodes = {};
   for (const auto &nodeIndex : unionCut)
     {
       unsigned int nodeLiteral
           = AndInverterGraph::literalFromIndex (nodeIndex);
-      if (_aig.nodeIsAnd (nodeLiteral)
-          && _implementationMap.at (nodeLiteral) == false)
+      if (_aig.nodeIsAnd (nodeLiteral) && !isImplemented (nodeLiteral))
         unimplementedNodes.emplace (nodeLiteral);
     }
 
@@ -195,35 +286,53 @@ CutEngine::estimateUnionCutAreaCost (const unsigned int &andLiteral,
   return unimplementedNodes.size ();
 }
 
+template <typename ObserverPolicy>
 unsigned int
-CutEngine::estimateUnionCutDelayCost (const Cut &cutA, const Cut &cutB) const
+CutEngineBase<ObserverPolicy>::estimateUnionCutDelayCost (
+    const Cut &cutA, const Cut &cutB) const
 {
   return cutA.getDelayCost () >= cutB.getDelayCost () ? cutA.getDelayCost ()
                                                       : cutB.getDelayCost ();
 }
 
+template <typename ObserverPolicy>
 unsigned int
-CutEngine::estimateAutoCutAreaCost (unsigned int andLiteral) const
+CutEngineBase<ObserverPolicy>::estimateAutoCutAreaCost (
+    unsigned int andLiteral) const
 {
   const Cut &bestCut = getBestCut (andLiteral);
   return bestCut.getAreaCost ();
 }
 
+template <typename ObserverPolicy>
 unsigned int
-CutEngine::estimateAutoCutDelayCost (unsigned int andLiteral) const
+CutEngineBase<ObserverPolicy>::estimateAutoCutDelayCost (
+    unsigned int andLiteral) const
 {
   const Cut &bestCut = getBestCut (andLiteral);
-  return 1 + bestCut.getDelayCost ();
+  return bestCut.getDelayCost () + estimateNetDelay (andLiteral)
+         + _delayModel.lutDelay;
+}
+
+template <typename ObserverPolicy>
+unsigned int
+CutEngineBase<ObserverPolicy>::estimateNetDelay (
+    unsigned int nodeLiteral) const
+{
+  return _delayModel.getNetDelay (_fanoutEstimateVector.at (
+      AndInverterGraph::indexFromLiteral (nodeLiteral)));
 }
 
+template <typename ObserverPolicy>
 const AndInverterGraph &
-CutEngine::getAndInverterGraph () const noexcept
+CutEngineBase<ObserverPolicy>::getAndInverterGraph () const noexcept
 {
   return _aig;
 }
 
+template <typename ObserverPolicy>
 bool
-CutEngine::hasBestCut (unsigned int andLiteral) const
+CutEngineBase<ObserverPolicy>::hasBestCut (unsigned int andLiteral) const
 {
   if (!_aig.nodeIsAnd (andLiteral))
     throw std::runtime_error (
@@ -232,15 +341,17 @@ CutEngine::hasBestCut (unsigned int andLiteral) const
         "is not a valid and-literal for the AndInverterGraph object.");
   else
     {
-      if (_cutSetVector.at (vectorIndexFromAndLiteral (andLiteral)).empty ())
-        return false;
-      else
-        return true;
+      // Spilled cut sets keep their best cut in memory
+      const CutSet *cutSet
+          = _cutSetVector.at (vectorIndexFromAndLiteral (andLiteral))
+                .load (std::memory_order_acquire);
+      return cutSet != nullptr && !cutSet->empty ();
     }
 }
 
+template <typename ObserverPolicy>
 const CutSet &
-CutEngine::getCutSet (unsigned int andLiteral) const
+CutEngineBase<ObserverPolicy>::getCutSet (unsigned int andLiteral) const
 {
   if (!_aig.nodeIsAnd (andLiteral))
     throw std::runtime_error (
@@ -248,14 +359,27 @@ CutEngine::getCutSet (unsigned int andLiteral) const
         "is not a valid and-literal for the AndInverterGraph object.");
   else
     {
-      const CutSet &cutSet
-          = _cutSetVector.at (vectorIndexFromAndLiteral (andLiteral));
-      return cutSet;
+      unsigned int vectorIndex = vectorIndexFromAndLiteral (andLiteral);
+      const CutSet *cutSet
+          = _cutSetVector.at (vectorIndex).load (std::memory_order_acquire);
+      if (cutSet == nullptr)
+        return _emptyCutSet;
+      if (_spillOffsetVector.empty ()
+          || _spillOffsetVector[vectorIndex] == NotSpilled)
+        return *cutSet;
+      if (_spilledCutSetIndex != vectorIndex)
+        {
+          _spilledCutSet
+              = _spillFile->read (_spillOffsetVector[vectorIndex]);
+          _spilledCutSetIndex = vectorIndex;
+        }
+      return _spilledCutSet;
     }
 }
 
+template <typename ObserverPolicy>
 const Cut &
-CutEngine::getBestCut (unsigned int andLiteral) const
+CutEngineBase<ObserverPolicy>::getBestCut (unsigned int andLiteral) const
 {
   if (!_aig.nodeIsAnd (andLiteral))
     throw std::runtime_error (
@@ -264,20 +388,329 @@ CutEngine::getBestCut (unsigned int andLiteral) const
         "is not a valid and-literal for the AndInverterGraph object.");
   else
     {
-      if (_cutSetVector.at (vectorIndexFromAndLiteral (andLiteral)).empty ())
+      if (!hasBestCut (andLiteral))
         throw std::runtime_error ("Runtime error (getBestCut): the best cut "
                                   "for the and-node has not "
                                   "been defined yet. Call hasBestCut() to "
                                   "check for it before calling "
                                   "getBestCut().");
       else
-        return _cutSetVector.at (vectorIndexFromAndLiteral (andLiteral))
-            .at (0);
+        return _cutSetVector[vectorIndexFromAndLiteral (andLiteral)]
+            .load (std::memory_order_acquire)
+            ->at (0);
     }
 }
 
+template <typename ObserverPolicy>
+const Cut &
+CutEngineBase<ObserverPolicy>::getSelectedCut (unsigned int andLiteral) const
+{
+  if (!hasBestCut (andLiteral))
+    throw std::runtime_error ("Runtime error (getSelectedCut): the cuts of "
+                              "the and-node have not been found yet.");
+  return _selectedCutVector.at (vectorIndexFromAndLiteral (andLiteral));
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::setSupportReduction (
+    bool supportReduction) noexcept
+{
+  _supportReduction = supportReduction;
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::setDominancePruning (
+    bool pruneDominated) noexcept
+{
+  _pruneDominated = pruneDominated;
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::setDelayModel (const DelayModel &delayModel)
+{
+  _delayModel = delayModel;
+  reset ();
+}
+
+template <typename ObserverPolicy>
+DelayModel
+CutEngineBase<ObserverPolicy>::getDelayModel () const noexcept
+{
+  return _delayModel;
+}
+
+template <typename ObserverPolicy>
+std::vector<unsigned int>
+CutEngineBase<ObserverPolicy>::getFanoutEstimates () const
+{
+  return _fanoutEstimateVector;
+}
+
+template <typename ObserverPolicy>
+bool
+CutEngineBase<ObserverPolicy>::updateFanoutEstimates (
+    const std::vector<unsigned int> &fanoutVector)
+{
+  if (fanoutVector.size () != _fanoutEstimateVector.size ())
+    throw std::runtime_error (
+        "Runtime error (updateFanoutEstimates): the size of fanoutVector "
+        "must be the number of variables of the AndInverterGraph plus one.");
+  if (!_delayModel.dependsOnFanout ())
+    return false;
+  _fanoutEstimateVector = fanoutVector;
+  reset ();
+  return true;
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::setNumThreads (unsigned int numThreads) noexcept
+{
+  _numThreads = std::max (1u, numThreads);
+}
+
+template <typename ObserverPolicy>
+unsigned int
+CutEngineBase<ObserverPolicy>::getNumThreads () const noexcept
+{
+  return _numThreads;
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::setProgress (MappingProgress *progress) noexcept
+{
+  _progress = progress;
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::stopIfCancelled ()
+{
+  if (!_progress || !_progress->isCancelled ())
+    return;
+  reset ();
+  throw MappingCancelled (_progress->isPastDeadline ()
+                              ? "Mapping cancelled: the deadline has passed."
+                              : "Mapping cancelled.");
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::setOutOfCore (
+    unsigned int window, const std::string &scratchDirectory)
+{
+  reset ();
+  _outOfCoreWindow = window;
+  if (window == 0)
+    {
+      _spillFile.reset ();
+      _residentCutSetVector.clear ();
+      _spillOffsetVector.clear ();
+      return;
+    }
+  _spillFile = std::make_unique<CutSpillFile> (scratchDirectory);
+  _residentCutSetVector.resize (_aig.getNumAnds ());
+  _spillOffsetVector.assign (_aig.getNumAnds (), NotSpilled);
+}
+
+template <typename ObserverPolicy>
+unsigned int
+CutEngineBase<ObserverPolicy>::getOutOfCoreWindow () const noexcept
+{
+  return _outOfCoreWindow;
+}
+
+template <typename ObserverPolicy>
+std::uint64_t
+CutEngineBase<ObserverPolicy>::getNumSpilledBytes () const noexcept
+{
+  return _spillFile ? _spillFile->getNumBytes () : 0;
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::reset ()
+{
+  clearCutSets ();
+  for (auto &[node, implemented] : _implementationMap)
+    implemented = false;
+}
+
+template <typename ObserverPolicy>
+CutSet *
+CutEngineBase<ObserverPolicy>::allocateCutSet (const CutSet &cutSet,
+                                               CutArena &arena)
+{
+  // The CutSet object and its cuts are allocated from the arena
+  std::pmr::memory_resource *resource = arena.getResource ();
+  void *storage = resource->allocate (sizeof (CutSet), alignof (CutSet));
+  return new (storage) CutSet (cutSet, resource);
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::publishCutSet (unsigned int andLiteral,
+                                              CutSet *cutSet)
+{
+  unsigned int vectorIndex = vectorIndexFromAndLiteral (andLiteral);
+  CutSet *expected = nullptr;
+  if (!_cutSetVector[vectorIndex].compare_exchange_strong (
+          expected, cutSet, std::memory_order_release,
+          std::memory_order_relaxed))
+    throw std::runtime_error ("Runtime error (publishCutSet): the cut set "
+                              "of the and-node has already been published.");
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::clearCutSets ()
+{
+  // Arenas do not run destructors, so the cut sets are destroyed first.
+  // Cut sets kept in memory by the out-of-core mode are not in an arena
+  for (unsigned int i = 0; i < _cutSetVector.size (); i++)
+    {
+      CutSet *cutSet
+          = _cutSetVector[i].exchange (nullptr, std::memory_order_acquire);
+      if (!_residentCutSetVector.empty () && _residentCutSetVector[i])
+        _residentCutSetVector[i].reset ();
+      else if (cutSet != nullptr)
+        cutSet->~CutSet ();
+    }
+  for (auto &arena : _arenaVector)
+    arena->release ();
+  if (_spillFile)
+    {
+      _spillFile->clear ();
+      _spillOffsetVector.assign (_spillOffsetVector.size (), NotSpilled);
+      _spilledCutSet.clear ();
+      _spilledCutSetIndex = -1;
+    }
+}
+
+template <typename ObserverPolicy>
 CutSet
-CutEngine::phiOperation (const unsigned int &andLiteral)
+CutEngineBase<ObserverPolicy>::readCutSet (unsigned int andLiteral) const
+{
+  unsigned int vectorIndex = vectorIndexFromAndLiteral (andLiteral);
+  if (!_spillOffsetVector.empty ()
+      && _spillOffsetVector[vectorIndex] != NotSpilled)
+    return _spillFile->read (_spillOffsetVector[vectorIndex]);
+  return getCutSet (andLiteral);
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::spillCutSet (unsigned int vectorIndex)
+{
+  std::unique_ptr<CutSet> &residentCutSet
+      = _residentCutSetVector[vectorIndex];
+  _spillOffsetVector[vectorIndex] = _spillFile->write (*residentCutSet);
+
+  // The best cut stays in memory, in the arena
+  CutSet bestCut;
+  bestCut.emplace (residentCutSet->front ());
+  _cutSetVector[vectorIndex].store (
+      allocateCutSet (bestCut, *_arenaVector.front ()),
+      std::memory_order_release);
+  residentCutSet.reset ();
+}
+
+template <typename ObserverPolicy>
+TruthTable
+CutEngineBase<ObserverPolicy>::computeTruthTable (unsigned int andLiteral,
+                                                  const Cut &cut) const
+{
+  // Leaves are the variables of the table, in increasing order
+  std::unordered_map<unsigned int, TruthTable> nodeFunctions;
+  unsigned int leafPosition = 0;
+  for (const auto &leafVariable : cut)
+    nodeFunctions.emplace (
+        leafVariable,
+        TruthTable::nthVariable (cut.numNodeVariables (), leafPosition++));
+
+  // Simulate the and-nodes of the cone in post-order
+  auto literalFunction = [&] (unsigned int literal) {
+    const TruthTable &function
+        = nodeFunctions.at (AndInverterGraph::indexFromLiteral (literal));
+    return literal % 2 == 1 ? ~function : function;
+  };
+  unsigned int rootVariable = AndInverterGraph::indexFromLiteral (andLiteral);
+  std::stack<unsigned int> processingStack;
+  processingStack.push (rootVariable);
+  while (!processingStack.empty ())
+    {
+      unsigned int currentVariable = processingStack.top ();
+      if (nodeFunctions.count (currentVariable))
+        {
+          processingStack.pop ();
+          continue;
+        }
+      unsigned int currentLiteral
+          = AndInverterGraph::literalFromIndex (currentVariable);
+      if (!_aig.nodeIsAnd (currentLiteral))
+        throw std::runtime_error (
+            "Runtime error (computeTruthTable): the leaves of the cut do not "
+            "separate the and-node from the inputs.");
+      const AndNode &an = _aig.getAndNodeFromLiteral (currentLiteral);
+      unsigned int firstChildVariable
+          = AndInverterGraph::indexFromLiteral (an.getFirstChild ());
+      unsigned int secondChildVariable
+          = AndInverterGraph::indexFromLiteral (an.getSecondChild ());
+      if (!nodeFunctions.count (firstChildVariable))
+        processingStack.push (firstChildVariable);
+      else if (!nodeFunctions.count (secondChildVariable))
+        processingStack.push (secondChildVariable);
+      else
+        {
+          nodeFunctions.emplace (currentVariable,
+                                 literalFunction (an.getFirstChild ())
+                                     & literalFunction (an.getSecondChild ()));
+          processingStack.pop ();
+        }
+    }
+
+  return nodeFunctions.at (rootVariable);
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::selectCut (unsigned int andLiteral,
+                                          const Cut &bestCut)
+{
+  TMAP_ALLOCATION_SUBSYSTEM ("cut selection");
+  Cut selectedCut = bestCut;
+  if (_supportReduction && _k <= TruthTable::MaxVariables)
+    {
+      selectedCut.setTruthTable (computeTruthTable (andLiteral, selectedCut));
+      selectedCut.removeVacuousVariables ();
+
+      // The output of a lookup table is available one lut delay after the
+      // latest of its leaves arrives
+      unsigned int latestArrival = 0;
+      for (const auto &leafVariable : selectedCut)
+        {
+          unsigned int leafLiteral
+              = AndInverterGraph::literalFromIndex (leafVariable);
+          unsigned int leafArrival = estimateNetDelay (leafLiteral);
+          if (_aig.nodeIsAnd (leafLiteral))
+            leafArrival += getSelectedCut (leafLiteral).getDelayCost ();
+          latestArrival = std::max (latestArrival, leafArrival);
+        }
+      selectedCut.setDelayCost (latestArrival + _delayModel.lutDelay);
+    }
+  Cut &storedCut
+      = _selectedCutVector.at (vectorIndexFromAndLiteral (andLiteral));
+  storedCut = selectedCut;
+  this->notifyCutSelected (andLiteral, storedCut);
+}
+
+template <typename ObserverPolicy>
+CutSet
+CutEngineBase<ObserverPolicy>::phiOperation (const unsigned int &andLiteral)
 {
   // Throw an exception if the value provided in andLiteral is not a valid AND
   // node literal
@@ -288,8 +721,8 @@ CutEngine::phiOperation (const unsigned int &andLiteral)
 
   // If andLiteral has its cut set already defined, do nothing: simply return
   // the cut set
-  if (!getCutSet (andLiteral).empty ())
-    return _cutSetVector.at (vectorIndexFromAndLiteral (andLiteral));
+  if (hasBestCut (andLiteral))
+    return readCutSet (andLiteral);
 
   // Get child node literals
   const AndNode &an = _aig.getAndNodeFromLiteral (andLiteral);
@@ -298,22 +731,22 @@ CutEngine::phiOperation (const unsigned int &andLiteral)
 
   // If any of the child nodes are also and-nodes, check whether Phi operation
   // was called for them
-  if ((_aig.nodeIsAnd (firstChildLiteral)
-       && getCutSet (firstChildLiteral).empty ())
+  if ((_aig.nodeIsAnd (firstChildLiteral) && !hasBestCut (firstChildLiteral))
       || (_aig.nodeIsAnd (secondChildLiteral)
-          && getCutSet (secondChildLiteral).empty ()))
+          && !hasBestCut (secondChildLiteral)))
     throw std::runtime_error (
         "Runtime error (phiOperation): one or both child nodes of andLiteral "
         "are and-nodes but have no CutSet defined.");
 
   // Get child node cut sets
   // If the child node is an input, start a new empty cut set
+  // Spilled cut sets are read back from the scratch file
   CutSet firstChildCutSet = _aig.nodeIsInput (firstChildLiteral)
                                 ? CutSet ()
-                                : getCutSet (firstChildLiteral);
+                                : readCutSet (firstChildLiteral);
   CutSet secondChildCutSet = _aig.nodeIsInput (secondChildLiteral)
                                  ? CutSet ()
-                                 : getCutSet (secondChildLiteral);
+                                 : readCutSet (secondChildLiteral);
 
   // Add the autocut to the cut sets
   Cut firstChildAutoCut = generateAutoCut (firstChildLiteral);
@@ -325,9 +758,12 @@ CutEngine::phiOperation (const unsigned int &andLiteral)
                            _k);
 }
 
+template <typename ObserverPolicy>
 const CutSet &
-CutEngine::findCuts (const unsigned int &andLiteral)
+CutEngineBase<ObserverPolicy>::findCuts (const unsigned int &andLiteral)
 {
+  TMAP_ALLOCATION_SUBSYSTEM ("cut enumeration");
+
   // Throw an exception if the value provided in andLiteral is not a valid AND
   // node literal
   if (!_aig.nodeIsAnd (andLiteral))
@@ -337,8 +773,8 @@ CutEngine::findCuts (const unsigned int &andLiteral)
 
   // If andLiteral has its cut set already defined, do nothing: simply
   // return the cut set
-  if (!getCutSet (andLiteral).empty ())
-    return _cutSetVector.at (vectorIndexFromAndLiteral (andLiteral));
+  if (hasBestCut (andLiteral))
+    return getCutSet (andLiteral);
 
   // Create a stack to save the nodes that will be processed
   std::stack<unsigned int> processingStack;
@@ -361,7 +797,7 @@ CutEngine::findCuts (const unsigned int &andLiteral)
       // If the firstChildNode is an and-node and has not yet been processed,
       // put it on top of the stack and put off the current iteration for later
       if (_aig.nodeIsAnd (firstChildLiteral)
-          && getCutSet (firstChildLiteral).empty ())
+          && !hasBestCut (firstChildLiteral))
         {
           processingStack.push (firstChildLiteral);
           continue; // put off current iteration
@@ -369,7 +805,7 @@ CutEngine::findCuts (const unsigned int &andLiteral)
 
       // Does the same test for the second child node
       if (_aig.nodeIsAnd (secondChildLiteral)
-          && getCutSet (secondChildLiteral).empty ())
+          && !hasBestCut (secondChildLiteral))
         {
           processingStack.push (secondChildLiteral);
           continue; // put off current iteration
@@ -378,119 +814,446 @@ CutEngine::findCuts (const unsigned int &andLiteral)
       // If execution reached this point, the child nodes are either input
       // nodes or have their cut sets defined already, thus phiOperation can be
       // applied to currentAndNode
-      CutSet currentNodeCutSet = phiOperation (currentAndNode);
-
-      // If c paramenter was provided, sort all cuts and store only the c best
-      if (_c > 0)
-        {
-          CutSet bestCutsSet
-              = sortAndChooseBestCuts (currentNodeCutSet, _c, _mappingGoal);
-          _cutSetVector.at (vectorIndexFromAndLiteral (currentAndNode))
-              = bestCutsSet;
-          if (bestCutsSet.at (0).getAreaCost () == 0)
-            {
-              _implementationMap[currentAndNode] = true;
-              if (_aig.nodeIsAnd (firstChildLiteral))
-                {
-                  const Cut &firstChildBestCut
-                      = getBestCut (firstChildLiteral);
-                  if (std::includes (
-                          bestCutsSet.at (0).getVariableSet ().begin (),
-                          bestCutsSet.at (0).getVariableSet ().end (),
-                          firstChildBestCut.getVariableSet ().begin (),
-                          firstChildBestCut.getVariableSet ().end ()))
-                    {
-                      if (firstChildLiteral % 2 == 1)
-                        firstChildLiteral--;
-                      _implementationMap[firstChildLiteral] = false;
-                    }
-                }
-              if (_aig.nodeIsAnd (secondChildLiteral))
-                {
-                  const Cut &secondChildBestCut
-                      = getBestCut (secondChildLiteral);
-                  if (std::includes (
-                          bestCutsSet.at (0).getVariableSet ().begin (),
-                          bestCutsSet.at (0).getVariableSet ().end (),
-                          secondChildBestCut.getVariableSet ().begin (),
-                          secondChildBestCut.getVariableSet ().end ()))
-                    {
-                      if (secondChildLiteral % 2 == 1)
-                        secondChildLiteral--;
-                      _implementationMap[secondChildLiteral] = false;
-                    }
-                }
-            }
-        }
-      // Otherwise only sort and store (no prunning)
-      else
-        {
-          CutSet sortedCutSet = sortCutSet (currentNodeCutSet, _mappingGoal);
-          _cutSetVector.at (vectorIndexFromAndLiteral (currentAndNode))
-              = sortedCutSet;
-          Cut autoCut = Cut (
-              { AndInverterGraph::indexFromLiteral (firstChildLiteral),
-                AndInverterGraph::indexFromLiteral (secondChildLiteral) });
-          if (sortedCutSet.at (0).getAreaCost () == 0)
-            {
-              _implementationMap[currentAndNode] = true;
-              if (_aig.nodeIsAnd (firstChildLiteral))
-                {
-                  const Cut &firstChildBestCut
-                      = getBestCut (firstChildLiteral);
-                  if (std::includes (
-                          sortedCutSet.at (0).getVariableSet ().begin (),
-                          sortedCutSet.at (0).getVariableSet ().end (),
-                          firstChildBestCut.getVariableSet ().begin (),
-                          firstChildBestCut.getVariableSet ().end ()))
-                    {
-                      if (firstChildLiteral % 2 == 1)
-                        firstChildLiteral--;
-                      _implementationMap[firstChildLiteral] = false;
-                    }
-                }
-              if (_aig.nodeIsAnd (secondChildLiteral))
-                {
-                  const Cut &secondChildBestCut
-                      = getBestCut (secondChildLiteral);
-                  if (std::includes (
-                          sortedCutSet.at (0).getVariableSet ().begin (),
-                          sortedCutSet.at (0).getVariableSet ().end (),
-                          secondChildBestCut.getVariableSet ().begin (),
-                          secondChildBestCut.getVariableSet ().end ()))
-                    {
-                      if (secondChildLiteral % 2 == 1)
-                        secondChildLiteral--;
-                      _implementationMap[secondChildLiteral] = false;
-                    }
-                }
-            }
-        }
+      enumerateNode (currentAndNode, *_arenaVector.front (), nullptr);
 
       // Remove currentAndNode from the top of the stack
       processingStack.pop ();
     }
 
   // Sanity check
-  if (getCutSet (andLiteral).empty ())
+  if (!hasBestCut (andLiteral))
     throw std::runtime_error (
         "Runtime error (evaluateCutSet): cut set for andLiteral remains "
         "undefined after processing due to errors.");
 
   // Return the CutSet evaluated for andLiteral
-  return _cutSetVector.at (vectorIndexFromAndLiteral (andLiteral));
+  return getCutSet (andLiteral);
 }
 
+template <typename ObserverPolicy>
 void
-CutEngine::run ()
+CutEngineBase<ObserverPolicy>::enumerateNode (
+    unsigned int andLiteral, CutArena &arena,
+    std::vector<std::pair<unsigned int, bool>> *implementationUpdates)
 {
+  this->notifyNodeEnumerationStart (andLiteral);
+  CutSet nodeCutSet = phiOperation (andLiteral);
+  this->notifyDiamondProduct (andLiteral, nodeCutSet.size ());
+
+  // If c paramenter was provided, sort all cuts and store only the c best.
+  // Otherwise only sort and store (no prunning). The out-of-core mode keeps
+  // the cut set on the heap, so that it can be freed when it is spilled
+  CutSet *storedCutSet = nullptr;
+  unsigned int vectorIndex = vectorIndexFromAndLiteral (andLiteral);
+  {
+    TMAP_ALLOCATION_SUBSYSTEM ("cut sets");
+    CutSet bestCutsSet;
+    if (_c > 0)
+      {
+        bestCutsSet = sortAndChooseBestCuts (nodeCutSet, _c, _mappingGoal);
+        if (bestCutsSet.size () < nodeCutSet.size ())
+          this->notifyCutsPruned (andLiteral,
+                                  nodeCutSet.size () - bestCutsSet.size ());
+      }
+    else
+      bestCutsSet = sortCutSet (nodeCutSet, _mappingGoal);
+    if (_outOfCoreWindow > 0)
+      {
+        _residentCutSetVector[vectorIndex]
+            = std::make_unique<CutSet> (std::move (bestCutsSet));
+        storedCutSet = _residentCutSetVector[vectorIndex].get ();
+      }
+    else
+      storedCutSet = allocateCutSet (bestCutsSet, arena);
+  }
+
+  try
+    {
+      updateImplementationMap (andLiteral, storedCutSet->at (0),
+                               implementationUpdates);
+
+      // Define the cut that implements andLiteral in the cover. Only then
+      // the cut set is published, so readers never see a node without its
+      // selected cut
+      selectCut (andLiteral, storedCutSet->at (0));
+      publishCutSet (andLiteral, storedCutSet);
+    }
+  catch (...)
+    {
+      if (_outOfCoreWindow > 0)
+        _residentCutSetVector[vectorIndex].reset ();
+      else
+        storedCutSet->~CutSet ();
+      throw;
+    }
+  this->notifyNodeEnumerationEnd (andLiteral, *storedCutSet);
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::updateImplementationMap (
+    unsigned int andLiteral, const Cut &bestCut,
+    std::vector<std::pair<unsigned int, bool>> *implementationUpdates)
+{
+  const AndNode &an = _aig.getAndNodeFromLiteral (andLiteral);
+  unsigned int firstChildLiteral = an.getFirstChild ();
+  unsigned int secondChildLiteral = an.getSecondChild ();
+
+  // If the best cut has no area cost, the node is implemented, and the
+  // and-node children whose best cuts it contains are no longer
+  auto updateImplementation = [&] (unsigned int literal, bool implemented) {
+    if (implementationUpdates != nullptr)
+      implementationUpdates->emplace_back (literal, implemented);
+    else
+      _implementationMap[literal] = implemented;
+  };
+  if (bestCut.getAreaCost () == 0)
+    {
+      updateImplementation (andLiteral, true);
+      for (unsigned int childLiteral :
+           { firstChildLiteral, secondChildLiteral })
+        if (_aig.nodeIsAnd (childLiteral))
+          {
+            const Cut &childBestCut = getBestCut (childLiteral);
+            if (std::includes (bestCut.getVariableSet ().begin (),
+                               bestCut.getVariableSet ().end (),
+                               childBestCut.getVariableSet ().begin (),
+                               childBestCut.getVariableSet ().end ()))
+              updateImplementation (childLiteral - childLiteral % 2, false);
+          }
+    }
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::run ()
+{
+  TMAP_ALLOCATION_SUBSYSTEM ("cut enumeration");
+  unsigned int numAnds = _aig.getNumAnds ();
+
+  // The and-nodes whose cuts are not found, in the order findCuts() would
+  // enumerate them from each output in turn. As in findCuts(), a node is
+  // enumerated with the literal it was reached by. Any number of threads
+  // finds the cuts of this order
+  std::vector<unsigned int> nodeOrder;
+  std::vector<bool> orderedVector (numAnds, false);
+  auto isPending = [&] (unsigned int literal) {
+    return _aig.nodeIsAnd (literal) && !hasBestCut (literal)
+           && !orderedVector[vectorIndexFromAndLiteral (literal)];
+  };
+  std::stack<unsigned int> processingStack;
   for (const auto &outputLiteral : _aig.getOutputLiteralVector ())
-    if (_aig.nodeIsAnd (outputLiteral))
-      this->findCuts (outputLiteral);
+    {
+      if (!isPending (outputLiteral))
+        continue;
+      processingStack.push (outputLiteral);
+      while (!processingStack.empty ())
+        {
+          const AndNode &an
+              = _aig.getAndNodeFromLiteral (processingStack.top ());
+          if (isPending (an.getFirstChild ()))
+            processingStack.push (an.getFirstChild ());
+          else if (isPending (an.getSecondChild ()))
+            processingStack.push (an.getSecondChild ());
+          else
+            {
+              unsigned int literal = processingStack.top ();
+              orderedVector[vectorIndexFromAndLiteral (literal)] = true;
+              nodeOrder.push_back (literal);
+              processingStack.pop ();
+            }
+        }
+    }
+  if (nodeOrder.empty ())
+    return;
+  if (_outOfCoreWindow > 0 && _numThreads > 1)
+    throw std::runtime_error ("Runtime error (run): the out-of-core mode "
+                              "enumerates with one thread.");
+  if (_progress)
+    _progress->addNodes (nodeOrder.size ());
+  stopIfCancelled ();
+  if (_outOfCoreWindow > 0)
+    runOutOfCore (nodeOrder);
+  else
+    runDepthFirst (nodeOrder);
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::findUsePositions (
+    const std::vector<unsigned int> &nodeOrder,
+    std::vector<unsigned int> &useBeginVector,
+    std::vector<unsigned int> &useVector) const
+{
+  // The uses of each node are counted, then their positions are written in
+  // increasing order
+  unsigned int numAnds = _aig.getNumAnds ();
+  useBeginVector.assign (numAnds + 1, 0);
+  for (const auto &andLiteral : nodeOrder)
+    {
+      const AndNode &an = _aig.getAndNodeFromLiteral (andLiteral);
+      for (unsigned int childLiteral :
+           { an.getFirstChild (), an.getSecondChild () })
+        if (_aig.nodeIsAnd (childLiteral))
+          useBeginVector[vectorIndexFromAndLiteral (childLiteral) + 1]++;
+    }
+  for (unsigned int i = 0; i < numAnds; i++)
+    useBeginVector[i + 1] += useBeginVector[i];
+  useVector.resize (useBeginVector[numAnds]);
+  std::vector<unsigned int> useEndVector (useBeginVector.begin (),
+                                          useBeginVector.end () - 1);
+  for (unsigned int position = 0; position < nodeOrder.size (); position++)
+    {
+      const AndNode &an = _aig.getAndNodeFromLiteral (nodeOrder[position]);
+      for (unsigned int childLiteral :
+           { an.getFirstChild (), an.getSecondChild () })
+        if (_aig.nodeIsAnd (childLiteral))
+          useVector[useEndVector[vectorIndexFromAndLiteral (childLiteral)]++]
+              = position;
+    }
 }
 
+template <typename ObserverPolicy>
 void
-CutEngine::printOutputsBestCuts (std::ostream &os) const
+CutEngineBase<ObserverPolicy>::runDepthFirst (
+    const std::vector<unsigned int> &nodeOrder)
+{
+  unsigned int numAnds = _aig.getNumAnds ();
+  unsigned int numNodes = nodeOrder.size ();
+
+  // Enumerating a node reads whether the and-nodes in the cuts of its
+  // children are implemented. In the order, that is decided by each of them
+  // and by their fanouts enumerated before the reader. So instead of writing
+  // to the implementation map, nodes record the position from which the
+  // nodes they update are no longer implemented, and readers compare it with
+  // their own position (see estimateUnionCutAreaCost())
+  _positionVector.assign (numAnds, NoPosition);
+  for (unsigned int position = 0; position < numNodes; position++)
+    _positionVector[vectorIndexFromAndLiteral (nodeOrder[position])]
+        = position;
+  _unimplementedFromVector.reset (new std::atomic<unsigned int>[numAnds]);
+  for (unsigned int i = 0; i < numAnds; i++)
+    _unimplementedFromVector[i].store (
+        _implementationMap.at (andLiteralFromVectorIndex (i)) ? NoPosition
+                                                              : 0,
+        std::memory_order_relaxed);
+
+  // Every thread has its own arena, and threads are spread over the NUMA
+  // nodes round-robin
+  const std::vector<unsigned int> &numaNodes = NumaTopology::getNodes ();
+  while (_arenaVector.size () < _numThreads)
+    _arenaVector.push_back (std::make_unique<CutArena> (
+        numaNodes[_arenaVector.size () % numaNodes.size ()]));
+
+  // With several threads, a node waits for its children and for the fanouts
+  // of the and-nodes in their cuts that come before it in the order: they
+  // are the nodes whose updates it reads, so its cuts are the same as with
+  // one thread. A single thread finds them all done and does not wait
+  std::unique_ptr<std::atomic<bool>[]> doneVector (
+      new std::atomic<bool>[numNodes]);
+  for (unsigned int position = 0; position < numNodes; position++)
+    doneVector[position].store (false, std::memory_order_relaxed);
+  std::vector<unsigned int> useBeginVector;
+  std::vector<unsigned int> useVector;
+  std::unique_ptr<std::atomic<unsigned int>[]> nextUseVector;
+  if (_numThreads > 1)
+    {
+      findUsePositions (nodeOrder, useBeginVector, useVector);
+      nextUseVector.reset (new std::atomic<unsigned int>[numAnds]);
+      for (unsigned int i = 0; i < numAnds; i++)
+        nextUseVector[i].store (useBeginVector[i], std::memory_order_relaxed);
+    }
+  std::atomic<bool> stopped (false);
+  auto isStopped = [&] () {
+    return stopped.load (std::memory_order_relaxed)
+           || (_progress && _progress->isCancelled ());
+  };
+  auto waitForPosition = [&] (unsigned int position) {
+    while (!doneVector[position].load (std::memory_order_acquire))
+      {
+        if (isStopped ())
+          return false;
+        std::this_thread::yield ();
+      }
+    return true;
+  };
+  // The fanouts found done are skipped by the next readers of the node
+  auto waitForFanouts = [&] (unsigned int i, unsigned int position) {
+    unsigned int use = nextUseVector[i].load (std::memory_order_acquire);
+    for (; use < useBeginVector[i + 1] && useVector[use] < position; use++)
+      if (!waitForPosition (useVector[use]))
+        return false;
+    unsigned int seenUse = nextUseVector[i].load (std::memory_order_relaxed);
+    while (seenUse < use
+           && !nextUseVector[i].compare_exchange_weak (seenUse, use))
+      ;
+    return true;
+  };
+  auto waitForReads = [&] (unsigned int andLiteral, unsigned int position) {
+    const AndNode &an = _aig.getAndNodeFromLiteral (andLiteral);
+    for (unsigned int childLiteral :
+         { an.getFirstChild (), an.getSecondChild () })
+      {
+        if (!_aig.nodeIsAnd (childLiteral))
+          continue;
+        unsigned int child = vectorIndexFromAndLiteral (childLiteral);
+        if ((_positionVector[child] != NoPosition
+             && !waitForPosition (_positionVector[child]))
+            || !waitForFanouts (child, position))
+          return false;
+        for (const auto &cut : getCutSet (childLiteral))
+          for (const auto &leafVariable : cut)
+            {
+              unsigned int leafLiteral
+                  = AndInverterGraph::literalFromIndex (leafVariable);
+              if (_aig.nodeIsAnd (leafLiteral)
+                  && !waitForFanouts (vectorIndexFromAndLiteral (leafLiteral),
+                                      position))
+                return false;
+            }
+      }
+    return true;
+  };
+
+  // Threads take NodesPerTake consecutive positions at a time, so that a node
+  // and the consumers that follow it in the order mostly stay on the same
+  // thread and NUMA node. Each thread enumerates its positions in order, so
+  // the first position not done is always being enumerated. Allocations of
+  // the threads are charged to the phase of the caller
+  unsigned int phaseTag
+      = AllocationTracker::getCurrentTag (AllocationTracker::TagKind::Phase);
+  std::vector<std::vector<std::pair<unsigned int, bool>>> updateVector (
+      numNodes);
+  std::atomic<std::size_t> nextPosition (0);
+  auto enumerateNodes = [&] (unsigned int worker) {
+    AllocationScope phaseScope (phaseTag);
+    TMAP_ALLOCATION_SUBSYSTEM ("cut enumeration");
+    CutArena &arena = *_arenaVector[worker];
+    std::size_t first;
+    while ((first = nextPosition.fetch_add (NodesPerTake)) < numNodes)
+      {
+        std::size_t last
+            = std::min<std::size_t> (first + NodesPerTake, numNodes);
+        for (unsigned int position = first; position < last; position++)
+          try
+            {
+              unsigned int andLiteral = nodeOrder[position];
+              if (isStopped ()
+                  || (_numThreads > 1
+                      && !waitForReads (andLiteral, position)))
+                return;
+              enumerateNode (andLiteral, arena, &updateVector[position]);
+
+              // Only the entries of and-nodes, with even literals, are read
+              // by other nodes
+              for (const auto &[literal, implemented] :
+                   updateVector[position])
+                {
+                  if (literal % 2 == 1)
+                    continue;
+                  std::atomic<unsigned int> &unimplementedFrom
+                      = _unimplementedFromVector[vectorIndexFromAndLiteral (
+                          literal)];
+                  unsigned int from = implemented ? NoPosition : position + 1;
+                  unsigned int current
+                      = unimplementedFrom.load (std::memory_order_relaxed);
+                  while ((implemented || current > from)
+                         && !unimplementedFrom.compare_exchange_weak (current,
+                                                                      from))
+                    ;
+                }
+              doneVector[position].store (true, std::memory_order_release);
+              if (_progress)
+                _progress->nodeDone ();
+            }
+          catch (...)
+            {
+              stopped.store (true, std::memory_order_relaxed);
+              throw;
+            }
+      }
+  };
+  try
+    {
+      if (_numThreads > 1)
+        {
+          WorkerPool workerPool (_numThreads, [&] (unsigned int worker) {
+            if (numaNodes.size () > 1)
+              NumaTopology::bindCurrentThread (
+                  numaNodes[worker % numaNodes.size ()]);
+          });
+          workerPool.runOnAll (enumerateNodes);
+        }
+      else
+        enumerateNodes (0);
+    }
+  catch (...)
+    {
+      _positionVector = {};
+      _unimplementedFromVector.reset ();
+      throw;
+    }
+  _positionVector = {};
+  _unimplementedFromVector.reset ();
+  stopIfCancelled ();
+
+  // The implementation map is updated in the order of the nodes, as if they
+  // had been enumerated one by one
+  TMAP_ALLOCATION_SUBSYSTEM ("implementation map");
+  for (const auto &updates : updateVector)
+    for (const auto &[literal, implemented] : updates)
+      _implementationMap[literal] = implemented;
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::runOutOfCore (
+    const std::vector<unsigned int> &nodeOrder)
+{
+  // Nodes are enumerated in the order of nodeOrder
+  std::vector<unsigned int> useBeginVector;
+  std::vector<unsigned int> useVector;
+  findUsePositions (nodeOrder, useBeginVector, useVector);
+
+  // A node in memory is spilled when its next fanout is more than the
+  // window ahead of the position just enumerated
+  std::vector<unsigned int> nextUseVector (useBeginVector.begin (),
+                                           useBeginVector.end () - 1);
+  auto spillIfFar = [&] (unsigned int i, unsigned int position) {
+    if (!_residentCutSetVector[i])
+      return;
+    unsigned int &nextUse = nextUseVector[i];
+    while (nextUse < useBeginVector[i + 1] && useVector[nextUse] <= position)
+      nextUse++;
+    if (nextUse == useBeginVector[i + 1]
+        || useVector[nextUse] - position > _outOfCoreWindow)
+      spillCutSet (i);
+  };
+
+  // The implementation map is updated after each node, so the mapping is the
+  // same as in memory (see runDepthFirst())
+  CutArena &arena = *_arenaVector.front ();
+  for (unsigned int position = 0; position < nodeOrder.size (); position++)
+    {
+      stopIfCancelled ();
+      unsigned int andLiteral = nodeOrder[position];
+      unsigned int i = vectorIndexFromAndLiteral (andLiteral);
+      enumerateNode (andLiteral, arena, nullptr);
+      if (_progress)
+        _progress->nodeDone ();
+
+      const AndNode &an = _aig.getAndNodeFromLiteral (andLiteral);
+      for (unsigned int childLiteral :
+           { an.getFirstChild (), an.getSecondChild () })
+        if (_aig.nodeIsAnd (childLiteral))
+          spillIfFar (vectorIndexFromAndLiteral (childLiteral), position);
+      spillIfFar (i, position);
+    }
+}
+
+template <typename ObserverPolicy>
+void
+CutEngineBase<ObserverPolicy>::printOutputsBestCuts (std::ostream &os) const
 {
   for (const auto &outputLiteral : _aig.getOutputLiteralVector ())
     {
@@ -508,8 +1271,10 @@ CutEngine::printOutputsBestCuts (std::ostream &os) const
     }
 }
 
+template <typename ObserverPolicy>
 std::ostream &
-operator<< (std::ostream &os, const CutEngine &cutEngine)
+operator<< (std::ostream &os,
+            const CutEngineBase<ObserverPolicy> &cutEngine)
 {
   os << ">> Current state of the CutEngine for "
      << cutEngine.getAndInverterGraph ().getFilePath () << std::endl;
@@ -521,18 +1286,22 @@ operator<< (std::ostream &os, const CutEngine &cutEngine)
                 + ":"
          << std::endl;
       os << "------------------------" << std::endl;
-      if (cutEngine._cutSetVector[i].size () == 0)
+      const CutSet &cutSet = cutEngine.getCutSet (
+          cutEngine.andLiteralFromVectorIndex (i));
+      if (cutSet.empty ())
         os << "No cut set defined." << std::endl;
       else
-        for (const auto &cut : cutEngine._cutSetVector[i])
+        for (const auto &cut : cutSet)
           os << cut << std::endl;
     }
 
   return os;
 }
 
+template <typename ObserverPolicy>
 unsigned int
-CutEngine::vectorIndexFromAndLiteral (unsigned int andLiteral) const
+CutEngineBase<ObserverPolicy>::vectorIndexFromAndLiteral (
+    unsigned int andLiteral) const
 {
   unsigned int vectorIndex = _aig.indexFromLiteral (andLiteral)
                              - _aig.getNumInputs () - _aig.getNumLatches ()
@@ -545,8 +1314,10 @@ CutEngine::vectorIndexFromAndLiteral (unsigned int andLiteral) const
     return vectorIndex;
 }
 
+template <typename ObserverPolicy>
 unsigned int
-CutEngine::andLiteralFromVectorIndex (unsigned int vectorIndex) const
+CutEngineBase<ObserverPolicy>::andLiteralFromVectorIndex (
+    unsigned int vectorIndex) const
 {
   unsigned int andLiteral = _aig.literalFromIndex (
       vectorIndex + _aig.getNumInputs () + _aig.getNumLatches () + 1);
@@ -558,16 +1329,21 @@ CutEngine::andLiteralFromVectorIndex (unsigned int vectorIndex) const
     return andLiteral;
 }
 
+template <typename ObserverPolicy>
 Cut
-CutEngine::generateAutoCut (unsigned int nodeLiteral) const
+CutEngineBase<ObserverPolicy>::generateAutoCut (unsigned int nodeLiteral) const
 {
-  // If the node is an input, the cost is 1 for area, 1 for delay, and zero for
-  // power
+  // If the node is an input, the cost is zero for area and power, and the lut
+  // delay plus the delay of its net for delay (1 with the unit delay model)
   if (_aig.nodeIsInput (nodeLiteral))
-    return Cut ({ AndInverterGraph::indexFromLiteral (nodeLiteral) },
-                0,  // area cost
-                1,  // delay cost
-                0); // power cost
+    {
+      unsigned int autoCutDelay
+          = _delayModel.lutDelay + estimateNetDelay (nodeLiteral);
+      return Cut ({ AndInverterGraph::indexFromLiteral (nodeLiteral) },
+                  0,            // area cost
+                  autoCutDelay, // delay cost
+                  0);           // power cost
+    }
 
   // If the child node is an and-node...
   else if (_aig.nodeIsAnd (nodeLiteral))
@@ -586,8 +1362,9 @@ CutEngine::generateAutoCut (unsigned int nodeLiteral) const
         "Runtime error (phiOperation). Child node is neither input nor AND");
 }
 
+template <typename ObserverPolicy>
 void
-CutEngine::printImplementation (std::ostream &os)
+CutEngineBase<ObserverPolicy>::printImplementation (std::ostream &os)
 {
   std::cout << ">> Implementation details: " << std::endl;
   for (const auto &[node, implemented] : _implementationMap)
@@ -596,4 +1373,11 @@ CutEngine::printImplementation (std::ostream &os)
                 << std::endl;
     else
       std::cout << "(" << node << ") => not implemented" << std::endl;
-}
\ No newline at end of file
+}
+
+template class CutEngineBase<NullObserverPolicy>;
+template class CutEngineBase<DynamicObserverPolicy>;
+template std::ostream &operator<< (std::ostream &os,
+                                   const CutEngine &cutEngine);
+template std::ostream &operator<< (std::ostream &os,
+                                   const ObservedCutEngine &cutEngine);
\ No newline at end of file
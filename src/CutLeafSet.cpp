@@ -0,0 +1,120 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/CutLeafSet.h"
+
+#include <algorithm>
+#include <iterator>
+
+CutLeafSet::CutLeafSet (const std::set<unsigned int> &variables,
+                        unsigned int windowBase)
+    : _windowBase (windowBase)
+{
+  for (const auto &variable : variables)
+    if (variable < windowBase || variable - windowBase >= WindowWidth)
+      {
+        _windowed = false;
+        _sortedVariables.assign (variables.begin (), variables.end ());
+        return;
+      }
+  for (const auto &variable : variables)
+    _bits.set (variable - windowBase);
+}
+
+unsigned int
+CutLeafSet::windowBaseOf (unsigned int rootVariable) noexcept
+{
+  return rootVariable > WindowWidth ? rootVariable - WindowWidth : 0;
+}
+
+bool
+CutLeafSet::isWindowed () const noexcept
+{
+  return _windowed;
+}
+
+unsigned int
+CutLeafSet::size () const noexcept
+{
+  return _windowed ? _bits.count () : _sortedVariables.size ();
+}
+
+bool
+CutLeafSet::isSubsetOf (const CutLeafSet &other) const
+{
+  if (_windowed && other._windowed && _windowBase == other._windowBase)
+    return (_bits & ~other._bits).none ();
+  std::vector<unsigned int> variables = toSortedArray ();
+  std::vector<unsigned int> otherVariables = other.toSortedArray ();
+  return std::includes (otherVariables.begin (), otherVariables.end (),
+                        variables.begin (), variables.end ());
+}
+
+std::set<unsigned int>
+CutLeafSet::toSet () const
+{
+  if (!_windowed)
+    return std::set<unsigned int> (_sortedVariables.begin (),
+                                   _sortedVariables.end ());
+  std::set<unsigned int> variables;
+  for (unsigned int i = 0; i < WindowWidth; i++)
+    if (_bits.test (i))
+      variables.emplace_hint (variables.end (), _windowBase + i);
+  return variables;
+}
+
+CutLeafSet
+CutLeafSet::operator| (const CutLeafSet &rhs) const
+{
+  CutLeafSet unionSet;
+  unionSet._windowBase = _windowBase;
+  if (_windowed && rhs._windowed && _windowBase == rhs._windowBase)
+    {
+      unionSet._bits = _bits | rhs._bits;
+      return unionSet;
+    }
+  std::vector<unsigned int> lhsVariables = toSortedArray ();
+  std::vector<unsigned int> rhsVariables = rhs.toSortedArray ();
+  unionSet._windowed = false;
+  std::set_union (lhsVariables.begin (), lhsVariables.end (),
+                  rhsVariables.begin (), rhsVariables.end (),
+                  std::back_inserter (unionSet._sortedVariables));
+  return unionSet;
+}
+
+bool
+CutLeafSet::operator== (const CutLeafSet &rhs) const
+{
+  if (_windowed && rhs._windowed && _windowBase == rhs._windowBase)
+    return _bits == rhs._bits;
+  return toSortedArray () == rhs.toSortedArray ();
+}
+
+std::vector<unsigned int>
+CutLeafSet::toSortedArray () const
+{
+  std::vector<unsigned int> variables;
+  toSortedArray (variables);
+  return variables;
+}
+
+void
+CutLeafSet::toSortedArray (std::vector<unsigned int> &variables) const
+{
+  if (!_windowed)
+    {
+      variables.assign (_sortedVariables.begin (), _sortedVariables.end ());
+      return;
+    }
+  variables.clear ();
+  for (unsigned int i = 0; i < WindowWidth; i++)
+    if (_bits.test (i))
+      variables.push_back (_windowBase + i);
+}
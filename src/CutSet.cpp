@@ -10,10 +10,10 @@
 
 #include "../include/CutSet.h"
 
-std::pair<std::vector<Cut>::iterator, bool>
+std::pair<CutSet::iterator, bool>
 CutSet::emplace (const Cut &newCut)
 {
-  std::vector<Cut> *baseClassPointer = this;
+  std::pmr::vector<Cut> *baseClassPointer = this;
   for (auto it = baseClassPointer->begin (); it != baseClassPointer->end ();
        ++it)
     if (newCut == *it)
@@ -0,0 +1,182 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/CutSpillFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <set>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+// Encoding of a cut set: the number of cuts, then for each cut its number
+// of variables, its area, delay and power costs and its variables, all as
+// 32-bit words
+using Word = std::uint32_t;
+
+void
+putWord (char *&position, Word word)
+{
+  std::memcpy (position, &word, sizeof (word));
+  position += sizeof (word);
+}
+
+Word
+getWord (const char *&position)
+{
+  Word word;
+  std::memcpy (&word, position, sizeof (word));
+  position += sizeof (word);
+  return word;
+}
+}
+
+CutSpillFile::CutSpillFile (const std::string &directory)
+{
+  std::filesystem::path path = directory.empty ()
+                                   ? std::filesystem::temp_directory_path ()
+                                   : std::filesystem::path (directory);
+  std::string pathTemplate = (path / "tmap-cuts-XXXXXX").string ();
+  _fileDescriptor = mkstemp (pathTemplate.data ());
+  if (_fileDescriptor < 0)
+    throw std::runtime_error (
+        "Runtime error (CutSpillFile): unable to create a scratch file in '"
+        + path.string () + "': " + std::strerror (errno));
+
+  // The file is only reachable through its descriptor from now on
+  _filePath = pathTemplate;
+  unlink (_filePath.c_str ());
+}
+
+CutSpillFile::~CutSpillFile ()
+{
+  clear ();
+  close (_fileDescriptor);
+}
+
+std::uint64_t
+CutSpillFile::write (const CutSet &cutSet)
+{
+  std::size_t recordSize = sizeof (Word);
+  for (const auto &cut : cutSet)
+    recordSize += (4 + cut.numNodeVariables ()) * sizeof (Word);
+
+  if (_segmentVector.empty ()
+      || _segmentVector.back ().size - _segmentUsed < recordSize)
+    addSegment (recordSize);
+  Segment &segment = _segmentVector.back ();
+  std::uint64_t offset = segment.fileOffset + _segmentUsed;
+
+  char *position = segment.data + _segmentUsed;
+  putWord (position, cutSet.size ());
+  for (const auto &cut : cutSet)
+    {
+      putWord (position, cut.numNodeVariables ());
+      putWord (position, cut.getAreaCost ());
+      putWord (position, cut.getDelayCost ());
+      putWord (position, cut.getPowerCost ());
+      for (const auto &variable : cut.getVariableSet ())
+        putWord (position, variable);
+    }
+  _segmentUsed += recordSize;
+  _numBytes += recordSize;
+  return offset;
+}
+
+CutSet
+CutSpillFile::read (std::uint64_t offset) const
+{
+  // Segments are sorted by file offset
+  auto segment = std::upper_bound (
+      _segmentVector.begin (), _segmentVector.end (), offset,
+      [] (std::uint64_t offset, const Segment &segment) {
+        return offset < segment.fileOffset;
+      });
+  if (segment == _segmentVector.begin ())
+    throw std::runtime_error ("Runtime error (CutSpillFile::read): invalid "
+                              "cut set offset.");
+  --segment;
+  if (offset - segment->fileOffset >= segment->size)
+    throw std::runtime_error ("Runtime error (CutSpillFile::read): invalid "
+                              "cut set offset.");
+
+  const char *position = segment->data + (offset - segment->fileOffset);
+  Word numCuts = getWord (position);
+  CutSet cutSet;
+  cutSet.reserve (numCuts);
+  std::pmr::vector<Cut> *baseClassPointer = &cutSet;
+  for (Word i = 0; i < numCuts; i++)
+    {
+      Word numVariables = getWord (position);
+      Word areaCost = getWord (position);
+      Word delayCost = getWord (position);
+      Word powerCost = getWord (position);
+      std::set<unsigned int> variables;
+      for (Word j = 0; j < numVariables; j++)
+        variables.emplace_hint (variables.end (), getWord (position));
+      baseClassPointer->emplace_back (variables, areaCost, delayCost,
+                                      powerCost);
+    }
+  return cutSet;
+}
+
+std::uint64_t
+CutSpillFile::getNumBytes () const noexcept
+{
+  return _numBytes;
+}
+
+void
+CutSpillFile::clear ()
+{
+  for (const auto &segment : _segmentVector)
+    munmap (segment.data, segment.size);
+  _segmentVector.clear ();
+  _segmentUsed = 0;
+  _numBytes = 0;
+  _fileSize = 0;
+
+  // Failing to shrink the file only wastes disk space
+  [[maybe_unused]] int result = ftruncate (_fileDescriptor, 0);
+}
+
+void
+CutSpillFile::addSegment (std::size_t minSize)
+{
+  // The pages of the full segment are written back to the file, so they
+  // can leave memory; reading them faults them in again
+  if (!_segmentVector.empty ())
+    madvise (_segmentVector.back ().data, _segmentVector.back ().size,
+             MADV_DONTNEED);
+
+  std::size_t pageSize = sysconf (_SC_PAGESIZE);
+  std::size_t size = std::max (SegmentSize, minSize);
+  size = (size + pageSize - 1) / pageSize * pageSize;
+  if (ftruncate (_fileDescriptor, _fileSize + size) != 0)
+    throw std::runtime_error (
+        "Runtime error (CutSpillFile): unable to grow the scratch file '"
+        + _filePath + "': " + std::strerror (errno));
+  void *data = mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     _fileDescriptor, _fileSize);
+  if (data == MAP_FAILED)
+    throw std::runtime_error (
+        "Runtime error (CutSpillFile): unable to map the scratch file '"
+        + _filePath + "': " + std::strerror (errno));
+  _segmentVector.push_back ({ _fileSize, size, static_cast<char *> (data) });
+  _fileSize += size;
+  _segmentUsed = 0;
+}
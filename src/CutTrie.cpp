@@ -0,0 +1,127 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/CutTrie.h"
+
+#include <algorithm>
+
+CutTrie::CutTrie (std::pmr::memory_resource *resource)
+    : _nodeVector (resource)
+{
+  _nodeVector.push_back ({ 0, NoNode, NoNode, NoCut });
+}
+
+std::pair<std::size_t, bool>
+CutTrie::insert (const std::vector<unsigned int> &sortedLeaves,
+                 std::size_t cutIndex)
+{
+  unsigned int nodeIndex = 0;
+  for (const auto &leaf : sortedLeaves)
+    {
+      // Find the child with the leaf, or the place where it goes in the
+      // sorted list of children
+      unsigned int previousIndex = NoNode;
+      unsigned int childIndex = _nodeVector[nodeIndex].firstChild;
+      while (childIndex != NoNode && _nodeVector[childIndex].variable < leaf)
+        {
+          previousIndex = childIndex;
+          childIndex = _nodeVector[childIndex].nextSibling;
+        }
+      if (childIndex == NoNode || _nodeVector[childIndex].variable != leaf)
+        {
+          unsigned int newIndex = _nodeVector.size ();
+          _nodeVector.push_back ({ leaf, NoNode, childIndex, NoCut });
+          if (previousIndex == NoNode)
+            _nodeVector[nodeIndex].firstChild = newIndex;
+          else
+            _nodeVector[previousIndex].nextSibling = newIndex;
+          childIndex = newIndex;
+        }
+      nodeIndex = childIndex;
+    }
+  std::size_t &nodeCutIndex = _nodeVector[nodeIndex].cutIndex;
+  if (nodeCutIndex != NoCut)
+    return std::make_pair (nodeCutIndex, false);
+  nodeCutIndex = cutIndex;
+  _numCuts++;
+  return std::make_pair (cutIndex, true);
+}
+
+std::size_t
+CutTrie::find (const std::vector<unsigned int> &sortedLeaves) const
+{
+  unsigned int nodeIndex = 0;
+  for (const auto &leaf : sortedLeaves)
+    {
+      unsigned int childIndex = _nodeVector[nodeIndex].firstChild;
+      while (childIndex != NoNode && _nodeVector[childIndex].variable < leaf)
+        childIndex = _nodeVector[childIndex].nextSibling;
+      if (childIndex == NoNode || _nodeVector[childIndex].variable != leaf)
+        return NoCut;
+      nodeIndex = childIndex;
+    }
+  return _nodeVector[nodeIndex].cutIndex;
+}
+
+bool
+CutTrie::containsProperSubsetOf (
+    const std::vector<unsigned int> &sortedLeaves) const
+{
+  return containsSubsetBelow (0, sortedLeaves.begin (), sortedLeaves.end (),
+                              0, sortedLeaves.size ());
+}
+
+bool
+CutTrie::containsSubsetBelow (unsigned int nodeIndex,
+                              std::vector<unsigned int>::const_iterator first,
+                              std::vector<unsigned int>::const_iterator last,
+                              std::size_t depth, std::size_t numLeaves) const
+{
+  const Node &node = _nodeVector[nodeIndex];
+  if (node.cutIndex != NoCut && depth < numLeaves)
+    return true;
+
+  // Only the children whose variable is one of the remaining leaves can
+  // lead to a subset. Both lists are sorted, so they are merged
+  unsigned int childIndex = node.firstChild;
+  while (childIndex != NoNode && first != last)
+    {
+      const Node &child = _nodeVector[childIndex];
+      first = std::lower_bound (first, last, child.variable);
+      if (first == last)
+        break;
+      if (*first == child.variable
+          && containsSubsetBelow (childIndex, first + 1, last, depth + 1,
+                                  numLeaves))
+        return true;
+      childIndex = child.nextSibling;
+    }
+  return false;
+}
+
+std::size_t
+CutTrie::getNumCuts () const noexcept
+{
+  return _numCuts;
+}
+
+std::size_t
+CutTrie::getNumNodes () const noexcept
+{
+  return _nodeVector.size ();
+}
+
+void
+CutTrie::clear () noexcept
+{
+  _nodeVector.resize (1);
+  _nodeVector.front () = { 0, NoNode, NoNode, NoCut };
+  _numCuts = 0;
+}
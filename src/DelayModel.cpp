@@ -0,0 +1,27 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/DelayModel.h"
+
+unsigned int
+DelayModel::getNetDelay (unsigned int fanout) const noexcept
+{
+  // Ceiling of log2(fanout)
+  unsigned int doublings = 0;
+  while (doublings < 32 && (1ull << doublings) < fanout)
+    doublings++;
+  return wireDelay * doublings;
+}
+
+bool
+DelayModel::dependsOnFanout () const noexcept
+{
+  return wireDelay != 0;
+}
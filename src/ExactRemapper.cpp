@@ -0,0 +1,655 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/ExactRemapper.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stack>
+
+#include "../include/SatSolver.h"
+
+ExactRemapper::ExactRemapper (const MappingEngine &mappingEngine,
+                              const TechMapper &techMapper, unsigned int k)
+    : _aig (mappingEngine.getAndInverterGraph ()), _k (k)
+{
+  unsigned int numNodes = _aig.getMaxVariableIndex () + 1;
+  _isLutVector.assign (numNodes, false);
+  _lutInputVector.assign (numNodes, {});
+  for (unsigned int i = 0; i < _aig.getNumAnds (); i++)
+    {
+      unsigned int andLiteral = _aig.getFirstAndLiteral () + 2 * i;
+      if (!techMapper.isImplemented (andLiteral))
+        continue;
+      unsigned int variable = AndInverterGraph::indexFromLiteral (andLiteral);
+      const Cut &selectedCut = mappingEngine.getSelectedCut (andLiteral);
+      _isLutVector[variable] = true;
+      _lutInputVector[variable].assign (selectedCut.begin (),
+                                        selectedCut.end ());
+    }
+  evaluateTiming ();
+}
+
+void
+ExactRemapper::setNumThreads (unsigned int numThreads) noexcept
+{
+  _numThreads = std::max (numThreads, 1u);
+}
+
+void
+ExactRemapper::setConflictBudget (std::uint64_t conflictBudget) noexcept
+{
+  _conflictBudget = conflictBudget;
+}
+
+void
+ExactRemapper::runOnThreads (const std::function<void (unsigned int)> &task)
+{
+  if (_numThreads == 1)
+    {
+      task (0);
+      return;
+    }
+  if (!_workerPool)
+    _workerPool = std::make_unique<WorkerPool> (_numThreads);
+  _workerPool->runOnAll (task);
+}
+
+void
+ExactRemapper::evaluateTiming ()
+{
+  unsigned int numNodes = _isLutVector.size ();
+
+  // Live lookup tables in post-order from the outputs, as in LutNetwork
+  std::vector<bool> isLive (numNodes, false);
+  _drivesOutput.assign (numNodes, false);
+  _topologicalOrder.clear ();
+  std::stack<std::pair<unsigned int, unsigned int>> dfsStack;
+  for (const auto &outputLiteral : _aig.getOutputLiteralVector ())
+    {
+      unsigned int outputNode
+          = AndInverterGraph::indexFromLiteral (outputLiteral);
+      if (!_isLutVector[outputNode])
+        continue;
+      _drivesOutput[outputNode] = true;
+      if (isLive[outputNode])
+        continue;
+      isLive[outputNode] = true;
+      dfsStack.push ({ outputNode, 0 });
+      while (!dfsStack.empty ())
+        {
+          auto &[node, nextInput] = dfsStack.top ();
+          const std::vector<unsigned int> &inputs = _lutInputVector[node];
+          if (nextInput == inputs.size ())
+            {
+              _topologicalOrder.push_back (node);
+              dfsStack.pop ();
+              continue;
+            }
+          unsigned int input = inputs[nextInput++];
+          if (_isLutVector[input] && !isLive[input])
+            {
+              isLive[input] = true;
+              dfsStack.push ({ input, 0 });
+            }
+        }
+    }
+  for (unsigned int node = 0; node < numNodes; node++)
+    if (!isLive[node] && _isLutVector[node])
+      {
+        _isLutVector[node] = false;
+        _lutInputVector[node].clear ();
+      }
+
+  // Levels, fanouts and costs. Outputs driven by an input, GND or VDD are
+  // implemented by one lookup table and lookup tables without inputs are
+  // constant drivers at level 0, as in TechMapper
+  _levelVector.assign (numNodes, 0);
+  _fanoutVector.assign (numNodes, {});
+  _mappingAreaCost = 0;
+  for (const auto &node : _topologicalOrder)
+    {
+      unsigned int level = 0;
+      for (const auto &input : _lutInputVector[node])
+        {
+          level = std::max (level, _levelVector[input]);
+          _fanoutVector[input].push_back (node);
+        }
+      if (!_lutInputVector[node].empty ())
+        {
+          _levelVector[node] = level + 1;
+          _mappingAreaCost++;
+        }
+    }
+  _mappingDelayCost = 0;
+  for (const auto &outputLiteral : _aig.getOutputLiteralVector ())
+    if (_aig.nodeIsAnd (outputLiteral))
+      _mappingDelayCost = std::max (
+          _mappingDelayCost,
+          _levelVector[AndInverterGraph::indexFromLiteral (outputLiteral)]);
+    else if (_aig.nodeIsInput (outputLiteral) || outputLiteral < 2)
+      {
+        _mappingAreaCost++;
+        _mappingDelayCost = std::max (_mappingDelayCost, 1u);
+      }
+
+  // Required levels, from the outputs back
+  _requiredLevelVector.assign (numNodes, _mappingDelayCost);
+  for (auto node = _topologicalOrder.rbegin ();
+       node != _topologicalOrder.rend (); ++node)
+    for (const auto &input : _lutInputVector[*node])
+      _requiredLevelVector[input] = std::min (_requiredLevelVector[input],
+                                              _requiredLevelVector[*node] - 1);
+}
+
+std::vector<unsigned int>
+ExactRemapper::coveredNodes (unsigned int lut) const
+{
+  std::vector<unsigned int> nodes = { lut };
+  std::stack<unsigned int> processingStack;
+  processingStack.push (lut);
+  while (!processingStack.empty ())
+    {
+      const AndNode &an = _aig.getAndNodeFromLiteral (
+          AndInverterGraph::literalFromIndex (processingStack.top ()));
+      processingStack.pop ();
+      for (const auto &childLiteral : { an.getFirstChild (),
+                                        an.getSecondChild () })
+        {
+          unsigned int child
+              = AndInverterGraph::indexFromLiteral (childLiteral);
+          if (child == 0 || !_aig.nodeIsAnd (childLiteral)
+              || _isLutVector[child]
+              || std::find (nodes.begin (), nodes.end (), child)
+                     != nodes.end ())
+            continue;
+          nodes.push_back (child);
+          if (nodes.size () > MaxConeAnds)
+            return {};
+          processingStack.push (child);
+        }
+    }
+  std::sort (nodes.begin (), nodes.end ());
+  return nodes;
+}
+
+ExactRemapper::Cone
+ExactRemapper::buildCone (unsigned int root) const
+{
+  Cone cone;
+  cone.root = root;
+  cone.nodeVector = coveredNodes (root);
+  if (cone.nodeVector.empty ())
+    return cone;
+
+  // Lookup tables below the root, breadth first
+  cone.lutVector.push_back (root);
+  for (unsigned int i = 0; i < cone.lutVector.size (); i++)
+    for (const auto &input : _lutInputVector[cone.lutVector[i]])
+      {
+        if (cone.lutVector.size () == MaxConeLuts)
+          break;
+        if (!_isLutVector[input] || _lutInputVector[input].empty ()
+            || _levelVector[input] + ConeLevels <= _levelVector[root]
+            || std::find (cone.lutVector.begin (), cone.lutVector.end (),
+                          input)
+                   != cone.lutVector.end ())
+          continue;
+        std::vector<unsigned int> inputNodes = coveredNodes (input);
+        if (inputNodes.empty ())
+          continue;
+        std::vector<unsigned int> nodes;
+        std::set_union (cone.nodeVector.begin (), cone.nodeVector.end (),
+                        inputNodes.begin (), inputNodes.end (),
+                        std::back_inserter (nodes));
+        if (nodes.size () > MaxConeAnds)
+          continue;
+        cone.nodeVector = std::move (nodes);
+        cone.lutVector.push_back (input);
+      }
+
+  // Lookup tables read from outside the cone, or driving outputs
+  for (const auto &lut : cone.lutVector)
+    if (_drivesOutput[lut]
+        || std::any_of (_fanoutVector[lut].begin (), _fanoutVector[lut].end (),
+                        [&cone] (unsigned int fanout) {
+                          return std::find (cone.lutVector.begin (),
+                                            cone.lutVector.end (), fanout)
+                                 == cone.lutVector.end ();
+                        }))
+      cone.requiredVector.push_back (lut);
+  return cone;
+}
+
+ExactRemapper::ConeCover
+ExactRemapper::solveCone (const Cone &cone) const
+{
+  const std::vector<unsigned int> &nodes = cone.nodeVector;
+  unsigned int numNodes = nodes.size ();
+  constexpr unsigned int NoLevel = std::numeric_limits<unsigned int>::max ();
+  auto localIndex = [&nodes] (unsigned int node) -> int {
+    auto position = std::lower_bound (nodes.begin (), nodes.end (), node);
+    if (position == nodes.end () || *position != node)
+      return -1;
+    return position - nodes.begin ();
+  };
+
+  // K-feasible cuts of each node over the cone, the smallest first
+  std::vector<std::vector<std::vector<unsigned int>>> cutVector (numNodes);
+  for (unsigned int i = 0; i < numNodes; i++)
+    {
+      auto childCuts = [&] (unsigned int childLiteral) {
+        unsigned int child = AndInverterGraph::indexFromLiteral (childLiteral);
+        if (child == 0)
+          return std::vector<std::vector<unsigned int>> (1);
+        std::vector<std::vector<unsigned int>> cuts = { { child } };
+        int j = localIndex (child);
+        if (j >= 0)
+          cuts.insert (cuts.end (), cutVector[j].begin (),
+                       cutVector[j].end ());
+        return cuts;
+      };
+      const AndNode &an = _aig.getAndNodeFromLiteral (
+          AndInverterGraph::literalFromIndex (nodes[i]));
+      std::vector<std::vector<unsigned int>> firstCuts
+          = childCuts (an.getFirstChild ());
+      std::vector<std::vector<unsigned int>> secondCuts
+          = childCuts (an.getSecondChild ());
+      std::vector<std::vector<unsigned int>> &cuts = cutVector[i];
+      for (const auto &firstCut : firstCuts)
+        for (const auto &secondCut : secondCuts)
+          {
+            std::vector<unsigned int> cut;
+            std::set_union (firstCut.begin (), firstCut.end (),
+                            secondCut.begin (), secondCut.end (),
+                            std::back_inserter (cut));
+            if (!cut.empty () && cut.size () <= _k)
+              cuts.push_back (std::move (cut));
+          }
+      std::sort (cuts.begin (), cuts.end (),
+                 [] (const std::vector<unsigned int> &a,
+                     const std::vector<unsigned int> &b) {
+                   return a.size () != b.size () ? a.size () < b.size ()
+                                                 : a < b;
+                 });
+      cuts.erase (std::unique (cuts.begin (), cuts.end ()), cuts.end ());
+      if (cuts.size () > MaxCutsPerNode)
+        cuts.resize (MaxCutsPerNode);
+    }
+
+  // Earliest and latest levels of each node over its cuts. A node is ready
+  // by its latest level whenever it is implemented
+  std::vector<unsigned int> earliestVector (numNodes, NoLevel);
+  std::vector<unsigned int> latestVector (numNodes, 0);
+  for (unsigned int i = 0; i < numNodes; i++)
+    for (const auto &cut : cutVector[i])
+      {
+        unsigned int earliest = 0, latest = 0;
+        for (const auto &leaf : cut)
+          {
+            int j = localIndex (leaf);
+            earliest = std::max (earliest, j >= 0 ? earliestVector[j]
+                                                  : _levelVector[leaf]);
+            latest = std::max (latest,
+                               j >= 0 ? latestVector[j] : _levelVector[leaf]);
+          }
+        if (earliest != NoLevel)
+          earliestVector[i] = std::min (earliestVector[i], earliest + 1);
+        latestVector[i] = std::max (latestVector[i], latest + 1);
+      }
+  int rootIndex = localIndex (cone.root);
+  unsigned int currentLevel = _levelVector[cone.root];
+
+  // One SAT problem: a cover whose root is ready by level depth, with at
+  // most bound lookup tables. Variables: u_i (node i is implemented), s_ic
+  // (by cut c) and r_it (and ready by level t)
+  std::uint64_t remainingConflicts = _conflictBudget;
+  auto solve = [&] (unsigned int depth, unsigned int bound,
+                    ConeCover &cover) {
+    SatSolver solver;
+    unsigned int falseLiteral = SatSolver::literal (solver.newVariable ());
+    solver.addClause ({ falseLiteral ^ 1 });
+    std::vector<unsigned int> implementedVector (numNodes);
+    std::vector<std::vector<unsigned int>> selectedVector (numNodes);
+    std::vector<std::vector<unsigned int>> readyVector (numNodes);
+    for (unsigned int i = 0; i < numNodes; i++)
+      {
+        implementedVector[i] = SatSolver::literal (solver.newVariable ());
+        for (unsigned int c = 0; c < cutVector[i].size (); c++)
+          selectedVector[i].push_back (
+              SatSolver::literal (solver.newVariable ()));
+        for (unsigned int t = earliestVector[i];
+             t < std::min (latestVector[i], currentLevel + 1); t++)
+          readyVector[i].push_back (
+              SatSolver::literal (solver.newVariable ()));
+      }
+    auto readyLiteral = [&] (unsigned int i, unsigned int t) {
+      if (t < earliestVector[i])
+        return falseLiteral;
+      if (t >= latestVector[i])
+        return implementedVector[i];
+      return readyVector[i][t - earliestVector[i]];
+    };
+    for (unsigned int i = 0; i < numNodes; i++)
+      {
+        std::vector<unsigned int> clause = { implementedVector[i] ^ 1 };
+        clause.insert (clause.end (), selectedVector[i].begin (),
+                       selectedVector[i].end ());
+        solver.addClause (clause);
+        for (unsigned int c = 0; c < cutVector[i].size (); c++)
+          {
+            unsigned int selected = selectedVector[i][c];
+            solver.addClause ({ selected ^ 1, implementedVector[i] });
+            for (const auto &leaf : cutVector[i][c])
+              {
+                int j = localIndex (leaf);
+                if (j >= 0)
+                  solver.addClause ({ selected ^ 1, implementedVector[j] });
+              }
+          }
+        for (unsigned int r = 0; r < readyVector[i].size (); r++)
+          {
+            unsigned int t = earliestVector[i] + r;
+            unsigned int ready = readyVector[i][r];
+            solver.addClause ({ ready ^ 1, implementedVector[i] });
+            for (unsigned int c = 0; c < cutVector[i].size (); c++)
+              for (const auto &leaf : cutVector[i][c])
+                {
+                  int j = localIndex (leaf);
+                  if (j >= 0)
+                    solver.addClause ({ ready ^ 1, selectedVector[i][c] ^ 1,
+                                        readyLiteral (j, t - 1) });
+                  else if (_levelVector[leaf] > t - 1)
+                    {
+                      solver.addClause (
+                          { ready ^ 1, selectedVector[i][c] ^ 1 });
+                      break;
+                    }
+                }
+          }
+      }
+    for (const auto &lut : cone.requiredVector)
+      solver.addClause ({ readyLiteral (
+          localIndex (lut), lut == cone.root ? depth : _levelVector[lut]) });
+    if (bound < numNodes)
+      solver.addAtMost (implementedVector, bound);
+
+    SatSolver::Result result = solver.solve (remainingConflicts);
+    remainingConflicts
+        -= std::min (remainingConflicts, solver.getNumConflicts ());
+    if (result != SatSolver::Result::Satisfiable)
+      return result;
+
+    // The lookup tables the required ones depend on
+    cover.lutVector.clear ();
+    std::vector<bool> visited (numNodes, false);
+    std::stack<unsigned int> processingStack;
+    for (const auto &lut : cone.requiredVector)
+      {
+        visited[localIndex (lut)] = true;
+        processingStack.push (localIndex (lut));
+      }
+    while (!processingStack.empty ())
+      {
+        unsigned int i = processingStack.top ();
+        processingStack.pop ();
+        unsigned int c = 0;
+        while (!solver.getValue (selectedVector[i][c] >> 1))
+          c++;
+        cover.lutVector.push_back ({ nodes[i], cutVector[i][c] });
+        for (const auto &leaf : cutVector[i][c])
+          {
+            int j = localIndex (leaf);
+            if (j >= 0 && !visited[j])
+              {
+                visited[j] = true;
+                processingStack.push (j);
+              }
+          }
+      }
+    return result;
+  };
+
+  // Lower the level of the root, then the number of lookup tables
+  ConeCover bestCover;
+  ConeCover cover;
+  unsigned int depth = currentLevel;
+  unsigned int area = cone.lutVector.size ();
+  SatSolver::Result result = SatSolver::Result::Satisfiable;
+  while (depth > earliestVector[rootIndex] && remainingConflicts > 0)
+    {
+      result = solve (depth - 1, numNodes, cover);
+      if (result != SatSolver::Result::Satisfiable)
+        break;
+      depth--;
+      area = cover.lutVector.size ();
+      bestCover.lutVector = cover.lutVector;
+      bestCover.improved = true;
+    }
+  while (result != SatSolver::Result::Unknown && area > 1
+         && remainingConflicts > 0)
+    {
+      result = solve (depth, area - 1, cover);
+      if (result != SatSolver::Result::Satisfiable)
+        break;
+      area = cover.lutVector.size ();
+      bestCover.lutVector = cover.lutVector;
+      bestCover.improved = true;
+    }
+  bestCover.overBudget
+      = result == SatSolver::Result::Unknown || remainingConflicts == 0;
+  std::sort (bestCover.lutVector.begin (), bestCover.lutVector.end ());
+  return bestCover;
+}
+
+bool
+ExactRemapper::applyCover (const Cone &cone, const ConeCover &cover,
+                           std::vector<bool> &touchedVector)
+{
+  if (std::any_of (cone.nodeVector.begin (), cone.nodeVector.end (),
+                   [&touchedVector] (unsigned int node) {
+                     return touchedVector[node];
+                   }))
+    return false;
+  for (const auto &[lut, inputs] : cover.lutVector)
+    for (const auto &input : inputs)
+      if (!std::binary_search (cone.nodeVector.begin (),
+                               cone.nodeVector.end (), input)
+          && !_isLutVector[input]
+          && _aig.nodeIsAnd (AndInverterGraph::literalFromIndex (input)))
+        return false;
+
+  for (const auto &lut : cone.lutVector)
+    {
+      _isLutVector[lut] = false;
+      _lutInputVector[lut].clear ();
+    }
+  for (const auto &[lut, inputs] : cover.lutVector)
+    {
+      _isLutVector[lut] = true;
+      _lutInputVector[lut] = inputs;
+      for (const auto &input : inputs)
+        touchedVector[input] = true;
+    }
+  for (const auto &node : cone.nodeVector)
+    touchedVector[node] = true;
+  return true;
+}
+
+void
+ExactRemapper::run ()
+{
+  for (unsigned int pass = 0; pass < MaxPasses; pass++)
+    {
+      evaluateTiming ();
+
+      // Cones of the critical lookup tables, from the outputs down
+      std::vector<unsigned int> criticalVector;
+      for (const auto &lut : _topologicalOrder)
+        if (_levelVector[lut] == _requiredLevelVector[lut]
+            && !_lutInputVector[lut].empty ())
+          criticalVector.push_back (lut);
+      std::sort (criticalVector.begin (), criticalVector.end (),
+                 [this] (unsigned int a, unsigned int b) {
+                   return _levelVector[a] != _levelVector[b]
+                              ? _levelVector[a] > _levelVector[b]
+                              : a > b;
+                 });
+      std::vector<bool> inCone (_isLutVector.size (), false);
+      std::vector<Cone> coneVector;
+      for (const auto &root : criticalVector)
+        {
+          if (coneVector.size () == MaxConesPerPass)
+            break;
+          if (inCone[root])
+            continue;
+          Cone cone = buildCone (root);
+          if (cone.lutVector.empty ())
+            continue;
+          for (const auto &lut : cone.lutVector)
+            inCone[lut] = true;
+          coneVector.push_back (std::move (cone));
+        }
+
+      std::vector<ConeCover> coverVector (coneVector.size ());
+      std::atomic<unsigned int> nextCone (0);
+      runOnThreads ([&] (unsigned int) {
+        for (unsigned int i = nextCone++; i < coneVector.size ();
+             i = nextCone++)
+          coverVector[i] = solveCone (coneVector[i]);
+      });
+
+      // Covers are applied in the order of the cones, so that the result
+      // does not depend on the threads
+      std::vector<bool> touchedVector (_isLutVector.size (), false);
+      bool changed = false;
+      for (unsigned int i = 0; i < coneVector.size (); i++)
+        {
+          _numCones++;
+          if (coverVector[i].overBudget)
+            _numConesOverBudget++;
+          if (coverVector[i].improved
+              && applyCover (coneVector[i], coverVector[i], touchedVector))
+            {
+              _numRemappedCones++;
+              changed = true;
+            }
+        }
+      if (!changed)
+        break;
+    }
+  evaluateTiming ();
+}
+
+unsigned int
+ExactRemapper::getMappingAreaCost () const noexcept
+{
+  return _mappingAreaCost;
+}
+
+unsigned int
+ExactRemapper::getMappingDelayCost () const noexcept
+{
+  return _mappingDelayCost;
+}
+
+unsigned int
+ExactRemapper::getNumCones () const noexcept
+{
+  return _numCones;
+}
+
+unsigned int
+ExactRemapper::getNumRemappedCones () const noexcept
+{
+  return _numRemappedCones;
+}
+
+unsigned int
+ExactRemapper::getNumConesOverBudget () const noexcept
+{
+  return _numConesOverBudget;
+}
+
+std::uint64_t
+ExactRemapper::getFingerprint () const
+{
+  // 64-bit FNV-1a, as in TechMapperBase::getFingerprint()
+  std::uint64_t fingerprint = 0xcbf29ce484222325ULL;
+  auto hashWord = [&fingerprint] (std::uint32_t word) {
+    for (unsigned int i = 0; i < 4; i++)
+      {
+        fingerprint ^= (word >> (8 * i)) & 0xff;
+        fingerprint *= 0x100000001b3ULL;
+      }
+  };
+  for (unsigned int node = 0; node < _isLutVector.size (); node++)
+    if (_isLutVector[node])
+      {
+        hashWord (AndInverterGraph::literalFromIndex (node));
+        hashWord (_lutInputVector[node].size ());
+        for (const auto &input : _lutInputVector[node])
+          hashWord (input);
+      }
+  return fingerprint;
+}
+
+void
+ExactRemapper::printResults (std::ostream &os) const
+{
+  os << ">> Exact remapping results" << std::endl;
+  os << "# LUT count: " << _mappingAreaCost << std::endl;
+  os << "# Levels: " << _mappingDelayCost << std::endl;
+  os << "# Cones: " << _numCones << std::endl;
+  os << "# Remapped cones: " << _numRemappedCones << std::endl;
+  os << "# Cones over budget: " << _numConesOverBudget << std::endl;
+  std::ios_base::fmtflags flags = os.flags ();
+  os << "# Fingerprint: " << std::hex << std::setw (16) << std::setfill ('0')
+     << getFingerprint () << std::setfill (' ') << std::endl;
+  os.flags (flags);
+}
+
+void
+ExactRemapper::writeReport (JsonWriter &writer) const
+{
+  std::ostringstream fingerprint;
+  fingerprint << std::hex << std::setw (16) << std::setfill ('0')
+              << getFingerprint ();
+  writer.key ("lutCount").value (_mappingAreaCost);
+  writer.key ("levels").value (_mappingDelayCost);
+  writer.key ("conflictBudget").value (_conflictBudget);
+  writer.key ("cones").value (_numCones);
+  writer.key ("remappedCones").value (_numRemappedCones);
+  writer.key ("conesOverBudget").value (_numConesOverBudget);
+  writer.key ("fingerprint").value (fingerprint.str ());
+}
+
+void
+ExactRemapper::printImplementation (std::ostream &os) const
+{
+  os << ">> Exact remapping cover: " << std::endl;
+  for (unsigned int node = 0; node < _isLutVector.size (); node++)
+    if (_isLutVector[node])
+      {
+        const std::vector<unsigned int> &inputs = _lutInputVector[node];
+        os << "(" << AndInverterGraph::literalFromIndex (node) << ") => ( ";
+        for (const auto &input : inputs)
+          os << AndInverterGraph::literalFromIndex (input) << " ";
+        os << ")";
+        if (inputs.size () <= TruthTable::MaxVariables)
+          os << " : function = "
+             << LutNetwork::coneFunction (_aig, node, inputs);
+        os << std::endl;
+      }
+}
@@ -0,0 +1,472 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/FlowMapEngine.h"
+#include "../include/AllocationTracker.h"
+
+#include <algorithm>
+
+FlowMapEngine::FlowMapEngine (const AndInverterGraph &aig, unsigned int k)
+    : _aig (aig), _k (k)
+{
+  // Integrity check
+  if (_k < 2)
+    throw std::runtime_error (
+        "Runtime error (FlowMapEngine constructor): value of parameter k "
+        "(number of lut inputs) must be greater than 1.");
+
+  // Memory allocation and vector initialization
+  try
+    {
+      _cutSetVector.clear ();
+      _cutSetVector.reserve (_aig.getNumAnds ());
+      _cutSetVector.insert (_cutSetVector.begin (), _aig.getNumAnds (), {});
+      _labelVector.assign (_aig.getMaxVariableIndex () + 1, 0);
+      unsigned int firstAndVariable
+          = AndInverterGraph::indexFromLiteral (_aig.getFirstAndLiteral ());
+      for (unsigned int i = firstAndVariable; i <= _aig.getMaxVariableIndex ();
+           i++)
+        _labelVector[i] = NoLabel;
+      _coneStamp.assign (_aig.getMaxVariableIndex () + 1, 0);
+      _vertexOfVariable.assign (_aig.getMaxVariableIndex () + 1, 0);
+    }
+  catch (const std::exception &e)
+    {
+      throw std::runtime_error (
+          "Failed to initialize FlowMapEngine object from '"
+          + _aig.getFilePath () + "'.\n what(): " + e.what ());
+    }
+}
+
+const AndInverterGraph &
+FlowMapEngine::getAndInverterGraph () const noexcept
+{
+  return _aig;
+}
+
+unsigned int
+FlowMapEngine::getLabel (unsigned int nodeLiteral) const
+{
+  unsigned int nodeVariable = AndInverterGraph::indexFromLiteral (nodeLiteral);
+  if (nodeVariable >= _labelVector.size ())
+    throw std::runtime_error (
+        "Runtime error (getLabel): the value provided in nodeLiteral argument "
+        "is not a valid literal for the AndInverterGraph object.");
+  if (_labelVector[nodeVariable] == NoLabel)
+    throw std::runtime_error (
+        "Runtime error (getLabel): the and-node has not been labeled yet.");
+  return _labelVector[nodeVariable];
+}
+
+bool
+FlowMapEngine::hasBestCut (unsigned int andLiteral) const
+{
+  if (!_aig.nodeIsAnd (andLiteral))
+    throw std::runtime_error (
+        "Runtime error (hasBestCut): the value provided in andLiteral "
+        "argument is not a valid and-literal for the AndInverterGraph "
+        "object.");
+  return !_cutSetVector.at (vectorIndexFromAndLiteral (andLiteral)).empty ();
+}
+
+const CutSet &
+FlowMapEngine::getCutSet (unsigned int andLiteral) const
+{
+  if (!_aig.nodeIsAnd (andLiteral))
+    throw std::runtime_error (
+        "Runtime error (getCutSet): the value provided in andLiteral argument "
+        "is not a valid and-literal for the AndInverterGraph object.");
+  return _cutSetVector.at (vectorIndexFromAndLiteral (andLiteral));
+}
+
+const Cut &
+FlowMapEngine::getBestCut (unsigned int andLiteral) const
+{
+  if (!hasBestCut (andLiteral))
+    throw std::runtime_error ("Runtime error (getBestCut): the best cut for "
+                              "the and-node has not been defined yet. Call "
+                              "hasBestCut() to check for it before calling "
+                              "getBestCut().");
+  return _cutSetVector.at (vectorIndexFromAndLiteral (andLiteral)).at (0);
+}
+
+const CutSet &
+FlowMapEngine::findCuts (const unsigned int &andLiteral)
+{
+  TMAP_ALLOCATION_SUBSYSTEM ("flowmap labeling");
+
+  // Throw an exception if the value provided in andLiteral is not a valid AND
+  // node literal
+  if (!_aig.nodeIsAnd (andLiteral))
+    throw std::runtime_error (
+        "Runtime error (findCuts): value provided in andLiteral argument "
+        "is not a valid and-literal for the AndInverterGraph object.");
+
+  // Collect the unlabeled and-nodes in the transitive fanin of andLiteral
+  unsigned int rootVariable = AndInverterGraph::indexFromLiteral (andLiteral);
+  std::vector<unsigned int> unlabeledVariables;
+  std::vector<unsigned int> processingStack = { rootVariable };
+  _currentStamp++;
+  _coneStamp[rootVariable] = _currentStamp;
+  while (!processingStack.empty ())
+    {
+      unsigned int currentVariable = processingStack.back ();
+      processingStack.pop_back ();
+      if (_labelVector[currentVariable] != NoLabel)
+        continue;
+      unlabeledVariables.push_back (currentVariable);
+      const AndNode &an = _aig.getAndNodeFromLiteral (
+          AndInverterGraph::literalFromIndex (currentVariable));
+      for (unsigned int childLiteral :
+           { an.getFirstChild (), an.getSecondChild () })
+        {
+          unsigned int childVariable
+              = AndInverterGraph::indexFromLiteral (childLiteral);
+          if (_aig.nodeIsAnd (childLiteral)
+              && _coneStamp[childVariable] != _currentStamp)
+            {
+              _coneStamp[childVariable] = _currentStamp;
+              processingStack.push_back (childVariable);
+            }
+        }
+    }
+
+  // And-nodes are stored in topological order, so labeling them by
+  // increasing variable index guarantees that fanins are labeled first
+  std::sort (unlabeledVariables.begin (), unlabeledVariables.end ());
+  if (_progress)
+    _progress->addNodes (unlabeledVariables.size ());
+  for (const auto &andVariable : unlabeledVariables)
+    {
+      stopIfCancelled ();
+      labelNode (andVariable);
+      if (_progress)
+        _progress->nodeDone ();
+    }
+
+  return _cutSetVector.at (vectorIndexFromAndLiteral (andLiteral));
+}
+
+void
+FlowMapEngine::run ()
+{
+  for (const auto &outputLiteral : _aig.getOutputLiteralVector ())
+    if (_aig.nodeIsAnd (outputLiteral))
+      this->findCuts (outputLiteral);
+}
+
+void
+FlowMapEngine::setProgress (MappingProgress *progress) noexcept
+{
+  _progress = progress;
+}
+
+void
+FlowMapEngine::stopIfCancelled ()
+{
+  if (!_progress || !_progress->isCancelled ())
+    return;
+  for (auto &cutSet : _cutSetVector)
+    cutSet = CutSet ();
+  unsigned int firstAndVariable
+      = AndInverterGraph::indexFromLiteral (_aig.getFirstAndLiteral ());
+  std::fill (_labelVector.begin () + firstAndVariable, _labelVector.end (),
+             NoLabel);
+  _flowPathVector.clear ();
+  _flowHeight = NoLabel;
+  throw MappingCancelled (_progress->isPastDeadline ()
+                              ? "Mapping cancelled: the deadline has passed."
+                              : "Mapping cancelled.");
+}
+
+unsigned int
+FlowMapEngine::vectorIndexFromAndLiteral (unsigned int andLiteral) const
+{
+  unsigned int vectorIndex = _aig.indexFromLiteral (andLiteral)
+                             - _aig.getNumInputs () - _aig.getNumLatches ()
+                             - 1;
+  if (vectorIndex >= _cutSetVector.size ())
+    throw std::overflow_error (
+        "Range overflow. Index used to access _cutSetVector is greater or "
+        "equal its size.");
+  else
+    return vectorIndex;
+}
+
+void
+FlowMapEngine::labelNode (unsigned int andVariable)
+{
+  const AndNode &an = _aig.getAndNodeFromLiteral (
+      AndInverterGraph::literalFromIndex (andVariable));
+  unsigned int firstChildVariable
+      = AndInverterGraph::indexFromLiteral (an.getFirstChild ());
+  unsigned int secondChildVariable
+      = AndInverterGraph::indexFromLiteral (an.getSecondChild ());
+  unsigned int height = std::max (_labelVector[firstChildVariable],
+                                  _labelVector[secondChildVariable]);
+
+  std::set<unsigned int> cutVariables;
+  unsigned int label = height;
+
+  // Fanins are all sources: the node needs its own lookup table
+  if (height == 0)
+    {
+      cutVariables = { firstChildVariable, secondChildVariable };
+      label = 1;
+    }
+  else
+    {
+      // Cheap test: merge the cuts of the fanins with label p
+      for (unsigned int childVariable :
+           { firstChildVariable, secondChildVariable })
+        {
+          unsigned int childLiteral
+              = AndInverterGraph::literalFromIndex (childVariable);
+          if (_aig.nodeIsAnd (childLiteral)
+              && _labelVector[childVariable] == height)
+            for (const auto &leafVariable : getBestCut (childLiteral))
+              cutVariables.insert (leafVariable);
+          else
+            cutVariables.insert (childVariable);
+        }
+
+      // Expensive test: max-flow on the fanin cone
+      if (cutVariables.size () > _k)
+        {
+          cutVariables.clear ();
+          if (!findMinCut (andVariable, height, cutVariables))
+            {
+              cutVariables = { firstChildVariable, secondChildVariable };
+              label = height + 1;
+            }
+        }
+    }
+
+  // Stores the cut. Its delay cost is the label; its area cost is the single
+  // lookup table that implements it
+  CutSet cutSet;
+  cutSet.emplace (Cut (cutVariables,
+                       1,     // area cost
+                       label, // delay cost
+                       0));   // power cost
+  _cutSetVector.at (vectorIndexFromAndLiteral (
+      AndInverterGraph::literalFromIndex (andVariable)))
+      = cutSet;
+  _labelVector[andVariable] = label;
+}
+
+bool
+FlowMapEngine::findMinCut (unsigned int andVariable, unsigned int height,
+                           std::set<unsigned int> &cutVariables)
+{
+  // Collect the fanin cone of the node
+  _currentStamp++;
+  _coneVector.clear ();
+  _coneVector.push_back (andVariable);
+  _coneStamp[andVariable] = _currentStamp;
+  for (std::size_t i = 0; i < _coneVector.size (); i++)
+    {
+      unsigned int nodeLiteral
+          = AndInverterGraph::literalFromIndex (_coneVector[i]);
+      if (!_aig.nodeIsAnd (nodeLiteral))
+        continue;
+      const AndNode &an = _aig.getAndNodeFromLiteral (nodeLiteral);
+      for (unsigned int childLiteral :
+           { an.getFirstChild (), an.getSecondChild () })
+        {
+          unsigned int childVariable
+              = AndInverterGraph::indexFromLiteral (childLiteral);
+          if (_coneStamp[childVariable] != _currentStamp)
+            {
+              _coneStamp[childVariable] = _currentStamp;
+              _coneVector.push_back (childVariable);
+            }
+        }
+    }
+
+  // The node and the and-nodes with label p are collapsed into the sink
+  auto isCollapsed = [&] (unsigned int variable) {
+    return variable == andVariable
+           || (_aig.nodeIsAnd (AndInverterGraph::literalFromIndex (variable))
+               && _labelVector[variable] == height);
+  };
+
+  // Vertex 0 is the source and vertex 1 the sink. Every other node of the
+  // cone is split into an input and an output vertex joined by an edge of
+  // capacity 1, so that the min-cut counts nodes rather than edges
+  const unsigned int source = 0;
+  const unsigned int sink = 1;
+  const unsigned int infinity = -1;
+  unsigned int numVertices = 2;
+  for (const auto &variable : _coneVector)
+    if (!isCollapsed (variable))
+      {
+        _vertexOfVariable[variable] = numVertices;
+        numVertices += 2;
+      }
+  _edgeHead.assign (numVertices, -1);
+  _edgeNext.clear ();
+  _edgeTarget.clear ();
+  _edgeCapacity.clear ();
+  for (const auto &variable : _coneVector)
+    {
+      unsigned int nodeLiteral = AndInverterGraph::literalFromIndex (variable);
+      bool collapsed = isCollapsed (variable);
+      if (!collapsed)
+        {
+          unsigned int inVertex = _vertexOfVariable[variable];
+          addFlowEdge (inVertex, inVertex + 1, 1);
+          if (!_aig.nodeIsAnd (nodeLiteral))
+            addFlowEdge (source, inVertex, infinity);
+        }
+      if (!_aig.nodeIsAnd (nodeLiteral))
+        continue;
+      const AndNode &an = _aig.getAndNodeFromLiteral (nodeLiteral);
+      for (unsigned int childLiteral :
+           { an.getFirstChild (), an.getSecondChild () })
+        {
+          unsigned int childVariable
+              = AndInverterGraph::indexFromLiteral (childLiteral);
+          if (isCollapsed (childVariable))
+            continue;
+          unsigned int childOutVertex = _vertexOfVariable[childVariable] + 1;
+          addFlowEdge (childOutVertex,
+                       collapsed ? sink : _vertexOfVariable[variable],
+                       infinity);
+        }
+    }
+
+  // Start from the flow of the last node with a K-feasible cut if it is in
+  // the cone with label p: its network is a subgraph of this one, with the
+  // same source and sink. The residual network of any maximum flow gives the
+  // same min-cut, so the cut does not depend on the starting flow
+  unsigned int flow = 0;
+  if (_flowHeight == height && _coneStamp[_flowVariable] == _currentStamp)
+    for (const auto &path : _flowPathVector)
+      {
+        unsigned int vertex = source;
+        for (const auto &variable : path)
+          {
+            pushFlow (vertex, _vertexOfVariable[variable]);
+            pushFlow (_vertexOfVariable[variable],
+                      _vertexOfVariable[variable] + 1);
+            vertex = _vertexOfVariable[variable] + 1;
+          }
+        pushFlow (vertex, sink);
+        flow++;
+      }
+
+  // Augment one unit of flow at a time along shortest residual paths. The
+  // search stops as soon as the flow exceeds K, since then no K-feasible cut
+  // with label p exists
+  while (true)
+    {
+      _parentEdge.assign (numVertices, -1);
+      _parentEdge[source] = -2;
+      _bfsQueue.clear ();
+      _bfsQueue.push_back (source);
+      bool reachedSink = false;
+      for (std::size_t i = 0; i < _bfsQueue.size () && !reachedSink; i++)
+        {
+          unsigned int vertex = _bfsQueue[i];
+          for (int edge = _edgeHead[vertex]; edge != -1;
+               edge = _edgeNext[edge])
+            {
+              unsigned int target = _edgeTarget[edge];
+              if (_edgeCapacity[edge] == 0 || _parentEdge[target] != -1)
+                continue;
+              _parentEdge[target] = edge;
+              if (target == sink)
+                {
+                  reachedSink = true;
+                  break;
+                }
+              _bfsQueue.push_back (target);
+            }
+        }
+      if (!reachedSink)
+        break;
+
+      for (unsigned int vertex = sink; vertex != source;)
+        {
+          int edge = _parentEdge[vertex];
+          _edgeCapacity[edge]--;
+          _edgeCapacity[edge ^ 1]++;
+          vertex = _edgeTarget[edge ^ 1];
+        }
+      if (++flow > _k)
+        return false;
+    }
+
+  // The cut nodes are those whose input vertex is reachable from the source
+  // in the residual network but whose output vertex is not
+  for (const auto &variable : _coneVector)
+    if (!isCollapsed (variable))
+      {
+        unsigned int inVertex = _vertexOfVariable[variable];
+        if (_parentEdge[inVertex] != -1 && _parentEdge[inVertex + 1] == -1)
+          cutVariables.insert (variable);
+      }
+
+  // Keep the flow: each unit leaves the source on its own path, and the
+  // flow of an edge is the capacity of its residual edge
+  std::vector<unsigned int> variableOfVertex (numVertices);
+  for (const auto &variable : _coneVector)
+    if (!isCollapsed (variable))
+      variableOfVertex[_vertexOfVariable[variable] + 1] = variable;
+  auto nextVertex = [&] (unsigned int vertex) {
+    for (int edge = _edgeHead[vertex]; edge != -1; edge = _edgeNext[edge])
+      if (edge % 2 == 0 && _edgeCapacity[edge ^ 1] > 0)
+        return _edgeTarget[edge];
+    return sink;
+  };
+  _flowPathVector.clear ();
+  for (int edge = _edgeHead[source]; edge != -1; edge = _edgeNext[edge])
+    if (_edgeCapacity[edge ^ 1] > 0)
+      {
+        std::vector<unsigned int> path;
+        for (unsigned int vertex = _edgeTarget[edge]; vertex != sink;
+             vertex = nextVertex (vertex + 1))
+          path.push_back (variableOfVertex[vertex + 1]);
+        _flowPathVector.push_back (std::move (path));
+      }
+  _flowVariable = andVariable;
+  _flowHeight = height;
+  return true;
+}
+
+void
+FlowMapEngine::addFlowEdge (unsigned int from, unsigned int to,
+                            unsigned int capacity)
+{
+  _edgeTarget.push_back (to);
+  _edgeCapacity.push_back (capacity);
+  _edgeNext.push_back (_edgeHead[from]);
+  _edgeHead[from] = _edgeTarget.size () - 1;
+
+  _edgeTarget.push_back (from);
+  _edgeCapacity.push_back (0);
+  _edgeNext.push_back (_edgeHead[to]);
+  _edgeHead[to] = _edgeTarget.size () - 1;
+}
+
+void
+FlowMapEngine::pushFlow (unsigned int from, unsigned int to)
+{
+  for (int edge = _edgeHead[from]; edge != -1; edge = _edgeNext[edge])
+    if (edge % 2 == 0 && _edgeTarget[edge] == to)
+      {
+        _edgeCapacity[edge]--;
+        _edgeCapacity[edge ^ 1]++;
+        return;
+      }
+  throw std::runtime_error ("Runtime error (pushFlow): the flow network has "
+                            "no edge between the vertices.");
+}
@@ -0,0 +1,556 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/HierarchicalMapper.h"
+#include "../include/TechMapper.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+HierarchicalMapper::HierarchicalMapper (const std::string &manifestPath,
+                                        MappingGoal mappingGoal,
+                                        unsigned int k, unsigned int c)
+    : _manifestPath (manifestPath), _mappingGoal (mappingGoal), _k (k), _c (c)
+{
+  parseManifest ();
+}
+
+void
+HierarchicalMapper::setBoundaryRemapping (bool boundaryRemapping) noexcept
+{
+  _boundaryRemapping = boundaryRemapping;
+}
+
+void
+HierarchicalMapper::setNumThreads (unsigned int numThreads) noexcept
+{
+  _numThreads = std::max (1u, numThreads);
+}
+
+void
+HierarchicalMapper::setSupportReduction (bool supportReduction) noexcept
+{
+  _supportReduction = supportReduction;
+}
+
+void
+HierarchicalMapper::parseManifest ()
+{
+  std::ifstream manifestFile (_manifestPath);
+  if (!manifestFile.is_open ())
+    throw std::runtime_error ("Unable to open '" + _manifestPath + "'");
+  std::filesystem::path directory
+      = std::filesystem::path (_manifestPath).parent_path ();
+
+  std::string line;
+  unsigned int lineNumber = 0;
+  auto parseError = [&] (const std::string &message) {
+    return std::runtime_error ("In " + _manifestPath + ", line "
+                               + std::to_string (lineNumber) + ": "
+                               + message);
+  };
+  auto findModule = [&] (const std::string &name) {
+    for (unsigned int i = 0; i < _moduleVector.size (); i++)
+      if (_moduleVector[i].name == name)
+        return i;
+    throw parseError ("unknown module '" + name + "'.");
+  };
+  auto findInstance = [&] (const std::string &name) {
+    for (unsigned int i = 0; i < _instanceVector.size (); i++)
+      if (_instanceVector[i].name == name)
+        return i;
+    throw parseError ("unknown instance '" + name + "'.");
+  };
+
+  // Ports are written <instance>.<port>
+  auto parsePort = [&] (const std::string &text, bool isInput) {
+    std::size_t dot = text.find ('.');
+    if (dot == std::string::npos)
+      throw parseError ("expected <instance>.<port>, found '" + text + "'.");
+    unsigned int instance = findInstance (text.substr (0, dot));
+    const Module &module = _moduleVector[_instanceVector[instance].module];
+    try
+      {
+        std::string port = text.substr (dot + 1);
+        return PortReference{ instance, findPort (module, port, isInput) };
+      }
+    catch (const std::runtime_error &e)
+      {
+        throw parseError (e.what ());
+      }
+  };
+
+  std::vector<std::vector<bool>> consumedVector;
+  while (std::getline (manifestFile, line))
+    {
+      lineNumber++;
+      std::istringstream statement (line.substr (0, line.find ('#')));
+      std::string keyword, first, second, extra;
+      if (!(statement >> keyword))
+        continue;
+      statement >> first >> second;
+      if (statement >> extra)
+        throw parseError ("unexpected '" + extra + "'.");
+
+      if (keyword == "module")
+        {
+          if (second.empty ())
+            throw parseError ("expected module <name> <file>.");
+          for (const auto &module : _moduleVector)
+            if (module.name == first)
+              throw parseError ("module '" + first + "' is already defined.");
+          std::filesystem::path filePath (second);
+          if (filePath.is_relative ())
+            filePath = directory / filePath;
+          Module module;
+          module.name = first;
+          module.aig = std::make_unique<AndInverterGraph> (filePath.string ());
+          _moduleVector.push_back (std::move (module));
+        }
+      else if (keyword == "instance")
+        {
+          if (second.empty ())
+            throw parseError ("expected instance <name> <module>.");
+          for (const auto &instance : _instanceVector)
+            if (instance.name == first)
+              throw parseError ("instance '" + first
+                                + "' is already defined.");
+          Instance instance;
+          instance.name = first;
+          instance.module = findModule (second);
+          const AndInverterGraph &aig = *_moduleVector[instance.module].aig;
+          instance.inputDriverVector.assign (aig.getNumInputs (),
+                                             { Unconnected, 0 });
+          instance.primaryOutputVector.assign (aig.getNumOutputs (), false);
+          consumedVector.emplace_back (aig.getNumOutputs (), false);
+          _instanceVector.push_back (std::move (instance));
+        }
+      else if (keyword == "connect")
+        {
+          if (second.empty ())
+            throw parseError (
+                "expected connect <instance>.<input> <instance>.<output>.");
+          PortReference sink = parsePort (first, true);
+          PortReference driver = parsePort (second, false);
+          PortReference &inputDriver
+              = _instanceVector[sink.instance].inputDriverVector[sink.port];
+          if (inputDriver.instance != Unconnected)
+            throw parseError ("input '" + first + "' is already connected.");
+          inputDriver = driver;
+          consumedVector[driver.instance][driver.port] = true;
+        }
+      else if (keyword == "output")
+        {
+          if (first.empty () || !second.empty ())
+            throw parseError ("expected output <instance>.<output>.");
+          PortReference output = parsePort (first, false);
+          _instanceVector[output.instance]
+              .primaryOutputVector[output.port]
+              = true;
+        }
+      else
+        throw parseError ("unknown statement '" + keyword + "'.");
+    }
+  if (_instanceVector.empty ())
+    throw std::runtime_error ("In " + _manifestPath
+                              + ": the design has no instances.");
+
+  // Outputs that drive no instance are primary outputs
+  for (unsigned int i = 0; i < _instanceVector.size (); i++)
+    for (unsigned int o = 0; o < consumedVector[i].size (); o++)
+      if (!consumedVector[i][o])
+        _instanceVector[i].primaryOutputVector[o] = true;
+}
+
+unsigned int
+HierarchicalMapper::findPort (const Module &module, const std::string &port,
+                              bool isInput) const
+{
+  const AndInverterGraph &aig = *module.aig;
+  unsigned int numPorts = isInput ? aig.getNumInputs () : aig.getNumOutputs ();
+  for (unsigned int i = 0; i < numPorts; i++)
+    if ((isInput ? aig.getInputName (i) : aig.getOutputName (i)) == port)
+      return i;
+  if (!port.empty ()
+      && std::all_of (port.begin (), port.end (), [] (char character) {
+           return std::isdigit (static_cast<unsigned char> (character));
+         }))
+    {
+      unsigned long index = std::stoul (port);
+      if (index < numPorts)
+        return index;
+    }
+  throw std::runtime_error ("module '" + module.name + "' has no "
+                            + (isInput ? "input" : "output") + " '" + port
+                            + "'.");
+}
+
+void
+HierarchicalMapper::mapModule (Module &module)
+{
+  const AndInverterGraph &aig = *module.aig;
+  CutEngine cutEngine (aig, _mappingGoal, _k, _c);
+  cutEngine.setSupportReduction (_supportReduction);
+  cutEngine.setNumThreads (_numThreads);
+  TechMapper techMapper (cutEngine);
+  techMapper.setNumThreads (_numThreads);
+  techMapper.run ();
+  module.numLuts = techMapper.getMappingAreaCost ();
+  module.fingerprint = techMapper.getFingerprint ();
+
+  // Lookup tables of the cover, in topological order. Inputs are the
+  // variables 1 to the number of inputs
+  std::vector<unsigned int> lutVector;
+  for (unsigned int i = 0; i < aig.getNumAnds (); i++)
+    {
+      unsigned int andLiteral = aig.getFirstAndLiteral () + 2 * i;
+      if (techMapper.isImplemented (andLiteral))
+        lutVector.push_back (andLiteral);
+    }
+  auto isInputVariable = [&] (unsigned int variable) {
+    return variable >= 1 && variable <= aig.getNumInputs ();
+  };
+
+  // Tables fed by each input, and uses of each node other than by the
+  // output it drives
+  module.inputVector.assign (aig.getNumInputs (), InputCover ());
+  std::vector<unsigned int> useVector (aig.getMaxVariableIndex () + 1, 0);
+  auto addConsumer = [&] (unsigned int variable, unsigned int key,
+                          unsigned int numLeaves) {
+    useVector[variable]++;
+    if (!isInputVariable (variable))
+      return;
+    InputCover &input = module.inputVector[variable - 1];
+    input.numConsumers++;
+    input.consumerKey = key;
+    input.consumerNumLeaves = numLeaves;
+  };
+  for (const auto &lut : lutVector)
+    {
+      const Cut &cut = cutEngine.getSelectedCut (lut);
+      for (const auto &leafVariable : cut)
+        addConsumer (leafVariable, lut, cut.numNodeVariables ());
+    }
+  const std::vector<unsigned int> &outputs = aig.getOutputLiteralVector ();
+  for (unsigned int o = 0; o < outputs.size (); o++)
+    {
+      if (aig.nodeIsInput (outputs[o]))
+        addConsumer (AndInverterGraph::indexFromLiteral (outputs[o]),
+                     aig.getFirstAndLiteral () + 2 * aig.getNumAnds () + o, 1);
+      else
+        useVector[AndInverterGraph::indexFromLiteral (outputs[o])]++;
+    }
+
+  // Levels to each node from one input at a time, and from the latches
+  auto evaluateDepths = [&] (const std::vector<unsigned int> &sources) {
+    std::vector<int> depthVector (aig.getMaxVariableIndex () + 1, -1);
+    for (const auto &source : sources)
+      depthVector[source] = 0;
+    for (const auto &lut : lutVector)
+      {
+        int depth = -1;
+        for (const auto &leafVariable : cutEngine.getSelectedCut (lut))
+          depth = std::max (depth, depthVector[leafVariable]);
+        if (depth >= 0)
+          depthVector[AndInverterGraph::indexFromLiteral (lut)] = depth + 1;
+      }
+    return depthVector;
+  };
+  module.outputVector.assign (outputs.size (), OutputCover ());
+  for (unsigned int o = 0; o < outputs.size (); o++)
+    {
+      OutputCover &output = module.outputVector[o];
+      output.inputDepthVector.assign (aig.getNumInputs (), -1);
+      unsigned int variable = AndInverterGraph::indexFromLiteral (outputs[o]);
+      if (aig.nodeIsAnd (outputs[o]))
+        {
+          output.driver = OutputCover::Driver::AndNode;
+          output.numLeaves
+              = cutEngine.getSelectedCut (outputs[o] - outputs[o] % 2)
+                    .numNodeVariables ();
+          output.isShared = useVector[variable] > 1;
+        }
+      else if (aig.nodeIsInput (outputs[o]))
+        {
+          output.driver = OutputCover::Driver::PassThrough;
+          output.numLeaves = 1;
+          output.inputDepthVector[variable - 1] = 1;
+        }
+      else if (outputs[o] < 2)
+        {
+          output.driver = OutputCover::Driver::PassThrough;
+          output.sourceDepth = 1;
+        }
+    }
+  for (unsigned int i = 0; i < aig.getNumInputs (); i++)
+    {
+      std::vector<int> depthVector = evaluateDepths ({ i + 1 });
+      for (unsigned int o = 0; o < outputs.size (); o++)
+        if (module.outputVector[o].driver == OutputCover::Driver::AndNode)
+          module.outputVector[o].inputDepthVector[i] = depthVector
+              [AndInverterGraph::indexFromLiteral (outputs[o])];
+    }
+  std::vector<unsigned int> latchVariables;
+  for (unsigned int i = 0; i < aig.getNumLatches (); i++)
+    latchVariables.push_back (aig.getNumInputs () + 1 + i);
+  std::vector<int> depthVector = evaluateDepths (latchVariables);
+  for (unsigned int o = 0; o < outputs.size (); o++)
+    if (module.outputVector[o].driver == OutputCover::Driver::AndNode)
+      module.outputVector[o].sourceDepth = std::max (
+          0, depthVector[AndInverterGraph::indexFromLiteral (outputs[o])]);
+}
+
+std::vector<unsigned int>
+HierarchicalMapper::sortInstances () const
+{
+  // Kahn's algorithm over the connections
+  std::vector<unsigned int> numPendingVector (_instanceVector.size (), 0);
+  std::vector<std::vector<unsigned int>> sinkVector (_instanceVector.size ());
+  for (unsigned int i = 0; i < _instanceVector.size (); i++)
+    for (const auto &driver : _instanceVector[i].inputDriverVector)
+      if (driver.instance != Unconnected)
+        {
+          numPendingVector[i]++;
+          sinkVector[driver.instance].push_back (i);
+        }
+  std::vector<unsigned int> order;
+  for (unsigned int i = 0; i < _instanceVector.size (); i++)
+    if (numPendingVector[i] == 0)
+      order.push_back (i);
+  for (std::size_t next = 0; next < order.size (); next++)
+    for (const auto &sink : sinkVector[order[next]])
+      if (--numPendingVector[sink] == 0)
+        order.push_back (sink);
+  if (order.size () != _instanceVector.size ())
+    throw std::runtime_error ("Runtime error (HierarchicalMapper::run): the "
+                              "connections of the instances form a loop.");
+  return order;
+}
+
+void
+HierarchicalMapper::run ()
+{
+  for (auto &module : _moduleVector)
+    mapModule (module);
+  std::vector<unsigned int> order = sortInstances ();
+
+  // Every instance reuses the cover of its module
+  _mappingAreaCost = 0;
+  for (const auto &instance : _instanceVector)
+    _mappingAreaCost += _moduleVector[instance.module].numLuts;
+
+  // Number of inputs each instance output is connected to
+  std::vector<std::vector<unsigned int>> numSinksVector;
+  for (const auto &instance : _instanceVector)
+    numSinksVector.emplace_back (instance.primaryOutputVector.size (), 0);
+  for (const auto &instance : _instanceVector)
+    for (const auto &driver : instance.inputDriverVector)
+      if (driver.instance != Unconnected)
+        numSinksVector[driver.instance][driver.port]++;
+
+  // Boundary remapping, in topological order so that a table that absorbed
+  // the tables before it is merged with its own leaves. A pass-through table
+  // becomes a wire (its sinks absorb a possible inversion); a table driving
+  // a single connection is merged into the single table it feeds if their
+  // leaves fit in K inputs
+  _mergedVector.clear ();
+  std::vector<std::vector<bool>> mergedInputVector;
+  for (const auto &instance : _instanceVector)
+    mergedInputVector.emplace_back (instance.inputDriverVector.size (), false);
+  std::map<std::pair<unsigned int, unsigned int>, unsigned int> extraLeaves;
+  std::vector<std::vector<bool>> removedOutputVector;
+  for (const auto &numSinks : numSinksVector)
+    removedOutputVector.emplace_back (numSinks.size (), false);
+  if (_boundaryRemapping)
+    for (const auto &sink : order)
+      {
+        const Instance &sinkInstance = _instanceVector[sink];
+        const Module &sinkModule = _moduleVector[sinkInstance.module];
+        for (unsigned int i = 0; i < sinkInstance.inputDriverVector.size ();
+             i++)
+          {
+            PortReference driver = sinkInstance.inputDriverVector[i];
+            if (driver.instance == Unconnected
+                || _instanceVector[driver.instance]
+                       .primaryOutputVector[driver.port])
+              continue;
+            const Instance &driverInstance = _instanceVector[driver.instance];
+            const Module &driverModule = _moduleVector[driverInstance.module];
+            const OutputCover &output
+                = driverModule.outputVector[driver.port];
+            const InputCover &input = sinkModule.inputVector[i];
+            if (output.driver == OutputCover::Driver::PassThrough)
+              {
+                mergedInputVector[sink][i] = true;
+                if (removedOutputVector[driver.instance][driver.port])
+                  continue;
+                removedOutputVector[driver.instance][driver.port] = true;
+              }
+            else if (output.driver == OutputCover::Driver::AndNode
+                     && !output.isShared
+                     && numSinksVector[driver.instance][driver.port] == 1
+                     && input.numConsumers == 1)
+              {
+                // A pass-through table that becomes a wire cannot absorb
+                const AndInverterGraph &sinkAig = *sinkModule.aig;
+                unsigned int firstPassThroughKey
+                    = sinkAig.getFirstAndLiteral ()
+                      + 2 * sinkAig.getNumAnds ();
+                if (input.consumerKey >= firstPassThroughKey
+                    && !sinkInstance.primaryOutputVector
+                            [input.consumerKey - firstPassThroughKey])
+                  continue;
+                unsigned int driverKey
+                    = driverModule.aig->getOutputLiteralVector ()[driver.port];
+                driverKey -= driverKey % 2;
+                unsigned int numLeaves
+                    = output.numLeaves
+                      + extraLeaves[{ driver.instance, driverKey }];
+                unsigned int &sinkExtraLeaves
+                    = extraLeaves[{ sink, input.consumerKey }];
+                if (input.consumerNumLeaves + sinkExtraLeaves + numLeaves - 1
+                    > _k)
+                  continue;
+                sinkExtraLeaves += numLeaves - 1;
+                mergedInputVector[sink][i] = true;
+                removedOutputVector[driver.instance][driver.port] = true;
+              }
+            else
+              continue;
+            _mappingAreaCost--;
+            _mergedVector.push_back ({ driver, { sink, i } });
+          }
+      }
+
+  // Arrival level of each instance output. A merged table no longer adds
+  // its level between its leaves and the table it was merged into
+  std::vector<std::vector<int>> arrivalVector (_instanceVector.size ());
+  _mappingDelayCost = 0;
+  for (const auto &current : order)
+    {
+      const Instance &instance = _instanceVector[current];
+      const Module &module = _moduleVector[instance.module];
+      std::vector<int> inputArrivalVector (instance.inputDriverVector.size (),
+                                           0);
+      for (unsigned int i = 0; i < inputArrivalVector.size (); i++)
+        {
+          PortReference driver = instance.inputDriverVector[i];
+          if (driver.instance != Unconnected)
+            inputArrivalVector[i]
+                = std::max (0, arrivalVector[driver.instance][driver.port]
+                                   - (mergedInputVector[current][i] ? 1 : 0));
+        }
+      std::vector<int> &outputArrivalVector = arrivalVector[current];
+      outputArrivalVector.assign (module.outputVector.size (), 0);
+      for (unsigned int o = 0; o < module.outputVector.size (); o++)
+        {
+          const OutputCover &output = module.outputVector[o];
+          int arrival = output.sourceDepth;
+          for (unsigned int i = 0; i < inputArrivalVector.size (); i++)
+            if (output.inputDepthVector[i] >= 0)
+              arrival = std::max (arrival, inputArrivalVector[i]
+                                               + output.inputDepthVector[i]);
+          outputArrivalVector[o] = arrival;
+          if (instance.primaryOutputVector[o])
+            _mappingDelayCost
+                = std::max<unsigned int> (_mappingDelayCost, arrival);
+        }
+    }
+}
+
+unsigned int
+HierarchicalMapper::getMappingAreaCost () const noexcept
+{
+  return _mappingAreaCost;
+}
+
+unsigned int
+HierarchicalMapper::getMappingDelayCost () const noexcept
+{
+  return _mappingDelayCost;
+}
+
+unsigned int
+HierarchicalMapper::getNumMergedLuts () const noexcept
+{
+  return _mergedVector.size ();
+}
+
+unsigned int
+HierarchicalMapper::getNumModules () const noexcept
+{
+  return _moduleVector.size ();
+}
+
+unsigned int
+HierarchicalMapper::getNumInstances () const noexcept
+{
+  return _instanceVector.size ();
+}
+
+std::uint64_t
+HierarchicalMapper::getFingerprint () const
+{
+  // 64-bit FNV-1a, as in TechMapperBase::getFingerprint()
+  std::uint64_t fingerprint = 0xcbf29ce484222325ULL;
+  auto hashWord = [&fingerprint] (std::uint64_t word, unsigned int numBytes) {
+    for (unsigned int i = 0; i < numBytes; i++)
+      {
+        fingerprint ^= (word >> (8 * i)) & 0xff;
+        fingerprint *= 0x100000001b3ULL;
+      }
+  };
+  for (const auto &instance : _instanceVector)
+    {
+      hashWord (_moduleVector[instance.module].fingerprint, 8);
+      for (const auto &driver : instance.inputDriverVector)
+        {
+          hashWord (driver.instance, 4);
+          hashWord (driver.port, 4);
+        }
+    }
+  for (const auto &[driver, sink] : _mergedVector)
+    {
+      hashWord (driver.instance, 4);
+      hashWord (driver.port, 4);
+      hashWord (sink.instance, 4);
+      hashWord (sink.port, 4);
+    }
+  return fingerprint;
+}
+
+void
+HierarchicalMapper::printResults (std::ostream &os) const
+{
+  os << ">> Hierarchical mapping results" << std::endl;
+  for (const auto &module : _moduleVector)
+    {
+      unsigned int numInstances = std::count_if (
+          _instanceVector.begin (), _instanceVector.end (),
+          [&] (const Instance &instance) {
+            return _moduleVector[instance.module].name == module.name;
+          });
+      os << "# Module " << module.name << ": " << module.numLuts
+         << " LUTs, " << numInstances << " instance"
+         << (numInstances == 1 ? "" : "s") << std::endl;
+    }
+  os << "# LUT count: " << _mappingAreaCost << std::endl;
+  os << "# Levels: " << _mappingDelayCost << std::endl;
+  if (_boundaryRemapping)
+    os << "# Merged boundary LUTs: " << _mergedVector.size () << std::endl;
+  std::ios_base::fmtflags flags = os.flags ();
+  os << "# Fingerprint: " << std::hex << std::setw (16) << std::setfill ('0')
+     << getFingerprint () << std::setfill (' ') << std::endl;
+  os.flags (flags);
+}
@@ -0,0 +1,208 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/JsonWriter.h"
+
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+
+JsonWriter::JsonWriter (std::ostream &os) : _os (os) {}
+
+void
+JsonWriter::beginValue ()
+{
+  if (_isComplete)
+    throw std::runtime_error ("Runtime error (JsonWriter): the document is "
+                              "already complete.");
+  if (!_scopeStack.empty () && _scopeStack.back () == Scope::Object)
+    {
+      if (!_hasKey)
+        throw std::runtime_error ("Runtime error (JsonWriter): a value in an "
+                                  "object needs a key.");
+      _hasKey = false;
+      return;
+    }
+  if (!_isFirst)
+    _os << ',';
+  _isFirst = false;
+}
+
+void
+JsonWriter::endScope (Scope scope, char closingCharacter)
+{
+  if (_scopeStack.empty () || _scopeStack.back () != scope || _hasKey)
+    throw std::runtime_error ("Runtime error (JsonWriter): unbalanced "
+                              "object or array.");
+  _scopeStack.pop_back ();
+  _os << closingCharacter;
+  _isFirst = false;
+  if (_scopeStack.empty ())
+    {
+      _os << '\n';
+      _isComplete = true;
+    }
+}
+
+JsonWriter &
+JsonWriter::beginObject ()
+{
+  beginValue ();
+  _os << '{';
+  _scopeStack.push_back (Scope::Object);
+  _isFirst = true;
+  return *this;
+}
+
+JsonWriter &
+JsonWriter::endObject ()
+{
+  endScope (Scope::Object, '}');
+  return *this;
+}
+
+JsonWriter &
+JsonWriter::beginArray ()
+{
+  beginValue ();
+  _os << '[';
+  _scopeStack.push_back (Scope::Array);
+  _isFirst = true;
+  return *this;
+}
+
+JsonWriter &
+JsonWriter::endArray ()
+{
+  endScope (Scope::Array, ']');
+  return *this;
+}
+
+JsonWriter &
+JsonWriter::key (std::string_view name)
+{
+  if (_scopeStack.empty () || _scopeStack.back () != Scope::Object || _hasKey)
+    throw std::runtime_error ("Runtime error (JsonWriter): keys are only "
+                              "written in objects, once per value.");
+  if (!_isFirst)
+    _os << ',';
+  _isFirst = false;
+  writeString (name);
+  _os << ':';
+  _hasKey = true;
+  return *this;
+}
+
+void
+JsonWriter::writeString (std::string_view string)
+{
+  static const char hexDigits[] = "0123456789abcdef";
+  _os << '"';
+  for (const auto &character : string)
+    switch (character)
+      {
+      case '"':
+        _os << "\\\"";
+        break;
+      case '\\':
+        _os << "\\\\";
+        break;
+      case '\n':
+        _os << "\\n";
+        break;
+      case '\r':
+        _os << "\\r";
+        break;
+      case '\t':
+        _os << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char> (character) < 0x20)
+          _os << "\\u00" << hexDigits[character >> 4]
+              << hexDigits[character & 0xf];
+        else
+          _os << character;
+      }
+  _os << '"';
+}
+
+JsonWriter &
+JsonWriter::value (std::string_view string)
+{
+  beginValue ();
+  writeString (string);
+  return *this;
+}
+
+JsonWriter &
+JsonWriter::value (const char *string)
+{
+  return value (std::string_view (string));
+}
+
+JsonWriter &
+JsonWriter::value (bool boolean)
+{
+  beginValue ();
+  _os << (boolean ? "true" : "false");
+  return *this;
+}
+
+JsonWriter &
+JsonWriter::value (int number)
+{
+  beginValue ();
+  _os << number;
+  return *this;
+}
+
+JsonWriter &
+JsonWriter::value (unsigned int number)
+{
+  beginValue ();
+  _os << number;
+  return *this;
+}
+
+JsonWriter &
+JsonWriter::value (std::uint64_t number)
+{
+  beginValue ();
+  _os << number;
+  return *this;
+}
+
+JsonWriter &
+JsonWriter::value (double number)
+{
+  if (!std::isfinite (number))
+    return null ();
+  beginValue ();
+  std::ios_base::fmtflags flags = _os.flags ();
+  std::streamsize precision = _os.precision ();
+  _os << std::defaultfloat << std::setprecision (12) << number;
+  _os.flags (flags);
+  _os.precision (precision);
+  return *this;
+}
+
+JsonWriter &
+JsonWriter::null ()
+{
+  beginValue ();
+  _os << "null";
+  return *this;
+}
+
+bool
+JsonWriter::isComplete () const noexcept
+{
+  return _isComplete;
+}
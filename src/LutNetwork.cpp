@@ -0,0 +1,532 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/LutNetwork.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <stack>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+TruthTable
+LutNetwork::coneFunction (const AndInverterGraph &aig,
+                          unsigned int rootVariable,
+                          const std::vector<unsigned int> &leafVector)
+{
+  std::unordered_map<unsigned int, TruthTable> nodeFunctions;
+  for (unsigned int i = 0; i < leafVector.size (); i++)
+    nodeFunctions.emplace (
+        leafVector[i], TruthTable::nthVariable (leafVector.size (), i));
+  nodeFunctions.emplace (0, TruthTable (leafVector.size ()));
+
+  auto literalFunction = [&] (unsigned int literal) {
+    const TruthTable &function
+        = nodeFunctions.at (AndInverterGraph::indexFromLiteral (literal));
+    return literal % 2 == 1 ? ~function : function;
+  };
+  std::stack<unsigned int> processingStack;
+  processingStack.push (rootVariable);
+  while (!processingStack.empty ())
+    {
+      unsigned int currentVariable = processingStack.top ();
+      if (nodeFunctions.count (currentVariable))
+        {
+          processingStack.pop ();
+          continue;
+        }
+      unsigned int currentLiteral
+          = AndInverterGraph::literalFromIndex (currentVariable);
+      if (!aig.nodeIsAnd (currentLiteral))
+        throw std::runtime_error (
+            "Runtime error (LutNetwork): the inputs of a lookup table do not "
+            "separate its root from the inputs.");
+      const AndNode &an = aig.getAndNodeFromLiteral (currentLiteral);
+      unsigned int firstChildVariable
+          = AndInverterGraph::indexFromLiteral (an.getFirstChild ());
+      unsigned int secondChildVariable
+          = AndInverterGraph::indexFromLiteral (an.getSecondChild ());
+      if (!nodeFunctions.count (firstChildVariable))
+        processingStack.push (firstChildVariable);
+      else if (!nodeFunctions.count (secondChildVariable))
+        processingStack.push (secondChildVariable);
+      else
+        {
+          nodeFunctions.emplace (currentVariable,
+                                 literalFunction (an.getFirstChild ())
+                                     & literalFunction (an.getSecondChild ()));
+          processingStack.pop ();
+        }
+    }
+  return nodeFunctions.at (rootVariable);
+}
+
+LutNetwork::LutNetwork (const MappingEngine &mappingEngine,
+                        const TechMapper &techMapper,
+                        MappingGoal mappingGoal, unsigned int k)
+    : _aig (mappingEngine.getAndInverterGraph ()), _mappingGoal (mappingGoal),
+      _k (k)
+{
+  if (_k > TruthTable::MaxVariables)
+    throw std::runtime_error ("Runtime error (LutNetwork): lookup tables of "
+                              "more than "
+                              + std::to_string (TruthTable::MaxVariables)
+                              + " inputs cannot be resynthesized.");
+
+  // Engines that reduce the support of the selected cuts keep their truth
+  // tables; the others are simulated
+  _lutVector.resize (_aig.getMaxVariableIndex () + 1);
+  for (unsigned int i = 0; i < _aig.getNumAnds (); i++)
+    {
+      unsigned int andLiteral = _aig.getFirstAndLiteral () + 2 * i;
+      if (!techMapper.isImplemented (andLiteral))
+        continue;
+      unsigned int variable = AndInverterGraph::indexFromLiteral (andLiteral);
+      const Cut &selectedCut = mappingEngine.getSelectedCut (andLiteral);
+      Lut &lut = _lutVector[variable];
+      lut.inputVector.assign (selectedCut.begin (), selectedCut.end ());
+      lut.function = selectedCut.hasTruthTable ()
+                         ? selectedCut.getTruthTable ()
+                         : coneFunction (_aig, variable, lut.inputVector);
+      removeVacuousInputs (variable);
+    }
+  evaluateTiming ();
+}
+
+bool
+LutNetwork::isLut (unsigned int node) const noexcept
+{
+  return !_lutVector[node].function.isEmpty ();
+}
+
+void
+LutNetwork::evaluateTiming ()
+{
+  unsigned int numNodes = _lutVector.size ();
+
+  // Live lookup tables in post-order from the outputs
+  std::vector<bool> isLive (numNodes, false);
+  _drivesOutput.assign (numNodes, false);
+  _topologicalOrder.clear ();
+  std::stack<std::pair<unsigned int, unsigned int>> dfsStack;
+  for (const auto &outputLiteral : _aig.getOutputLiteralVector ())
+    {
+      unsigned int outputNode
+          = AndInverterGraph::indexFromLiteral (outputLiteral);
+      if (!isLut (outputNode))
+        continue;
+      _drivesOutput[outputNode] = true;
+      if (isLive[outputNode])
+        continue;
+      isLive[outputNode] = true;
+      dfsStack.push ({ outputNode, 0 });
+      while (!dfsStack.empty ())
+        {
+          auto &[node, nextInput] = dfsStack.top ();
+          const std::vector<unsigned int> &inputs
+              = _lutVector[node].inputVector;
+          if (nextInput == inputs.size ())
+            {
+              _topologicalOrder.push_back (node);
+              dfsStack.pop ();
+              continue;
+            }
+          unsigned int input = inputs[nextInput++];
+          if (isLut (input) && !isLive[input])
+            {
+              isLive[input] = true;
+              dfsStack.push ({ input, 0 });
+            }
+        }
+    }
+  for (unsigned int node = 0; node < numNodes; node++)
+    if (!isLive[node] && isLut (node))
+      _lutVector[node] = Lut ();
+
+  // Levels, fanouts and costs. Outputs driven by an input, GND or VDD are
+  // implemented by one lookup table and lookup tables without inputs are
+  // constant drivers at level 0, as in TechMapper
+  _levelVector.assign (numNodes, 0);
+  _fanoutVector.assign (numNodes, {});
+  _mappingAreaCost = 0;
+  for (const auto &node : _topologicalOrder)
+    {
+      unsigned int level = 0;
+      for (const auto &input : _lutVector[node].inputVector)
+        {
+          level = std::max (level, _levelVector[input]);
+          _fanoutVector[input].push_back (node);
+        }
+      if (!_lutVector[node].inputVector.empty ())
+        {
+          _levelVector[node] = level + 1;
+          _mappingAreaCost++;
+        }
+    }
+  _mappingDelayCost = 0;
+  for (const auto &outputLiteral : _aig.getOutputLiteralVector ())
+    if (_aig.nodeIsAnd (outputLiteral))
+      _mappingDelayCost = std::max (
+          _mappingDelayCost,
+          _levelVector[AndInverterGraph::indexFromLiteral (outputLiteral)]);
+    else if (_aig.nodeIsInput (outputLiteral) || outputLiteral < 2)
+      {
+        _mappingAreaCost++;
+        _mappingDelayCost = std::max (_mappingDelayCost, 1u);
+      }
+
+  // Required levels, from the outputs back
+  _requiredVector.assign (numNodes, _mappingDelayCost);
+  for (auto node = _topologicalOrder.rbegin ();
+       node != _topologicalOrder.rend (); ++node)
+    for (const auto &input : _lutVector[*node].inputVector)
+      _requiredVector[input]
+          = std::min (_requiredVector[input], _requiredVector[*node] - 1);
+}
+
+std::vector<unsigned int>
+LutNetwork::mergedInputs (unsigned int lut, unsigned int fanin) const
+{
+  std::vector<unsigned int> lutInputs = _lutVector[lut].inputVector;
+  lutInputs.erase (std::find (lutInputs.begin (), lutInputs.end (), fanin));
+  const std::vector<unsigned int> &faninInputs
+      = _lutVector[fanin].inputVector;
+  std::vector<unsigned int> inputs;
+  std::set_union (lutInputs.begin (), lutInputs.end (), faninInputs.begin (),
+                  faninInputs.end (), std::back_inserter (inputs));
+  return inputs;
+}
+
+void
+LutNetwork::collapse (unsigned int lut, unsigned int fanin)
+{
+  std::vector<unsigned int> inputs = mergedInputs (lut, fanin);
+  auto position = [&inputs] (unsigned int input) {
+    return std::lower_bound (inputs.begin (), inputs.end (), input)
+           - inputs.begin ();
+  };
+  const Lut &faninLut = _lutVector[fanin];
+  std::vector<unsigned int> faninPositions;
+  for (const auto &input : faninLut.inputVector)
+    faninPositions.push_back (position (input));
+  Lut &rootLut = _lutVector[lut];
+  std::vector<int> lutPositions;
+  for (const auto &input : rootLut.inputVector)
+    lutPositions.push_back (input == fanin ? -1 : position (input));
+
+  // Evaluate the fanin, then the lookup table, for each minterm
+  TruthTable function (inputs.size ());
+  for (unsigned int minterm = 0; minterm < (1u << inputs.size ()); minterm++)
+    {
+      unsigned int faninMinterm = 0;
+      for (unsigned int i = 0; i < faninPositions.size (); i++)
+        faninMinterm |= ((minterm >> faninPositions[i]) & 1) << i;
+      unsigned int faninValue = faninLut.function.getBit (faninMinterm);
+      unsigned int lutMinterm = 0;
+      for (unsigned int i = 0; i < lutPositions.size (); i++)
+        lutMinterm |= (lutPositions[i] < 0
+                           ? faninValue
+                           : (minterm >> lutPositions[i]) & 1)
+                      << i;
+      function.setBit (minterm, rootLut.function.getBit (lutMinterm));
+    }
+  rootLut.inputVector = std::move (inputs);
+  rootLut.function = std::move (function);
+  removeVacuousInputs (lut);
+}
+
+unsigned int
+LutNetwork::decompose (unsigned int lut,
+                       const std::vector<unsigned int> &boundCandidates,
+                       unsigned int minBoundInputs)
+{
+  const std::vector<unsigned int> &inputs = _lutVector[lut].inputVector;
+  unsigned int numInputs = inputs.size ();
+  std::vector<unsigned int> candidatePositions;
+  for (const auto &candidate : boundCandidates)
+    candidatePositions.push_back (
+        std::find (inputs.begin (), inputs.end (), candidate)
+        - inputs.begin ());
+  minBoundInputs = std::max (minBoundInputs, 2u);
+
+  // All the candidates, then all but one
+  for (unsigned int skipped = 0; skipped <= candidatePositions.size ();
+       skipped++)
+    {
+      unsigned int boundMask = 0;
+      for (unsigned int i = 0; i < candidatePositions.size (); i++)
+        if (i + 1 != skipped)
+          boundMask |= 1u << candidatePositions[i];
+      std::vector<unsigned int> boundPositions, freePositions;
+      for (unsigned int i = 0; i < numInputs; i++)
+        if ((boundMask >> i) & 1)
+          boundPositions.push_back (i);
+        else
+          freePositions.push_back (i);
+      if (boundPositions.size () < minBoundInputs)
+        continue;
+
+      // Columns of the decomposition chart: the function of the free inputs
+      // for each assignment of the bound set. Ashenhurst decompositions
+      // exist when there are two distinct columns
+      auto column = [&] (unsigned int boundAssignment) {
+        unsigned int boundMinterm = 0;
+        for (unsigned int i = 0; i < boundPositions.size (); i++)
+          boundMinterm |= ((boundAssignment >> i) & 1) << boundPositions[i];
+        std::vector<bool> bits (1u << freePositions.size ());
+        for (unsigned int f = 0; f < bits.size (); f++)
+          {
+            unsigned int minterm = boundMinterm;
+            for (unsigned int i = 0; i < freePositions.size (); i++)
+              minterm |= ((f >> i) & 1) << freePositions[i];
+            bits[f] = _lutVector[lut].function.getBit (minterm);
+          }
+        return bits;
+      };
+      std::vector<std::vector<bool>> columnVector = { column (0) };
+      TruthTable boundFunction (boundPositions.size ());
+      bool decomposable = true;
+      for (unsigned int b = 1; b < (1u << boundPositions.size ()); b++)
+        {
+          std::vector<bool> bits = column (b);
+          if (bits == columnVector[0])
+            continue;
+          if (columnVector.size () == 1)
+            columnVector.push_back (std::move (bits));
+          else if (bits != columnVector[1])
+            {
+              decomposable = false;
+              break;
+            }
+          boundFunction.setBit (b, true);
+        }
+      if (!decomposable || columnVector.size () == 1)
+        continue;
+
+      // h is the new node, so it is the last input of g
+      unsigned int boundLut = _lutVector.size ();
+      Lut newLut;
+      for (const auto &i : boundPositions)
+        newLut.inputVector.push_back (inputs[i]);
+      newLut.function = std::move (boundFunction);
+      Lut freeLut;
+      for (const auto &i : freePositions)
+        freeLut.inputVector.push_back (inputs[i]);
+      freeLut.inputVector.push_back (boundLut);
+      freeLut.function = TruthTable (freePositions.size () + 1);
+      for (unsigned int h = 0; h < 2; h++)
+        for (unsigned int f = 0; f < columnVector[h].size (); f++)
+          freeLut.function.setBit (f | h << freePositions.size (),
+                                   columnVector[h][f]);
+      _lutVector[lut] = std::move (freeLut);
+      _lutVector.push_back (std::move (newLut));
+      return boundLut;
+    }
+  return 0;
+}
+
+void
+LutNetwork::removeVacuousInputs (unsigned int lut)
+{
+  Lut &rootLut = _lutVector[lut];
+  for (unsigned int i = rootLut.inputVector.size (); i-- > 0;)
+    if (!rootLut.function.dependsOn (i))
+      {
+        rootLut.function.removeVariable (i);
+        rootLut.inputVector.erase (rootLut.inputVector.begin () + i);
+      }
+}
+
+bool
+LutNetwork::runPass ()
+{
+  evaluateTiming ();
+  std::vector<bool> touched (_lutVector.size (), false);
+  bool changed = false;
+
+  // Area: lookup tables absorbed by all their fanouts
+  for (const auto &lut : _topologicalOrder)
+    {
+      const std::vector<unsigned int> &fanouts = _fanoutVector[lut];
+      if (touched[lut] || _drivesOutput[lut] || fanouts.empty ())
+        continue;
+      if (std::any_of (fanouts.begin (), fanouts.end (),
+                       [&] (unsigned int fanout) {
+                         return touched[fanout]
+                                || mergedInputs (fanout, lut).size () > _k;
+                       }))
+        continue;
+      for (const auto &fanout : fanouts)
+        {
+          collapse (fanout, lut);
+          touched[fanout] = true;
+        }
+      touched[lut] = true;
+      _lutVector[lut] = Lut ();
+      _numCollapses++;
+      changed = true;
+    }
+
+  // Delay: critical lookup tables with a single critical input, which is
+  // collapsed, after a decomposition if it does not fit
+  for (const auto &lut : _topologicalOrder)
+    {
+      if (touched[lut] || !isLut (lut)
+          || _levelVector[lut] != _requiredVector[lut])
+        continue;
+      const std::vector<unsigned int> &inputs = _lutVector[lut].inputVector;
+      unsigned int criticalInput = 0;
+      unsigned int numCriticalInputs = 0;
+      for (const auto &input : inputs)
+        if (_levelVector[input] + 1 == _levelVector[lut])
+          {
+            criticalInput = input;
+            numCriticalInputs++;
+          }
+      if (numCriticalInputs != 1 || !isLut (criticalInput)
+          || touched[criticalInput])
+        continue;
+      std::vector<unsigned int> merged = mergedInputs (lut, criticalInput);
+      if (merged.size () > _k)
+        {
+          // The decomposition adds a lookup table unless the critical input
+          // has no other fanout
+          if (_mappingGoal == MappingGoal::MinimizeArea
+              && (_drivesOutput[criticalInput]
+                  || _fanoutVector[criticalInput].size () > 1))
+            continue;
+          const std::vector<unsigned int> &faninInputs
+              = _lutVector[criticalInput].inputVector;
+          std::vector<unsigned int> boundCandidates;
+          for (const auto &input : inputs)
+            if (input != criticalInput
+                && _levelVector[input] + 3 <= _levelVector[lut]
+                && !std::binary_search (faninInputs.begin (),
+                                        faninInputs.end (), input))
+              boundCandidates.push_back (input);
+          unsigned int boundLut
+              = decompose (lut, boundCandidates, merged.size () + 1 - _k);
+          if (boundLut == 0)
+            continue;
+          touched.push_back (true);
+          _numDecompositions++;
+        }
+      collapse (lut, criticalInput);
+      touched[lut] = touched[criticalInput] = true;
+      _numCollapses++;
+      changed = true;
+    }
+  return changed;
+}
+
+void
+LutNetwork::run ()
+{
+  for (unsigned int pass = 0; pass < MaxPasses && runPass (); pass++)
+    ;
+  evaluateTiming ();
+}
+
+unsigned int
+LutNetwork::getMappingAreaCost () const noexcept
+{
+  return _mappingAreaCost;
+}
+
+unsigned int
+LutNetwork::getMappingDelayCost () const noexcept
+{
+  return _mappingDelayCost;
+}
+
+unsigned int
+LutNetwork::getNumCollapses () const noexcept
+{
+  return _numCollapses;
+}
+
+unsigned int
+LutNetwork::getNumDecompositions () const noexcept
+{
+  return _numDecompositions;
+}
+
+std::uint64_t
+LutNetwork::getFingerprint () const
+{
+  // 64-bit FNV-1a, as in TechMapperBase::getFingerprint()
+  std::uint64_t fingerprint = 0xcbf29ce484222325ULL;
+  auto hashWord = [&fingerprint] (std::uint32_t word) {
+    for (unsigned int i = 0; i < 4; i++)
+      {
+        fingerprint ^= (word >> (8 * i)) & 0xff;
+        fingerprint *= 0x100000001b3ULL;
+      }
+  };
+  for (unsigned int node = 0; node < _lutVector.size (); node++)
+    if (isLut (node))
+      {
+        hashWord (AndInverterGraph::literalFromIndex (node));
+        hashWord (_lutVector[node].inputVector.size ());
+        for (const auto &input : _lutVector[node].inputVector)
+          hashWord (input);
+        for (const auto &word : _lutVector[node].function.getWords ())
+          {
+            hashWord (word);
+            hashWord (word >> 32);
+          }
+      }
+  return fingerprint;
+}
+
+void
+LutNetwork::printResults (std::ostream &os) const
+{
+  os << ">> LUT network resynthesis results" << std::endl;
+  os << "# LUT count: " << _mappingAreaCost << std::endl;
+  os << "# Levels: " << _mappingDelayCost << std::endl;
+  os << "# Collapses: " << _numCollapses << std::endl;
+  os << "# Decompositions: " << _numDecompositions << std::endl;
+  std::ios_base::fmtflags flags = os.flags ();
+  os << "# Fingerprint: " << std::hex << std::setw (16) << std::setfill ('0')
+     << getFingerprint () << std::setfill (' ') << std::endl;
+  os.flags (flags);
+}
+
+void
+LutNetwork::writeReport (JsonWriter &writer) const
+{
+  std::ostringstream fingerprint;
+  fingerprint << std::hex << std::setw (16) << std::setfill ('0')
+              << getFingerprint ();
+  writer.key ("lutCount").value (_mappingAreaCost);
+  writer.key ("levels").value (_mappingDelayCost);
+  writer.key ("collapses").value (_numCollapses);
+  writer.key ("decompositions").value (_numDecompositions);
+  writer.key ("fingerprint").value (fingerprint.str ());
+}
+
+void
+LutNetwork::printImplementation (std::ostream &os) const
+{
+  os << ">> LUT network: " << std::endl;
+  for (unsigned int node = 0; node < _lutVector.size (); node++)
+    if (isLut (node))
+      {
+        os << "(" << AndInverterGraph::literalFromIndex (node) << ") => ( ";
+        for (const auto &input : _lutVector[node].inputVector)
+          os << AndInverterGraph::literalFromIndex (input) << " ";
+        os << ") " << _lutVector[node].function << std::endl;
+      }
+}
@@ -0,0 +1,125 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/MappingJob.h"
+
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+
+MappingJob::MappingJob (MappingEngine &mappingEngine, TechMapper &techMapper)
+    : _mappingEngine (mappingEngine), _techMapper (techMapper)
+{
+}
+
+MappingJob::~MappingJob ()
+{
+  if (_thread.joinable ())
+    {
+      cancel ();
+      _thread.join ();
+    }
+}
+
+void
+MappingJob::setDeadline (MappingProgress::Clock::time_point deadline) noexcept
+{
+  _progress.setDeadline (deadline);
+}
+
+std::shared_future<void>
+MappingJob::start ()
+{
+  if (_phase.load () != Phase::NotStarted || _thread.joinable ())
+    throw std::runtime_error ("Runtime error (MappingJob::start): the job "
+                              "was already started.");
+  _future = _promise.get_future ().share ();
+  _phase.store (Phase::Enumeration);
+  _thread = std::thread (&MappingJob::runJob, this);
+  return _future;
+}
+
+void
+MappingJob::cancel () noexcept
+{
+  _progress.requestCancellation ();
+}
+
+MappingJob::Phase
+MappingJob::getPhase () const noexcept
+{
+  return _phase.load ();
+}
+
+const MappingProgress &
+MappingJob::getProgress () const noexcept
+{
+  return _progress;
+}
+
+double
+MappingJob::getEnumerationSeconds () const noexcept
+{
+  return _enumerationSeconds;
+}
+
+double
+MappingJob::getCoverSeconds () const noexcept
+{
+  return _coverSeconds;
+}
+
+void
+MappingJob::stopIfCancelled () const
+{
+  if (_progress.isCancelled ())
+    throw MappingCancelled (_progress.isPastDeadline ()
+                                ? "Mapping cancelled: the deadline has passed."
+                                : "Mapping cancelled.");
+}
+
+void
+MappingJob::runJob ()
+{
+  using Clock = std::chrono::steady_clock;
+  auto secondsSince = [] (Clock::time_point start) {
+    return std::chrono::duration<double> (Clock::now () - start).count ();
+  };
+  _mappingEngine.setProgress (&_progress);
+  try
+    {
+      Clock::time_point start = Clock::now ();
+      stopIfCancelled ();
+      _mappingEngine.run ();
+      _enumerationSeconds = secondsSince (start);
+
+      // The engine runs again if the delay model depends on fanout
+      stopIfCancelled ();
+      _phase.store (Phase::Cover);
+      start = Clock::now ();
+      _techMapper.run ();
+      _coverSeconds = secondsSince (start);
+      _mappingEngine.setProgress (nullptr);
+      _phase.store (Phase::Done);
+      _promise.set_value ();
+    }
+  catch (const MappingCancelled &)
+    {
+      _mappingEngine.setProgress (nullptr);
+      _phase.store (Phase::Cancelled);
+      _promise.set_exception (std::current_exception ());
+    }
+  catch (...)
+    {
+      _mappingEngine.setProgress (nullptr);
+      _phase.store (Phase::Failed);
+      _promise.set_exception (std::current_exception ());
+    }
+}
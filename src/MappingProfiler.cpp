@@ -0,0 +1,435 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/MappingProfiler.h"
+#include "../include/MappingObserver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iterator>
+#include <queue>
+#include <utility>
+
+namespace
+{
+
+// Measures the time and the cut set memory of the and-nodes of the sampled
+// graph that are close to the roots of their cones
+class SampleObserver : public MappingObserver
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  SampleObserver (const std::vector<bool> &measuredVector,
+                  std::uint64_t leafBytes)
+      : _measuredVector (measuredVector), _leafBytes (leafBytes)
+  {
+  }
+
+  void
+  onNodeEnumerationStart (unsigned int) override
+  {
+    _start = Clock::now ();
+  }
+
+  void
+  onNodeEnumerationEnd (unsigned int andLiteral, const CutSet &cutSet) override
+  {
+    if (!_measuredVector[AndInverterGraph::indexFromLiteral (andLiteral)])
+      return;
+    seconds += std::chrono::duration<double> (Clock::now () - _start).count ();
+    bytes += sizeof (CutSet);
+    for (const auto &cut : cutSet)
+      bytes += sizeof (Cut) + cut.getVariableSet ().size () * _leafBytes;
+    numCuts += cutSet.size ();
+  }
+
+  double seconds = 0;
+  std::uint64_t bytes = 0;
+  std::uint64_t numCuts = 0;
+
+private:
+  const std::vector<bool> &_measuredVector;
+  std::uint64_t _leafBytes;
+  Clock::time_point _start = {};
+};
+
+}
+
+MappingProfiler::MappingProfiler (const AndInverterGraph &aig,
+                                  MappingGoal mappingGoal, unsigned int k)
+    : _aig (aig), _mappingGoal (mappingGoal), _k (k)
+{
+}
+
+void
+MappingProfiler::setTimeBudget (double seconds) noexcept
+{
+  _timeBudget = seconds;
+}
+
+void
+MappingProfiler::setMemoryBudget (std::uint64_t bytes) noexcept
+{
+  _memoryBudget = bytes;
+}
+
+void
+MappingProfiler::run ()
+{
+  _levelHistogram.clear ();
+  _fanoutHistogram.clear ();
+  _sampleRootVector.clear ();
+  _predictionVector.clear ();
+  profileShape ();
+  sampleReconvergence ();
+  predictCandidates ();
+}
+
+void
+MappingProfiler::profileShape ()
+{
+  unsigned int firstAndVariable
+      = AndInverterGraph::indexFromLiteral (_aig.getFirstAndLiteral ());
+  unsigned int numAnds = _aig.getNumAnds ();
+  std::vector<unsigned int> levelVector (_aig.getMaxVariableIndex () + 1, 0);
+  std::vector<unsigned int> fanoutVector (_aig.getMaxVariableIndex () + 1, 0);
+
+  // And-nodes come after their children, so one pass finds the levels
+  for (unsigned int i = 0; i < numAnds; i++)
+    {
+      unsigned int andVariable = firstAndVariable + i;
+      const AndNode &an = _aig.getAndNodeFromLiteral (
+          AndInverterGraph::literalFromIndex (andVariable));
+      unsigned int firstChild
+          = AndInverterGraph::indexFromLiteral (an.getFirstChild ());
+      unsigned int secondChild
+          = AndInverterGraph::indexFromLiteral (an.getSecondChild ());
+      levelVector[andVariable]
+          = 1 + std::max (levelVector[firstChild], levelVector[secondChild]);
+      fanoutVector[firstChild]++;
+      fanoutVector[secondChild]++;
+    }
+  for (const auto &outputLiteral : _aig.getOutputLiteralVector ())
+    fanoutVector[AndInverterGraph::indexFromLiteral (outputLiteral)]++;
+  for (unsigned int i = 0; i < _aig.getNumLatches (); i++)
+    {
+      unsigned int latchLiteral = _aig.getFirstLatchLiteral () + 2 * i;
+      fanoutVector[AndInverterGraph::indexFromLiteral (
+          _aig.getLatchNodeFromLiteral (latchLiteral).getNextQ ())]++;
+    }
+
+  for (unsigned int i = 0; i < numAnds; i++)
+    {
+      unsigned int level = levelVector[firstAndVariable + i];
+      if (_levelHistogram.size () < level)
+        _levelHistogram.resize (level, 0);
+      _levelHistogram[level - 1]++;
+
+      unsigned int fanout = fanoutVector[firstAndVariable + i];
+      unsigned int bucket = 0;
+      while (fanout >> bucket)
+        bucket++;
+      if (_fanoutHistogram.size () <= bucket)
+        _fanoutHistogram.resize (bucket + 1, 0);
+      _fanoutHistogram[bucket]++;
+    }
+
+  // The sampled and-nodes are spread evenly over the graph
+  unsigned int numRoots = std::min (NumSampleRoots, numAnds);
+  for (unsigned int i = 0; i < numRoots; i++)
+    _sampleRootVector.push_back (
+        firstAndVariable
+        + static_cast<unsigned int> (
+            (2 * static_cast<std::uint64_t> (i) + 1) * numAnds
+            / (2 * numRoots)));
+}
+
+void
+MappingProfiler::collectFanin (unsigned int literal, unsigned int depth,
+                               std::vector<unsigned int> &variables) const
+{
+  unsigned int variable = AndInverterGraph::indexFromLiteral (literal);
+  if (variable == 0)
+    return;
+  variables.push_back (variable);
+  if (depth == 0 || !_aig.nodeIsAnd (literal))
+    return;
+  const AndNode &an = _aig.getAndNodeFromLiteral (literal & ~1u);
+  collectFanin (an.getFirstChild (), depth - 1, variables);
+  collectFanin (an.getSecondChild (), depth - 1, variables);
+}
+
+void
+MappingProfiler::sampleReconvergence ()
+{
+  unsigned int numReconvergent = 0;
+  for (const auto &rootVariable : _sampleRootVector)
+    {
+      const AndNode &an = _aig.getAndNodeFromLiteral (
+          AndInverterGraph::literalFromIndex (rootVariable));
+      std::vector<unsigned int> firstFanin, secondFanin;
+      collectFanin (an.getFirstChild (), ReconvergenceDepth - 1, firstFanin);
+      collectFanin (an.getSecondChild (), ReconvergenceDepth - 1,
+                    secondFanin);
+      std::sort (firstFanin.begin (), firstFanin.end ());
+      std::sort (secondFanin.begin (), secondFanin.end ());
+      std::vector<unsigned int> sharedFanin;
+      std::set_intersection (firstFanin.begin (), firstFanin.end (),
+                             secondFanin.begin (), secondFanin.end (),
+                             std::back_inserter (sharedFanin));
+      if (!sharedFanin.empty ())
+        numReconvergent++;
+    }
+  if (!_sampleRootVector.empty ())
+    _reconvergenceRatio
+        = static_cast<double> (numReconvergent) / _sampleRootVector.size ();
+  else
+    _reconvergenceRatio = 0;
+}
+
+void
+MappingProfiler::predictCandidates ()
+{
+  // The cones are gathered breadth first from their roots, so that each
+  // one keeps the nodes closest to its root. Nodes beyond its bounds (and
+  // the inputs and latches) become inputs of the sampled graph
+  enum class Role : unsigned char
+  {
+    None,
+    Input,
+    And
+  };
+  std::vector<Role> roleVector (_aig.getMaxVariableIndex () + 1, Role::None);
+  std::vector<bool> measuredVector (_aig.getMaxVariableIndex () + 1, false);
+  for (const auto &rootVariable : _sampleRootVector)
+    {
+      std::queue<std::pair<unsigned int, unsigned int>> queue;
+      queue.emplace (rootVariable, 0);
+      unsigned int numConeNodes = 0;
+      while (!queue.empty ())
+        {
+          auto [variable, depth] = queue.front ();
+          queue.pop ();
+          if (variable == 0)
+            continue;
+          unsigned int literal = AndInverterGraph::literalFromIndex (variable);
+          if (roleVector[variable] != Role::And
+              && (!_aig.nodeIsAnd (literal) || depth > MaxConeDepth
+                  || numConeNodes >= MaxConeNodes))
+            {
+              roleVector[variable] = Role::Input;
+              continue;
+            }
+          if (depth <= MeasuredDepth)
+            measuredVector[variable] = true;
+          if (roleVector[variable] == Role::And)
+            continue;
+          roleVector[variable] = Role::And;
+          numConeNodes++;
+          const AndNode &an = _aig.getAndNodeFromLiteral (literal);
+          queue.emplace (AndInverterGraph::indexFromLiteral (
+                             an.getFirstChild ()),
+                         depth + 1);
+          queue.emplace (AndInverterGraph::indexFromLiteral (
+                             an.getSecondChild ()),
+                         depth + 1);
+        }
+    }
+
+  // Variables of the sampled graph: its inputs, then its and-nodes, both in
+  // the order of the original graph
+  std::vector<unsigned int> sampleVariableVector (roleVector.size (), 0);
+  unsigned int numSampleInputs = 0;
+  for (unsigned int variable = 1; variable < roleVector.size (); variable++)
+    if (roleVector[variable] == Role::Input)
+      sampleVariableVector[variable] = ++numSampleInputs;
+  unsigned int numSampleVariables = numSampleInputs;
+  for (unsigned int variable = 1; variable < roleVector.size (); variable++)
+    if (roleVector[variable] == Role::And)
+      sampleVariableVector[variable] = ++numSampleVariables;
+  auto sampleLiteral = [&] (unsigned int literal) {
+    return AndInverterGraph::literalFromIndex (
+               sampleVariableVector[AndInverterGraph::indexFromLiteral (
+                   literal)])
+           | (literal & 1);
+  };
+
+  std::vector<std::pair<unsigned int, unsigned int>> andChildVector;
+  std::vector<bool> sampleMeasuredVector (numSampleVariables + 1, false);
+  _numMeasuredAnds = 0;
+  for (unsigned int variable = 1; variable < roleVector.size (); variable++)
+    if (roleVector[variable] == Role::And)
+      {
+        const AndNode &an = _aig.getAndNodeFromLiteral (
+            AndInverterGraph::literalFromIndex (variable));
+        unsigned int firstChild = sampleLiteral (an.getFirstChild ());
+        unsigned int secondChild = sampleLiteral (an.getSecondChild ());
+        andChildVector.emplace_back (std::max (firstChild, secondChild),
+                                     std::min (firstChild, secondChild));
+        if (measuredVector[variable])
+          {
+            sampleMeasuredVector[sampleVariableVector[variable]] = true;
+            _numMeasuredAnds++;
+          }
+      }
+  _numSampleAnds = andChildVector.size ();
+  if (_numMeasuredAnds == 0)
+    {
+      // Without and-nodes there is nothing to enumerate
+      _selectedC = CandidateCs[std::size (CandidateCs) - 1];
+      _fitsBudget = true;
+      return;
+    }
+  std::vector<unsigned int> outputLiteralVector;
+  for (const auto &rootVariable : _sampleRootVector)
+    outputLiteralVector.push_back (
+        sampleLiteral (AndInverterGraph::literalFromIndex (rootVariable)));
+  AndInverterGraph sampleAig (_aig.getFilePath () + " (sample)",
+                              numSampleInputs, andChildVector,
+                              outputLiteralVector);
+
+  // Candidates cost more as c grows, so the first one over the budget ends
+  // the search
+  _selectedC = CandidateCs[0];
+  _fitsBudget = false;
+  double scale = static_cast<double> (_aig.getNumAnds ()) / _numMeasuredAnds;
+  for (const auto &c : CandidateCs)
+    {
+      SampleObserver observer (sampleMeasuredVector, LeafBytes);
+      ObservedCutEngine cutEngine (sampleAig, _mappingGoal, _k, c);
+      cutEngine.setObserver (&observer);
+      cutEngine.run ();
+      Prediction prediction;
+      prediction.c = c;
+      prediction.enumerationSeconds = observer.seconds * scale;
+      prediction.cutSetBytes
+          = static_cast<std::uint64_t> (observer.bytes * scale);
+      prediction.cutsPerNode
+          = static_cast<double> (observer.numCuts) / _numMeasuredAnds;
+      _predictionVector.push_back (prediction);
+      if (!fits (prediction))
+        break;
+      _selectedC = c;
+      _fitsBudget = true;
+    }
+}
+
+bool
+MappingProfiler::fits (const Prediction &prediction) const noexcept
+{
+  return prediction.enumerationSeconds <= _timeBudget
+         && prediction.cutSetBytes <= _memoryBudget;
+}
+
+const std::vector<unsigned int> &
+MappingProfiler::getLevelHistogram () const noexcept
+{
+  return _levelHistogram;
+}
+
+const std::vector<unsigned int> &
+MappingProfiler::getFanoutHistogram () const noexcept
+{
+  return _fanoutHistogram;
+}
+
+double
+MappingProfiler::getReconvergenceRatio () const noexcept
+{
+  return _reconvergenceRatio;
+}
+
+const std::vector<MappingProfiler::Prediction> &
+MappingProfiler::getPredictionVector () const noexcept
+{
+  return _predictionVector;
+}
+
+unsigned int
+MappingProfiler::getSelectedC () const noexcept
+{
+  return _selectedC;
+}
+
+bool
+MappingProfiler::fitsBudget () const noexcept
+{
+  return _fitsBudget;
+}
+
+void
+MappingProfiler::printResults (std::ostream &os) const
+{
+  os << ">> Mapping profile" << std::endl;
+  os << "# And-nodes: " << _aig.getNumAnds () << " (" << _numSampleAnds
+     << " sampled, " << _numMeasuredAnds << " measured)" << std::endl;
+  os << "# Levels: " << _levelHistogram.size () << std::endl;
+  os << "# Fanout histogram:";
+  for (unsigned int bucket = 0; bucket < _fanoutHistogram.size (); bucket++)
+    {
+      os << " ";
+      if (bucket < 2)
+        os << bucket;
+      else if (bucket == 2)
+        os << "2-3";
+      else
+        os << (1u << (bucket - 1)) << "-" << (1u << bucket) - 1;
+      os << ":" << _fanoutHistogram[bucket];
+    }
+  os << std::endl;
+  std::ios_base::fmtflags flags = os.flags ();
+  os << std::fixed << std::setprecision (2);
+  os << "# Reconvergence ratio: " << _reconvergenceRatio << std::endl;
+  for (const auto &prediction : _predictionVector)
+    os << "# Predicted c=" << prediction.c << ": "
+       << prediction.enumerationSeconds << " s, "
+       << prediction.cutSetBytes / (1024.0 * 1024.0) << " MB, "
+       << prediction.cutsPerNode << " cuts/node" << std::endl;
+  os.flags (flags);
+  os << "# Selected c: " << _selectedC
+     << (_fitsBudget ? "" : " (no candidate fits the budget)") << std::endl;
+}
+
+void
+MappingProfiler::writeReport (JsonWriter &writer) const
+{
+  writer.key ("levelHistogram").beginArray ();
+  for (const auto &numAnds : _levelHistogram)
+    writer.value (numAnds);
+  writer.endArray ();
+  writer.key ("fanoutHistogram").beginArray ();
+  for (const auto &numAnds : _fanoutHistogram)
+    writer.value (numAnds);
+  writer.endArray ();
+  writer.key ("reconvergenceRatio").value (_reconvergenceRatio);
+  writer.key ("sampledAnds").value (_numSampleAnds);
+  writer.key ("measuredAnds").value (_numMeasuredAnds);
+  writer.key ("timeBudgetSeconds").value (_timeBudget);
+  writer.key ("memoryBudgetBytes");
+  if (_memoryBudget == std::numeric_limits<std::uint64_t>::max ())
+    writer.null ();
+  else
+    writer.value (_memoryBudget);
+  writer.key ("predictions").beginArray ();
+  for (const auto &prediction : _predictionVector)
+    {
+      writer.beginObject ();
+      writer.key ("c").value (prediction.c);
+      writer.key ("enumerationSeconds").value (prediction.enumerationSeconds);
+      writer.key ("cutSetBytes").value (prediction.cutSetBytes);
+      writer.key ("cutsPerNode").value (prediction.cutsPerNode);
+      writer.endObject ();
+    }
+  writer.endArray ();
+  writer.key ("selectedC").value (_selectedC);
+  writer.key ("fitsBudget").value (_fitsBudget);
+}
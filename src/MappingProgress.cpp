@@ -0,0 +1,70 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/MappingProgress.h"
+
+void
+MappingProgress::requestCancellation () noexcept
+{
+  _cancelRequested.store (true, std::memory_order_relaxed);
+}
+
+void
+MappingProgress::setDeadline (Clock::time_point deadline) noexcept
+{
+  _deadline.store (deadline.time_since_epoch ().count (),
+                   std::memory_order_relaxed);
+}
+
+bool
+MappingProgress::isCancelled () const noexcept
+{
+  return _cancelRequested.load (std::memory_order_relaxed)
+         || isPastDeadline ();
+}
+
+bool
+MappingProgress::isPastDeadline () const noexcept
+{
+  return Clock::now ().time_since_epoch ().count ()
+         > _deadline.load (std::memory_order_relaxed);
+}
+
+void
+MappingProgress::addNodes (std::size_t numNodes) noexcept
+{
+  _numNodes.fetch_add (numNodes, std::memory_order_relaxed);
+}
+
+void
+MappingProgress::nodeDone () noexcept
+{
+  _numDoneNodes.fetch_add (1, std::memory_order_relaxed);
+}
+
+std::size_t
+MappingProgress::getNumNodes () const noexcept
+{
+  return _numNodes.load (std::memory_order_relaxed);
+}
+
+std::size_t
+MappingProgress::getNumDoneNodes () const noexcept
+{
+  return _numDoneNodes.load (std::memory_order_relaxed);
+}
+
+double
+MappingProgress::getFraction () const noexcept
+{
+  std::size_t numNodes = getNumNodes ();
+  return numNodes == 0 ? 0.0
+                       : static_cast<double> (getNumDoneNodes ()) / numNodes;
+}
@@ -0,0 +1,141 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/NumaTopology.h"
+
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+// Memory policy of mbind(2) that prefers a node but falls back to the others
+// when it is full
+const int MpolPreferred = 1;
+
+std::string
+readFirstLine (const std::string &filePath)
+{
+  std::ifstream file (filePath);
+  std::string line;
+  if (file.is_open ())
+    std::getline (file, line);
+  return line;
+}
+
+std::string
+nodeCpuListPath (unsigned int node)
+{
+  return "/sys/devices/system/node/node" + std::to_string (node)
+         + "/cpulist";
+}
+}
+
+std::vector<unsigned int>
+NumaTopology::parseList (const std::string &list)
+{
+  std::vector<unsigned int> values;
+  std::stringstream listStream (list);
+  std::string range;
+  while (std::getline (listStream, range, ','))
+    {
+      if (range.find_first_not_of (" \n") == std::string::npos)
+        continue;
+      try
+        {
+          std::size_t dash = range.find ('-');
+          unsigned int first = std::stoul (range.substr (0, dash));
+          unsigned int last = dash == std::string::npos
+                                  ? first
+                                  : std::stoul (range.substr (dash + 1));
+          for (unsigned int value = first; value <= last; value++)
+            values.push_back (value);
+        }
+      catch (const std::exception &e)
+        {
+          return {};
+        }
+    }
+  return values;
+}
+
+const std::vector<unsigned int> &
+NumaTopology::getNodes ()
+{
+  static const std::vector<unsigned int> nodes = [] {
+    std::vector<unsigned int> nodesWithCpus;
+#ifdef __linux__
+    for (const auto &node :
+         parseList (readFirstLine ("/sys/devices/system/node/online")))
+      if (!getNodeCpus (node).empty ())
+        nodesWithCpus.push_back (node);
+#endif
+    if (nodesWithCpus.empty ())
+      nodesWithCpus.push_back (0);
+    return nodesWithCpus;
+  }();
+  return nodes;
+}
+
+unsigned int
+NumaTopology::getNumNodes ()
+{
+  return getNodes ().size ();
+}
+
+std::vector<unsigned int>
+NumaTopology::getNodeCpus (unsigned int node)
+{
+#ifdef __linux__
+  return parseList (readFirstLine (nodeCpuListPath (node)));
+#else
+  return {};
+#endif
+}
+
+bool
+NumaTopology::bindCurrentThread (unsigned int node)
+{
+#ifdef __linux__
+  std::vector<unsigned int> cpus = getNodeCpus (node);
+  if (cpus.empty ())
+    return false;
+  cpu_set_t cpuSet;
+  CPU_ZERO (&cpuSet);
+  for (const auto &cpu : cpus)
+    if (cpu < CPU_SETSIZE)
+      CPU_SET (cpu, &cpuSet);
+  return pthread_setaffinity_np (pthread_self (), sizeof (cpuSet), &cpuSet)
+         == 0;
+#else
+  return false;
+#endif
+}
+
+bool
+NumaTopology::bindMemory (void *address, std::size_t size, unsigned int node)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+  const unsigned int bitsPerWord = 8 * sizeof (unsigned long);
+  std::vector<unsigned long> nodeMask (node / bitsPerWord + 1, 0);
+  nodeMask[node / bitsPerWord] |= 1UL << (node % bitsPerWord);
+  return syscall (SYS_mbind, address, size, MpolPreferred, nodeMask.data (),
+                  nodeMask.size () * bitsPerWord + 1, 0)
+         == 0;
+#else
+  return false;
+#endif
+}
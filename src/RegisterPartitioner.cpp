@@ -0,0 +1,384 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/RegisterPartitioner.h"
+#include "../include/FlowMapEngine.h"
+#include "../include/TechMapper.h"
+#include "../include/WorkerPool.h"
+#include "../include/ZddCutEngine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <numeric>
+
+RegisterPartitioner::RegisterPartitioner (const AndInverterGraph &aig,
+                                          MappingGoal mappingGoal,
+                                          unsigned int k, unsigned int c)
+    : _aig (aig), _mappingGoal (mappingGoal), _k (k), _c (c)
+{
+  _firstAndVariable
+      = AndInverterGraph::indexFromLiteral (_aig.getFirstAndLiteral ());
+  partition ();
+}
+
+void
+RegisterPartitioner::setEngine (const std::string &engine)
+{
+  if (engine != "cuts" && engine != "flowmap" && engine != "zdd")
+    throw std::runtime_error ("Runtime error (setEngine): unknown engine '"
+                              + engine + "'.");
+  _engine = engine;
+}
+
+void
+RegisterPartitioner::setNumThreads (unsigned int numThreads) noexcept
+{
+  _numThreads = std::max (1u, numThreads);
+}
+
+void
+RegisterPartitioner::setSupportReduction (bool supportReduction) noexcept
+{
+  _supportReduction = supportReduction;
+}
+
+void
+RegisterPartitioner::setDelayModel (const DelayModel &delayModel) noexcept
+{
+  _delayModel = delayModel;
+}
+
+void
+RegisterPartitioner::partition ()
+{
+  // Sinks: the outputs, then the next state of each latch
+  std::vector<unsigned int> sinkVector = _aig.getOutputLiteralVector ();
+  for (unsigned int i = 0; i < _aig.getNumLatches (); i++)
+    sinkVector.push_back (
+        _aig.getLatchNodeFromLiteral (_aig.getFirstLatchLiteral () + 2 * i)
+            .getNextQ ());
+
+  // And-nodes that reach a sink without crossing a latch
+  unsigned int numAnds = _aig.getNumAnds ();
+  std::vector<bool> isLive (numAnds, false);
+  std::vector<unsigned int> stack;
+  auto visit = [&] (unsigned int literal) {
+    if (!_aig.nodeIsAnd (literal))
+      return;
+    unsigned int andIndex
+        = AndInverterGraph::indexFromLiteral (literal) - _firstAndVariable;
+    if (!isLive[andIndex])
+      {
+        isLive[andIndex] = true;
+        stack.push_back (literal);
+      }
+  };
+  for (const auto &sinkLiteral : sinkVector)
+    visit (sinkLiteral);
+  while (!stack.empty ())
+    {
+      const AndNode &andNode = _aig.getAndNodeFromLiteral (
+          stack.back () - stack.back () % 2);
+      stack.pop_back ();
+      visit (andNode.getFirstChild ());
+      visit (andNode.getSecondChild ());
+    }
+
+  // Islands are the connected components of the live and-nodes (union-find
+  // with path halving)
+  std::vector<unsigned int> parentVector (numAnds);
+  std::iota (parentVector.begin (), parentVector.end (), 0);
+  auto findRoot = [&parentVector] (unsigned int andIndex) {
+    while (parentVector[andIndex] != andIndex)
+      andIndex = parentVector[andIndex]
+          = parentVector[parentVector[andIndex]];
+    return andIndex;
+  };
+  for (unsigned int i = 0; i < numAnds; i++)
+    if (isLive[i])
+      {
+        const AndNode &andNode
+            = _aig.getAndNodeFromLiteral (_aig.getFirstAndLiteral () + 2 * i);
+        for (unsigned int childLiteral :
+             { andNode.getFirstChild (), andNode.getSecondChild () })
+          if (_aig.nodeIsAnd (childLiteral))
+            {
+              unsigned int childRoot = findRoot (
+                  AndInverterGraph::indexFromLiteral (childLiteral)
+                  - _firstAndVariable);
+              unsigned int root = findRoot (i);
+              parentVector[std::max (root, childRoot)]
+                  = std::min (root, childRoot);
+            }
+      }
+
+  // Islands are numbered by their first and-node; their and-nodes stay in
+  // topological order
+  std::vector<unsigned int> islandOfRoot (numAnds, -1);
+  std::vector<unsigned int> islandOfAnd (numAnds, -1);
+  for (unsigned int i = 0; i < numAnds; i++)
+    if (isLive[i])
+      {
+        unsigned int root = findRoot (i);
+        if (islandOfRoot[root] == static_cast<unsigned int> (-1))
+          {
+            islandOfRoot[root] = _islandVector.size ();
+            _islandVector.emplace_back ();
+          }
+        islandOfAnd[i] = islandOfRoot[root];
+        Island &island = _islandVector[islandOfAnd[i]];
+        island.andVector.push_back (i + _firstAndVariable);
+      }
+  for (const auto &sinkLiteral : sinkVector)
+    if (_aig.nodeIsAnd (sinkLiteral))
+      _islandVector[islandOfAnd[AndInverterGraph::indexFromLiteral (
+                                    sinkLiteral)
+                                - _firstAndVariable]]
+          .sinkVector.push_back (sinkLiteral);
+
+  // Build the graph of each island. Sources and and-nodes keep their order,
+  // so children still satisfy rhs0 >= rhs1
+  std::vector<unsigned int> islandVariableVector (
+      _aig.getMaxVariableIndex () + 1, 0);
+  for (unsigned int i = 0; i < _islandVector.size (); i++)
+    {
+      Island &island = _islandVector[i];
+      for (const auto &andVariable : island.andVector)
+        {
+          const AndNode &andNode = _aig.getAndNodeFromLiteral (
+              AndInverterGraph::literalFromIndex (andVariable));
+          for (unsigned int childLiteral :
+               { andNode.getFirstChild (), andNode.getSecondChild () })
+            if (!_aig.nodeIsAnd (childLiteral))
+              island.sourceVector.push_back (
+                  AndInverterGraph::indexFromLiteral (childLiteral));
+        }
+      std::sort (island.sourceVector.begin (), island.sourceVector.end ());
+      island.sourceVector.erase (std::unique (island.sourceVector.begin (),
+                                              island.sourceVector.end ()),
+                                 island.sourceVector.end ());
+      unsigned int islandVariable = 1;
+      for (const auto &sourceVariable : island.sourceVector)
+        islandVariableVector[sourceVariable] = islandVariable++;
+      for (const auto &andVariable : island.andVector)
+        islandVariableVector[andVariable] = islandVariable++;
+      auto islandLiteral = [&] (unsigned int literal) {
+        return AndInverterGraph::literalFromIndex (
+                   islandVariableVector[AndInverterGraph::indexFromLiteral (
+                       literal)])
+               + literal % 2;
+      };
+      std::vector<std::pair<unsigned int, unsigned int>> andChildVector;
+      for (const auto &andVariable : island.andVector)
+        {
+          const AndNode &andNode = _aig.getAndNodeFromLiteral (
+              AndInverterGraph::literalFromIndex (andVariable));
+          andChildVector.push_back (
+              { islandLiteral (andNode.getFirstChild ()),
+                islandLiteral (andNode.getSecondChild ()) });
+        }
+      std::vector<unsigned int> outputLiteralVector;
+      for (const auto &sinkLiteral : island.sinkVector)
+        outputLiteralVector.push_back (islandLiteral (sinkLiteral));
+      island.aig = std::make_unique<AndInverterGraph> (
+          _aig.getFilePath () + " (island " + std::to_string (i) + ")",
+          island.sourceVector.size (), andChildVector, outputLiteralVector);
+    }
+  _lutInputVector.assign (numAnds, {});
+  _implementedVector.assign (numAnds, false);
+}
+
+void
+RegisterPartitioner::mapIsland (Island &island)
+{
+  const AndInverterGraph &aig = *island.aig;
+  std::unique_ptr<MappingEngine> mappingEngine;
+  if (_engine == "flowmap")
+    mappingEngine.reset (new FlowMapEngine (aig, _k));
+  else if (_engine == "zdd")
+    mappingEngine.reset (new ZddCutEngine (aig, _mappingGoal, _k));
+  else
+    {
+      CutEngine *cutEngine = new CutEngine (aig, _mappingGoal, _k, _c);
+      mappingEngine.reset (cutEngine);
+      cutEngine->setSupportReduction (_supportReduction);
+      cutEngine->setDelayModel (_delayModel);
+    }
+  TechMapper techMapper (*mappingEngine);
+  techMapper.run ();
+  island.numLuts = techMapper.getMappingAreaCost ();
+  island.levels = techMapper.getMappingDelayCost ();
+
+  // Back to the variables of the design
+  unsigned int numSources = island.sourceVector.size ();
+  island.lutVector.clear ();
+  for (unsigned int i = 0; i < island.andVector.size (); i++)
+    {
+      unsigned int andLiteral = aig.getFirstAndLiteral () + 2 * i;
+      if (!techMapper.isImplemented (andLiteral))
+        continue;
+      island.lutVector.push_back (island.andVector[i]);
+      std::vector<unsigned int> &lutInputs
+          = _lutInputVector[island.andVector[i] - _firstAndVariable];
+      for (const auto &leafVariable :
+           mappingEngine->getSelectedCut (andLiteral))
+        lutInputs.push_back (
+            leafVariable <= numSources
+                ? island.sourceVector[leafVariable - 1]
+                : island.andVector[leafVariable - numSources - 1]);
+    }
+}
+
+void
+RegisterPartitioner::run ()
+{
+  for (auto &lutInputs : _lutInputVector)
+    lutInputs.clear ();
+
+  // Largest islands first, so that a large island does not start last
+  std::vector<unsigned int> order (_islandVector.size ());
+  std::iota (order.begin (), order.end (), 0);
+  std::stable_sort (order.begin (), order.end (),
+                    [this] (unsigned int lhs, unsigned int rhs) {
+                      return _islandVector[lhs].andVector.size ()
+                             > _islandVector[rhs].andVector.size ();
+                    });
+  unsigned int numWorkers
+      = std::min<std::size_t> (_numThreads, _islandVector.size ());
+  if (numWorkers <= 1)
+    for (const auto &i : order)
+      mapIsland (_islandVector[i]);
+  else
+    {
+      std::atomic<unsigned int> next (0);
+      WorkerPool workerPool (numWorkers);
+      workerPool.runOnAll ([&] (unsigned int) {
+        for (unsigned int i = next.fetch_add (1); i < order.size ();
+             i = next.fetch_add (1))
+          mapIsland (_islandVector[order[i]]);
+      });
+    }
+
+  _mappingAreaCost = 0;
+  _mappingDelayCost = 0;
+  _implementedVector.assign (_lutInputVector.size (), false);
+  for (const auto &island : _islandVector)
+    {
+      for (const auto &andVariable : island.lutVector)
+        _implementedVector[andVariable - _firstAndVariable] = true;
+      _mappingAreaCost += island.numLuts;
+      _mappingDelayCost = std::max (_mappingDelayCost, island.levels);
+    }
+}
+
+unsigned int
+RegisterPartitioner::getNumIslands () const noexcept
+{
+  return _islandVector.size ();
+}
+
+unsigned int
+RegisterPartitioner::getMappingAreaCost () const noexcept
+{
+  return _mappingAreaCost;
+}
+
+unsigned int
+RegisterPartitioner::getMappingDelayCost () const noexcept
+{
+  return _mappingDelayCost;
+}
+
+bool
+RegisterPartitioner::isImplemented (unsigned int andLiteral) const
+{
+  if (!_aig.nodeIsAnd (andLiteral))
+    throw std::runtime_error (
+        "Runtime error (RegisterPartitioner). " + std::to_string (andLiteral)
+        + " is not a valid and-literal for the given AIG.");
+  return _implementedVector[AndInverterGraph::indexFromLiteral (andLiteral)
+                            - _firstAndVariable];
+}
+
+const std::vector<unsigned int> &
+RegisterPartitioner::getLutInputs (unsigned int andLiteral) const
+{
+  if (!_aig.nodeIsAnd (andLiteral))
+    throw std::runtime_error (
+        "Runtime error (RegisterPartitioner). " + std::to_string (andLiteral)
+        + " is not a valid and-literal for the given AIG.");
+  return _lutInputVector[AndInverterGraph::indexFromLiteral (andLiteral)
+                         - _firstAndVariable];
+}
+
+std::uint64_t
+RegisterPartitioner::getFingerprint () const
+{
+  // 64-bit FNV-1a over the words of the cover, as in
+  // TechMapperBase::getFingerprint()
+  std::uint64_t fingerprint = 0xcbf29ce484222325ULL;
+  auto hashWord = [&fingerprint] (std::uint32_t word) {
+    for (unsigned int i = 0; i < 4; i++)
+      {
+        fingerprint ^= (word >> (8 * i)) & 0xff;
+        fingerprint *= 0x100000001b3ULL;
+      }
+  };
+  for (unsigned int i = 0; i < _implementedVector.size (); i++)
+    if (_implementedVector[i])
+      {
+        hashWord (_aig.getFirstAndLiteral () + 2 * i);
+        hashWord (_lutInputVector[i].size ());
+        for (const auto &inputVariable : _lutInputVector[i])
+          hashWord (inputVariable);
+      }
+  return fingerprint;
+}
+
+void
+RegisterPartitioner::printResults (std::ostream &os) const
+{
+  os << ">> Technology Mapping results" << std::endl;
+  os << "# LUT count: " << _mappingAreaCost << std::endl;
+  os << "# Levels: " << _mappingDelayCost << std::endl;
+  os << "# Islands: " << _islandVector.size () << " ("
+     << _aig.getNumLatches () << " latches)" << std::endl;
+  std::ios_base::fmtflags flags = os.flags ();
+  os << "# Fingerprint: " << std::hex << std::setw (16) << std::setfill ('0')
+     << getFingerprint () << std::setfill (' ') << std::endl;
+  os.flags (flags);
+}
+
+void
+RegisterPartitioner::printImplementation (std::ostream &os) const
+{
+  os << ">> Implementation details: " << std::endl;
+  for (unsigned int i = 0; i < _lutInputVector.size (); i++)
+    {
+      os << "(" << _aig.getFirstAndLiteral () + 2 * i << ") => ";
+      if (!_implementedVector[i])
+        os << "not implemented" << std::endl;
+      else
+        {
+          os << "( ";
+          for (const auto &inputVariable : _lutInputVector[i])
+            os << AndInverterGraph::literalFromIndex (inputVariable) << " ";
+          os << ")" << std::endl;
+        }
+    }
+  for (unsigned int i = 0; i < _aig.getNumLatches (); i++)
+    {
+      unsigned int latchLiteral = _aig.getFirstLatchLiteral () + 2 * i;
+      os << "latch (" << latchLiteral << ") <= "
+         << _aig.getLatchNodeFromLiteral (latchLiteral).getNextQ ()
+         << std::endl;
+    }
+}
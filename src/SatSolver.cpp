@@ -0,0 +1,483 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/SatSolver.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+unsigned int
+SatSolver::newVariable ()
+{
+  unsigned int variable = _assignmentVector.size ();
+  _watchVector.resize (_watchVector.size () + 2);
+  _assignmentVector.push_back (Unassigned);
+  _phaseVector.push_back (False);
+  _levelVector.push_back (0);
+  _reasonVector.push_back (NoClause);
+  _seenVector.push_back (false);
+  _activityVector.push_back (0);
+  _heapPositionVector.push_back (-1);
+  heapInsert (variable);
+  return variable;
+}
+
+unsigned int
+SatSolver::getNumVariables () const noexcept
+{
+  return _assignmentVector.size ();
+}
+
+unsigned int
+SatSolver::literal (unsigned int variable, bool negated) noexcept
+{
+  return 2 * variable + (negated ? 1 : 0);
+}
+
+unsigned char
+SatSolver::literalValue (unsigned int literal) const noexcept
+{
+  unsigned char value = _assignmentVector[literal >> 1];
+  return value == Unassigned ? Unassigned : value ^ (literal & 1);
+}
+
+unsigned int
+SatSolver::decisionLevel () const noexcept
+{
+  return _trailLimitVector.size ();
+}
+
+bool
+SatSolver::addClause (std::vector<unsigned int> clause)
+{
+  for (const auto &lit : clause)
+    if ((lit >> 1) >= getNumVariables ())
+      throw std::runtime_error ("Runtime error (SatSolver::addClause): "
+                                "literal of an unknown variable.");
+  if (!_ok)
+    return false;
+
+  // Clauses are added at the top level, where every assignment is final:
+  // satisfied clauses are dropped and false literals removed
+  std::sort (clause.begin (), clause.end ());
+  clause.erase (std::unique (clause.begin (), clause.end ()), clause.end ());
+  std::size_t size = 0;
+  for (std::size_t i = 0; i < clause.size (); i++)
+    {
+      if (i + 1 < clause.size () && (clause[i] ^ 1) == clause[i + 1])
+        return true;
+      unsigned char value = literalValue (clause[i]);
+      if (value == True)
+        return true;
+      if (value == Unassigned)
+        clause[size++] = clause[i];
+    }
+  clause.resize (size);
+
+  if (clause.empty ())
+    _ok = false;
+  else if (clause.size () == 1)
+    {
+      enqueue (clause[0], NoClause);
+      _ok = propagate () == NoClause;
+    }
+  else
+    attachClause (std::move (clause));
+  return _ok;
+}
+
+bool
+SatSolver::addAtMost (const std::vector<unsigned int> &literals,
+                      unsigned int bound)
+{
+  std::size_t n = literals.size ();
+  if (bound >= n)
+    return _ok;
+  if (bound == 0)
+    {
+      for (const auto &lit : literals)
+        addClause ({ lit ^ 1 });
+      return _ok;
+    }
+
+  // counter[i][j] is true if at least j + 1 of the literals 0 to i are true
+  std::vector<std::vector<unsigned int>> counter (
+      n - 1, std::vector<unsigned int> (bound));
+  for (auto &row : counter)
+    for (auto &counterLiteral : row)
+      counterLiteral = literal (newVariable ());
+  addClause ({ literals[0] ^ 1, counter[0][0] });
+  for (unsigned int j = 1; j < bound; j++)
+    addClause ({ counter[0][j] ^ 1 });
+  for (std::size_t i = 1; i + 1 < n; i++)
+    {
+      addClause ({ literals[i] ^ 1, counter[i][0] });
+      addClause ({ counter[i - 1][0] ^ 1, counter[i][0] });
+      for (unsigned int j = 1; j < bound; j++)
+        {
+          addClause (
+              { literals[i] ^ 1, counter[i - 1][j - 1] ^ 1, counter[i][j] });
+          addClause ({ counter[i - 1][j] ^ 1, counter[i][j] });
+        }
+      addClause ({ literals[i] ^ 1, counter[i - 1][bound - 1] ^ 1 });
+    }
+  addClause ({ literals[n - 1] ^ 1, counter[n - 2][bound - 1] ^ 1 });
+  return _ok;
+}
+
+void
+SatSolver::enqueue (unsigned int literal, unsigned int reason)
+{
+  unsigned int variable = literal >> 1;
+  _assignmentVector[variable] = (literal & 1) ? False : True;
+  _levelVector[variable] = decisionLevel ();
+  _reasonVector[variable] = reason;
+  _trail.push_back (literal);
+}
+
+unsigned int
+SatSolver::attachClause (std::vector<unsigned int> clause)
+{
+  unsigned int index = _clauseVector.size ();
+  _watchVector[clause[0]].push_back ({ index, clause[1] });
+  _watchVector[clause[1]].push_back ({ index, clause[0] });
+  _clauseVector.push_back (std::move (clause));
+  return index;
+}
+
+unsigned int
+SatSolver::propagate ()
+{
+  while (_propagationHead < _trail.size ())
+    {
+      unsigned int falseLiteral = _trail[_propagationHead++] ^ 1;
+      std::vector<Watcher> &watchers = _watchVector[falseLiteral];
+      std::size_t i = 0, j = 0;
+      while (i < watchers.size ())
+        {
+          Watcher watcher = watchers[i++];
+          if (literalValue (watcher.blocker) == True)
+            {
+              watchers[j++] = watcher;
+              continue;
+            }
+
+          // The false literal is kept second, so the first one is the
+          // other watch
+          std::vector<unsigned int> &clause = _clauseVector[watcher.clause];
+          if (clause[0] == falseLiteral)
+            std::swap (clause[0], clause[1]);
+          unsigned int first = clause[0];
+          if (first != watcher.blocker && literalValue (first) == True)
+            {
+              watchers[j++] = { watcher.clause, first };
+              continue;
+            }
+
+          // Look for a literal to watch instead of the false one
+          bool moved = false;
+          for (std::size_t k = 2; k < clause.size (); k++)
+            if (literalValue (clause[k]) != False)
+              {
+                std::swap (clause[1], clause[k]);
+                _watchVector[clause[1]].push_back ({ watcher.clause, first });
+                moved = true;
+                break;
+              }
+          if (moved)
+            continue;
+
+          // The clause is unit or false
+          watchers[j++] = { watcher.clause, first };
+          if (literalValue (first) == False)
+            {
+              while (i < watchers.size ())
+                watchers[j++] = watchers[i++];
+              watchers.resize (j);
+              return watcher.clause;
+            }
+          enqueue (first, watcher.clause);
+        }
+      watchers.resize (j);
+    }
+  return NoClause;
+}
+
+std::vector<unsigned int>
+SatSolver::analyze (unsigned int conflict)
+{
+  std::vector<unsigned int> learnt = { 0 };
+  unsigned int numPaths = 0;
+  bool hasLiteral = false;
+  unsigned int literal = 0;
+  std::size_t index = _trail.size ();
+  unsigned int clause = conflict;
+  do
+    {
+      // The first literal of a reason is the one it implied
+      const std::vector<unsigned int> &literals = _clauseVector[clause];
+      for (std::size_t i = hasLiteral ? 1 : 0; i < literals.size (); i++)
+        {
+          unsigned int variable = literals[i] >> 1;
+          if (_seenVector[variable] || _levelVector[variable] == 0)
+            continue;
+          bumpActivity (variable);
+          _seenVector[variable] = true;
+          if (_levelVector[variable] >= decisionLevel ())
+            numPaths++;
+          else
+            learnt.push_back (literals[i]);
+        }
+
+      // The next literal of the current level to resolve on
+      while (!_seenVector[_trail[index - 1] >> 1])
+        index--;
+      literal = _trail[--index];
+      hasLiteral = true;
+      clause = _reasonVector[literal >> 1];
+      _seenVector[literal >> 1] = false;
+      numPaths--;
+    }
+  while (numPaths > 0);
+  learnt[0] = literal ^ 1;
+
+  // Drop the literals implied by the others
+  std::vector<unsigned int> marked (learnt.begin () + 1, learnt.end ());
+  std::size_t size = 1;
+  for (std::size_t i = 1; i < learnt.size (); i++)
+    if (!isRedundant (learnt[i]))
+      learnt[size++] = learnt[i];
+  learnt.resize (size);
+  for (const auto &markedLiteral : marked)
+    _seenVector[markedLiteral >> 1] = false;
+
+  // The literal of the deepest level goes second
+  for (std::size_t i = 2; i < learnt.size (); i++)
+    if (_levelVector[learnt[i] >> 1] > _levelVector[learnt[1] >> 1])
+      std::swap (learnt[1], learnt[i]);
+  return learnt;
+}
+
+bool
+SatSolver::isRedundant (unsigned int literal) const
+{
+  unsigned int reason = _reasonVector[literal >> 1];
+  if (reason == NoClause)
+    return false;
+  const std::vector<unsigned int> &literals = _clauseVector[reason];
+  for (std::size_t i = 1; i < literals.size (); i++)
+    {
+      unsigned int variable = literals[i] >> 1;
+      if (!_seenVector[variable] && _levelVector[variable] > 0)
+        return false;
+    }
+  return true;
+}
+
+void
+SatSolver::backtrack (unsigned int level)
+{
+  if (decisionLevel () <= level)
+    return;
+  for (std::size_t i = _trail.size (); i > _trailLimitVector[level]; i--)
+    {
+      unsigned int variable = _trail[i - 1] >> 1;
+      _phaseVector[variable] = _assignmentVector[variable];
+      _assignmentVector[variable] = Unassigned;
+      _reasonVector[variable] = NoClause;
+      if (_heapPositionVector[variable] < 0)
+        heapInsert (variable);
+    }
+  _trail.resize (_trailLimitVector[level]);
+  _trailLimitVector.resize (level);
+  _propagationHead = _trail.size ();
+}
+
+void
+SatSolver::bumpActivity (unsigned int variable)
+{
+  _activityVector[variable] += _activityIncrement;
+  if (_activityVector[variable] > 1e100)
+    {
+      for (auto &activity : _activityVector)
+        activity *= 1e-100;
+      _activityIncrement *= 1e-100;
+    }
+  if (_heapPositionVector[variable] >= 0)
+    heapSiftUp (_heapPositionVector[variable]);
+}
+
+void
+SatSolver::decayActivities () noexcept
+{
+  _activityIncrement /= 0.95;
+}
+
+unsigned int
+SatSolver::pickBranchVariable ()
+{
+  while (!_heap.empty ())
+    {
+      unsigned int variable = _heap.front ();
+      _heapPositionVector[variable] = -1;
+      _heap.front () = _heap.back ();
+      _heap.pop_back ();
+      if (!_heap.empty ())
+        {
+          _heapPositionVector[_heap.front ()] = 0;
+          heapSiftDown (0);
+        }
+      if (_assignmentVector[variable] == Unassigned)
+        return variable;
+    }
+  return getNumVariables ();
+}
+
+void
+SatSolver::heapInsert (unsigned int variable)
+{
+  _heapPositionVector[variable] = _heap.size ();
+  _heap.push_back (variable);
+  heapSiftUp (_heap.size () - 1);
+}
+
+void
+SatSolver::heapSiftUp (std::size_t position)
+{
+  unsigned int variable = _heap[position];
+  while (position > 0)
+    {
+      std::size_t parent = (position - 1) / 2;
+      if (_activityVector[_heap[parent]] >= _activityVector[variable])
+        break;
+      _heap[position] = _heap[parent];
+      _heapPositionVector[_heap[position]] = position;
+      position = parent;
+    }
+  _heap[position] = variable;
+  _heapPositionVector[variable] = position;
+}
+
+void
+SatSolver::heapSiftDown (std::size_t position)
+{
+  unsigned int variable = _heap[position];
+  for (;;)
+    {
+      std::size_t child = 2 * position + 1;
+      if (child >= _heap.size ())
+        break;
+      if (child + 1 < _heap.size ()
+          && _activityVector[_heap[child + 1]] > _activityVector[_heap[child]])
+        child++;
+      if (_activityVector[_heap[child]] <= _activityVector[variable])
+        break;
+      _heap[position] = _heap[child];
+      _heapPositionVector[_heap[position]] = position;
+      position = child;
+    }
+  _heap[position] = variable;
+  _heapPositionVector[variable] = position;
+}
+
+std::uint64_t
+SatSolver::luby (std::uint64_t i) noexcept
+{
+  std::uint64_t size = 1;
+  unsigned int sequence = 0;
+  while (size < i + 1)
+    {
+      sequence++;
+      size = 2 * size + 1;
+    }
+  while (size - 1 != i)
+    {
+      size = (size - 1) >> 1;
+      sequence--;
+      i = i % size;
+    }
+  return std::uint64_t (1) << sequence;
+}
+
+SatSolver::Result
+SatSolver::solve (std::uint64_t conflictBudget)
+{
+  if (!_ok || propagate () != NoClause)
+    {
+      _ok = false;
+      return Result::Unsatisfiable;
+    }
+  std::uint64_t numConflicts = 0;
+  std::uint64_t numRestarts = 0;
+  std::uint64_t conflictsToRestart = RestartUnit * luby (0);
+  for (;;)
+    {
+      unsigned int conflict = propagate ();
+      if (conflict != NoClause)
+        {
+          _numConflicts++;
+          numConflicts++;
+          if (decisionLevel () == 0)
+            {
+              _ok = false;
+              return Result::Unsatisfiable;
+            }
+          std::vector<unsigned int> learnt = analyze (conflict);
+          backtrack (learnt.size () == 1 ? 0 : _levelVector[learnt[1] >> 1]);
+          if (learnt.size () == 1)
+            enqueue (learnt[0], NoClause);
+          else
+            {
+              unsigned int asserting = learnt[0];
+              enqueue (asserting, attachClause (std::move (learnt)));
+            }
+          decayActivities ();
+          if (numConflicts >= conflictBudget)
+            {
+              backtrack (0);
+              return Result::Unknown;
+            }
+          if (--conflictsToRestart == 0)
+            {
+              backtrack (0);
+              conflictsToRestart = RestartUnit * luby (++numRestarts);
+            }
+          continue;
+        }
+
+      unsigned int variable = pickBranchVariable ();
+      if (variable == getNumVariables ())
+        {
+          _modelVector.assign (getNumVariables (), false);
+          for (unsigned int v = 0; v < getNumVariables (); v++)
+            _modelVector[v] = _assignmentVector[v] == True;
+          backtrack (0);
+          return Result::Satisfiable;
+        }
+      _trailLimitVector.push_back (_trail.size ());
+      enqueue (literal (variable, _phaseVector[variable] != True), NoClause);
+    }
+}
+
+bool
+SatSolver::getValue (unsigned int variable) const
+{
+  if (variable >= _modelVector.size ())
+    throw std::runtime_error ("Runtime error (SatSolver::getValue): no "
+                              "value for the variable.");
+  return _modelVector[variable];
+}
+
+std::uint64_t
+SatSolver::getNumConflicts () const noexcept
+{
+  return _numConflicts;
+}
@@ -0,0 +1,451 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/SequentialMapper.h"
+
+#include <algorithm>
+#include <iterator>
+
+SequentialMapper::SequentialMapper (const AndInverterGraph &aig,
+                                    unsigned int k, unsigned int c)
+    : _aig (aig), _k (k), _c (c)
+{
+  // Integrity check
+  if (_k < 2)
+    throw std::runtime_error (
+        "Runtime error (SequentialMapper constructor): value of parameter k "
+        "(number of lut inputs) must be greater than 1.");
+  if (_c < 1)
+    throw std::runtime_error (
+        "Runtime error (SequentialMapper constructor): value of parameter c "
+        "(number of priority cuts) must be greater than 0.");
+
+  _firstAndVariable
+      = AndInverterGraph::indexFromLiteral (_aig.getFirstAndLiteral ());
+  _faninVector.reserve (2 * _aig.getNumAnds ());
+  for (unsigned int i = 0; i < _aig.getNumAnds (); i++)
+    {
+      const AndNode &andNode = _aig.getAndNodeFromLiteral (
+          _aig.getFirstAndLiteral () + 2 * i);
+      _faninVector.push_back (resolveDriver (andNode.getFirstChild ()));
+      _faninVector.push_back (resolveDriver (andNode.getSecondChild ()));
+    }
+  _outputWeightVector.assign (_aig.getMaxVariableIndex () + 1, NoOutput);
+  for (const auto &outputLiteral : _aig.getOutputLiteralVector ())
+    {
+      SequentialLeaf driver = resolveDriver (outputLiteral);
+      _outputDriverVector.push_back (driver);
+      if (driver.variable != ConstantVariable)
+        _outputWeightVector[driver.variable] = std::min (
+            _outputWeightVector[driver.variable], driver.weight);
+    }
+  _cutSetVector.assign (_aig.getNumAnds (), {});
+  _labelVector.assign (_aig.getMaxVariableIndex () + 1, 0);
+
+  // Nodes that reach an output, through and-nodes and latches
+  _isLive.assign (_aig.getMaxVariableIndex () + 1, false);
+  std::vector<unsigned int> stack;
+  auto visit = [&] (const SequentialLeaf &leaf) {
+    if (leaf.variable != ConstantVariable && !_isLive[leaf.variable])
+      {
+        _isLive[leaf.variable] = true;
+        if (leaf.variable >= _firstAndVariable)
+          {
+            _numLiveAnds++;
+            stack.push_back (leaf.variable);
+          }
+      }
+  };
+  for (const auto &driver : _outputDriverVector)
+    visit (driver);
+  while (!stack.empty ())
+    {
+      unsigned int andIndex = stack.back () - _firstAndVariable;
+      stack.pop_back ();
+      visit (_faninVector[2 * andIndex]);
+      visit (_faninVector[2 * andIndex + 1]);
+    }
+}
+
+SequentialMapper::SequentialLeaf
+SequentialMapper::resolveDriver (unsigned int literal) const
+{
+  SequentialLeaf driver = { AndInverterGraph::indexFromLiteral (literal), 0 };
+  while (literal >= 2 && _aig.nodeIsLatch (literal))
+    {
+      if (++driver.weight > _aig.getNumLatches ())
+        throw std::runtime_error (
+            "Runtime error (SequentialMapper): the latch with literal "
+            + std::to_string (literal) + " is in a loop of latches.");
+      literal = _aig.getLatchNodeFromLiteral (literal - literal % 2)
+                    .getNextQ ();
+      driver.variable = AndInverterGraph::indexFromLiteral (literal);
+    }
+  if (literal < 2)
+    driver.variable = ConstantVariable;
+  return driver;
+}
+
+int
+SequentialMapper::cutLabel (const SequentialCut &cut, int period) const
+{
+  int label = 0;
+  for (const auto &leaf : cut)
+    label = std::max (label, _labelVector[leaf.variable]
+                                 - period * static_cast<int> (leaf.weight));
+  return label + 1;
+}
+
+int
+SequentialMapper::enumerateCuts (unsigned int andVariable, int period,
+                                 bool retime)
+{
+  // Cuts of a fanin, seen from the node: its own leaf and, unless a latch
+  // stops the expansion, its priority cuts shifted by the latches between
+  // them
+  auto faninCuts = [&] (const SequentialLeaf &fanin) {
+    std::vector<SequentialCut> cuts;
+    if (fanin.variable == ConstantVariable)
+      {
+        cuts.emplace_back ();
+        return cuts;
+      }
+    cuts.push_back ({ fanin });
+    if (fanin.variable < _firstAndVariable || (!retime && fanin.weight > 0))
+      return cuts;
+    for (const auto &cut : _cutSetVector[fanin.variable - _firstAndVariable])
+      {
+        SequentialCut shiftedCut = cut;
+        bool isFeasible = true;
+        for (auto &leaf : shiftedCut)
+          {
+            leaf.weight += fanin.weight;
+            isFeasible = isFeasible && leaf.weight <= MaxLeafWeight;
+          }
+        if (isFeasible || fanin.weight == 0)
+          cuts.push_back (std::move (shiftedCut));
+      }
+    return cuts;
+  };
+  unsigned int andIndex = andVariable - _firstAndVariable;
+  std::vector<SequentialCut> firstCuts
+      = faninCuts (_faninVector[2 * andIndex]);
+  std::vector<SequentialCut> secondCuts
+      = faninCuts (_faninVector[2 * andIndex + 1]);
+
+  std::vector<SequentialCut> cuts;
+  for (const auto &firstCut : firstCuts)
+    for (const auto &secondCut : secondCuts)
+      {
+        SequentialCut cut;
+        std::set_union (firstCut.begin (), firstCut.end (),
+                        secondCut.begin (), secondCut.end (),
+                        std::back_inserter (cut));
+        if (cut.size () <= _k)
+          cuts.push_back (std::move (cut));
+      }
+  std::sort (cuts.begin (), cuts.end ());
+  cuts.erase (std::unique (cuts.begin (), cuts.end ()), cuts.end ());
+
+  // Without retiming, a latch is a leaf of label 0
+  std::vector<std::pair<int, std::size_t>> rankVector;
+  for (std::size_t i = 0; i < cuts.size (); i++)
+    {
+      int label;
+      if (retime)
+        label = cutLabel (cuts[i], period);
+      else
+        {
+          label = 0;
+          for (const auto &leaf : cuts[i])
+            if (leaf.weight == 0)
+              label = std::max (label, _labelVector[leaf.variable]);
+          label++;
+        }
+      rankVector.push_back ({ label, i });
+    }
+  std::sort (rankVector.begin (), rankVector.end (),
+             [&cuts] (const auto &lhs, const auto &rhs) {
+               if (lhs.first != rhs.first)
+                 return lhs.first < rhs.first;
+               if (cuts[lhs.second].size () != cuts[rhs.second].size ())
+                 return cuts[lhs.second].size () < cuts[rhs.second].size ();
+               return lhs.second < rhs.second;
+             });
+  std::vector<SequentialCut> &cutSet = _cutSetVector[andIndex];
+  cutSet.clear ();
+  for (std::size_t i = 0; i < rankVector.size () && i < _c; i++)
+    cutSet.push_back (std::move (cuts[rankVector[i].second]));
+  return rankVector.front ().first;
+}
+
+bool
+SequentialMapper::computeLabels (int period)
+{
+  // Labels only grow, so the period is infeasible as soon as an output
+  // exceeds it; a node that reaches an output (the others are not labeled)
+  // has a label of at most the period times the number of latches plus one.
+  // Without a positive cycle, a longest path visits each mapped node once
+  // and the labels settle within one pass per node
+  int bound = period * static_cast<int> (_aig.getNumLatches () + 1);
+  std::fill (_labelVector.begin (), _labelVector.end (), 0);
+  for (auto &cutSet : _cutSetVector)
+    cutSet.clear ();
+  bool changed = true;
+  for (unsigned int pass = 0; changed; pass++)
+    {
+      if (pass > _numLiveAnds)
+        return false;
+      changed = false;
+      for (unsigned int v = _firstAndVariable;
+           v <= _aig.getMaxVariableIndex (); v++)
+        {
+          if (!_isLive[v])
+            continue;
+          int label = std::max (_labelVector[v],
+                                enumerateCuts (v, period, true));
+          if (label > bound)
+            return false;
+          if (_outputWeightVector[v] != NoOutput
+              && label - period * static_cast<int> (_outputWeightVector[v])
+                     > period)
+            return false;
+          changed = changed || label != _labelVector[v];
+          _labelVector[v] = label;
+        }
+    }
+  return true;
+}
+
+unsigned int
+SequentialMapper::computeUnretimedPeriod ()
+{
+  std::fill (_labelVector.begin (), _labelVector.end (), 0);
+  for (unsigned int v = _firstAndVariable; v <= _aig.getMaxVariableIndex ();
+       v++)
+    if (_isLive[v])
+      _labelVector[v] = enumerateCuts (v, 0, false);
+
+  // The period is the depth of the outputs and of the latch inputs
+  unsigned int period = 0;
+  auto updatePeriod = [&] (unsigned int literal) {
+    if (literal >= 2 && !_aig.nodeIsLatch (literal)
+        && _isLive[AndInverterGraph::indexFromLiteral (literal)])
+      period = std::max<unsigned int> (
+          period, _labelVector[AndInverterGraph::indexFromLiteral (literal)]);
+  };
+  for (const auto &outputLiteral : _aig.getOutputLiteralVector ())
+    updatePeriod (outputLiteral);
+  for (unsigned int i = 0; i < _aig.getNumLatches (); i++)
+    updatePeriod (_aig.getLatchNodeFromLiteral (
+                          _aig.getFirstLatchLiteral () + 2 * i)
+                      .getNextQ ());
+  return period;
+}
+
+void
+SequentialMapper::buildCover ()
+{
+  // Lookup tables reached from the outputs through the best cuts
+  std::vector<bool> &isImplemented = _isImplementedVector;
+  isImplemented.assign (_aig.getMaxVariableIndex () + 1, false);
+  std::vector<unsigned int> stack;
+  auto implement = [&] (const SequentialLeaf &leaf) {
+    if (leaf.variable != ConstantVariable && leaf.variable >= _firstAndVariable
+        && !isImplemented[leaf.variable])
+      {
+        isImplemented[leaf.variable] = true;
+        stack.push_back (leaf.variable);
+      }
+  };
+  for (const auto &driver : _outputDriverVector)
+    implement (driver);
+  while (!stack.empty ())
+    {
+      unsigned int v = stack.back ();
+      stack.pop_back ();
+      for (const auto &leaf : _cutSetVector[v - _firstAndVariable].front ())
+        implement (leaf);
+    }
+
+  // Retiming lags: ceil(label / period) - 1 for the lookup tables, 0 for the
+  // inputs and outputs. The registers of an edge are its latches plus the
+  // lag of its sink minus the lag of its source; the fanouts of a node share
+  // their registers
+  int period = _clockPeriod;
+  auto lagOf = [&] (unsigned int variable) {
+    if (variable < _firstAndVariable)
+      return 0;
+    return (_labelVector[variable] + period - 1) / period - 1;
+  };
+  std::vector<int> registersVector (_aig.getMaxVariableIndex () + 1, 0);
+  auto addEdge = [&] (const SequentialLeaf &source, int sinkLag) {
+    if (source.variable == ConstantVariable)
+      return;
+    int numRegisters = static_cast<int> (source.weight) + sinkLag
+                       - lagOf (source.variable);
+    if (numRegisters < 0)
+      throw std::runtime_error ("Runtime error (SequentialMapper::run): the "
+                                "labels do not give a legal retiming.");
+    registersVector[source.variable]
+        = std::max (registersVector[source.variable], numRegisters);
+  };
+  _mappingAreaCost = 0;
+  _lagVector.assign (_aig.getMaxVariableIndex () + 1, 0);
+  for (unsigned int v = _firstAndVariable; v <= _aig.getMaxVariableIndex ();
+       v++)
+    if (isImplemented[v])
+      {
+        _mappingAreaCost++;
+        _lagVector[v] = lagOf (v);
+        for (const auto &leaf : _cutSetVector[v - _firstAndVariable].front ())
+          addEdge (leaf, lagOf (v));
+      }
+  for (const auto &driver : _outputDriverVector)
+    addEdge (driver, 0);
+  _numRegisters = 0;
+  for (const auto &numRegisters : registersVector)
+    _numRegisters += numRegisters;
+}
+
+void
+SequentialMapper::run ()
+{
+  _unretimedClockPeriod = computeUnretimedPeriod ();
+  if (_unretimedClockPeriod == 0)
+    {
+      _clockPeriod = 0;
+      _mappingAreaCost = 0;
+      _isImplementedVector.assign (_aig.getMaxVariableIndex () + 1, false);
+      _lagVector.assign (_aig.getMaxVariableIndex () + 1, 0);
+      _numRegisters = _aig.getNumLatches ();
+      return;
+    }
+
+  // The unretimed period is feasible: the latches may stay where they are
+  unsigned int low = 1;
+  unsigned int high = _unretimedClockPeriod;
+  while (!computeLabels (high))
+    {
+      if (high > 4 * _unretimedClockPeriod)
+        throw std::runtime_error ("Runtime error (SequentialMapper::run): no "
+                                  "feasible clock period was found.");
+      high *= 2;
+    }
+  while (low < high)
+    {
+      unsigned int middle = low + (high - low) / 2;
+      if (computeLabels (middle))
+        high = middle;
+      else
+        low = middle + 1;
+    }
+  _clockPeriod = low;
+  computeLabels (_clockPeriod);
+  buildCover ();
+}
+
+unsigned int
+SequentialMapper::getClockPeriod () const noexcept
+{
+  return _clockPeriod;
+}
+
+unsigned int
+SequentialMapper::getUnretimedClockPeriod () const noexcept
+{
+  return _unretimedClockPeriod;
+}
+
+unsigned int
+SequentialMapper::getMappingAreaCost () const noexcept
+{
+  return _mappingAreaCost;
+}
+
+unsigned int
+SequentialMapper::getNumRegisters () const noexcept
+{
+  return _numRegisters;
+}
+
+int
+SequentialMapper::getLabel (unsigned int nodeLiteral) const
+{
+  unsigned int nodeVariable = AndInverterGraph::indexFromLiteral (nodeLiteral);
+  if (nodeVariable >= _labelVector.size ())
+    throw std::runtime_error (
+        "Runtime error (getLabel): the value provided in nodeLiteral argument "
+        "is not a valid literal for the given AIG.");
+  return _labelVector[nodeVariable];
+}
+
+bool
+SequentialMapper::isImplemented (unsigned int andLiteral) const
+{
+  if (!_aig.nodeIsAnd (andLiteral))
+    throw std::runtime_error (
+        "Runtime error (isImplemented): the value provided in andLiteral "
+        "argument is not a valid and-literal for the given AIG.");
+  unsigned int andVariable = AndInverterGraph::indexFromLiteral (andLiteral);
+  return andVariable < _isImplementedVector.size ()
+         && _isImplementedVector[andVariable];
+}
+
+int
+SequentialMapper::getLag (unsigned int andLiteral) const
+{
+  if (!isImplemented (andLiteral))
+    throw std::runtime_error (
+        "Runtime error (getLag): the and-node is not the root of a lookup "
+        "table of the cover. Call isImplemented() to check for it before "
+        "calling getLag().");
+  return _lagVector[AndInverterGraph::indexFromLiteral (andLiteral)];
+}
+
+void
+SequentialMapper::printResults (std::ostream &os) const
+{
+  os << ">> Sequential mapping results" << std::endl;
+  os << "# LUT count: " << _mappingAreaCost << std::endl;
+  os << "# Clock period: " << _clockPeriod << std::endl;
+  os << "# Clock period without retiming: " << _unretimedClockPeriod
+     << std::endl;
+  os << "# Registers: " << _numRegisters << " (" << _aig.getNumLatches ()
+     << " latches before retiming)" << std::endl;
+}
+
+void
+SequentialMapper::printImplementation (std::ostream &os) const
+{
+  os << ">> Sequential implementation: " << std::endl;
+  for (unsigned int v = _firstAndVariable; v < _isImplementedVector.size ();
+       v++)
+    {
+      os << "(" << AndInverterGraph::literalFromIndex (v) << ") => ";
+      if (!_isImplementedVector[v])
+        {
+          os << "not implemented" << std::endl;
+          continue;
+        }
+      os << "( ";
+      for (const auto &leaf : _cutSetVector[v - _firstAndVariable].front ())
+        {
+          if (leaf.variable == ConstantVariable)
+            os << "const";
+          else
+            os << AndInverterGraph::literalFromIndex (leaf.variable);
+          if (leaf.weight > 0)
+            os << "@" << leaf.weight;
+          os << " ";
+        }
+      os << ") : lag = " << _lagVector[v] << std::endl;
+    }
+}
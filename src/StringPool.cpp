@@ -0,0 +1,81 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/StringPool.h"
+
+#include <cstring>
+#include <stdexcept>
+
+unsigned int
+StringPool::intern (std::string_view text)
+{
+  auto found = _idMap.find (text);
+  if (found != _idMap.end ())
+    return found->second;
+
+  // Copy the string to the current block, or to a new one if it does not
+  // fit. Strings longer than a block get a block of their own
+  char *storage;
+  if (text.size () > BlockSize)
+    {
+      _blockVector.push_back (std::make_unique<char[]> (text.size ()));
+      _blockUsed = BlockSize;
+      storage = _blockVector.back ().get ();
+    }
+  else
+    {
+      if (_blockUsed + text.size () > BlockSize)
+        {
+          _blockVector.push_back (std::make_unique<char[]> (BlockSize));
+          _blockUsed = 0;
+        }
+      storage = _blockVector.back ().get () + _blockUsed;
+      _blockUsed += text.size ();
+    }
+  std::memcpy (storage, text.data (), text.size ());
+  _numBytes += text.size ();
+
+  std::string_view stored (storage, text.size ());
+  unsigned int id = _stringVector.size ();
+  _stringVector.push_back (stored);
+  _idMap.emplace (stored, id);
+  return id;
+}
+
+std::string_view
+StringPool::getString (unsigned int id) const
+{
+  if (id >= _stringVector.size ())
+    throw std::out_of_range (
+        "Runtime error (getString): the identifier is not in the pool.");
+  return _stringVector[id];
+}
+
+unsigned int
+StringPool::getNumStrings () const noexcept
+{
+  return _stringVector.size ();
+}
+
+std::size_t
+StringPool::getNumBytes () const noexcept
+{
+  return _numBytes;
+}
+
+void
+StringPool::clear () noexcept
+{
+  _blockVector.clear ();
+  _blockUsed = BlockSize;
+  _numBytes = 0;
+  _stringVector.clear ();
+  _idMap.clear ();
+}
@@ -9,23 +9,44 @@
  */
 
 #include "../include/TechMapper.h"
+#include "../include/AllocationTracker.h"
 
-TechMapper::TechMapper (CutEngine &cutEngine)
-    : _aig (cutEngine.getAndInverterGraph ()), _cutEngine (cutEngine)
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+// Frontiers smaller than this are expanded by the calling thread alone,
+// since waking the other threads would cost more than the work
+constexpr std::size_t MinParallelFrontier = 1024;
+
+// Work of one thread during cover extraction, on its own cache line
+struct alignas (64) CoverReduction
+{
+  std::vector<unsigned int> nextFrontier;
+  unsigned int numLuts = 0;
+  unsigned int delayCost = 0;
+  unsigned int estimatedDelay = 0;
+};
+}
+
+template <typename ObserverPolicy>
+TechMapperBase<ObserverPolicy>::TechMapperBase (MappingEngine &mappingEngine)
+    : _aig (mappingEngine.getAndInverterGraph ()),
+      _mappingEngine (mappingEngine)
 {
   // Memory allocation and vector initialization
   try
     {
+      TMAP_ALLOCATION_SUBSYSTEM ("implementation map");
       _mappingAreaCost = 0;
       _mappingDelayCost = 0;
       _mappingPowerCost = 0;
-      _implementationMap.clear ();
-      unsigned int firstAndVariable
-          = AndInverterGraph::indexFromLiteral (_aig.getFirstAndLiteral ());
-      unsigned int lastAndVariable = firstAndVariable + _aig.getNumAnds ();
-      for (int i = firstAndVariable; i < lastAndVariable; i++)
-        _implementationMap.emplace (AndInverterGraph::literalFromIndex (i),
-                                    false);
+      _implementedBitmap = std::vector<std::atomic<std::uint64_t>> (
+          (_aig.getNumAnds () + 63) / 64);
+      for (auto &word : _implementedBitmap)
+        word.store (0, std::memory_order_relaxed);
     }
   catch (const std::exception &e)
     {
@@ -35,109 +56,515 @@ TechMapper::TechMapper (CutEngine &cutEngine)
     }
 }
 
+template <typename ObserverPolicy>
 void
-TechMapper::run ()
+TechMapperBase<ObserverPolicy>::run ()
 {
-  // Iterates over all AIG outputs
-  for (const auto &outputLiteral : _aig.getOutputLiteralVector ())
+  TMAP_ALLOCATION_SUBSYSTEM ("cover");
+
+  // The first cover is built from the cuts the engine already has, so the
+  // enumeration done before run() is not thrown away
+  std::vector<unsigned int> estimateVector
+      = _mappingEngine.getFanoutEstimates ();
+  bool usesFanout = !estimateVector.empty ()
+                    && _mappingEngine.getDelayModel ().dependsOnFanout ();
+
+  // Each pass builds a cover with fanout estimates updated from the previous
+  // one, until they do not change or the passes are over. The estimates of
+  // the cover with the smallest delay (then area) are kept, since the passes
+  // are not guaranteed to improve
+  std::vector<unsigned int> bestEstimateVector = estimateVector;
+  unsigned int bestDelay = -1;
+  unsigned int bestArea = -1;
+  _numPasses = 0;
+  _converged = true;
+  while (true)
     {
-      // The output is an and-node
-      if (_aig.nodeIsAnd (outputLiteral))
+      coverOutputs ();
+      _numPasses++;
+      std::vector<unsigned int> coverFanoutVector = evaluateCoverFanouts ();
+      evaluateCoverDelay (coverFanoutVector);
+      if (!usesFanout)
+        break;
+      if (_mappingEstimatedDelay < bestDelay
+          || (_mappingEstimatedDelay == bestDelay
+              && _mappingAreaCost < bestArea))
+        {
+          bestDelay = _mappingEstimatedDelay;
+          bestArea = _mappingAreaCost;
+          bestEstimateVector = estimateVector;
+        }
+      if (_numPasses >= _maxPasses)
         {
-          // Sometimes the output literal is inverted (odd number)
-          unsigned int evenOutputLiteral = outputLiteral;
-          if (evenOutputLiteral % 2 == 1)
-            evenOutputLiteral--;
+          _converged = false;
+          break;
+        }
 
-          // The output is not yet implemented
-          if (_implementationMap[evenOutputLiteral] == false)
-            {
-              // Find K-feasible cuts for the output
-              _cutEngine.findCuts (outputLiteral);
+      // Estimates move a third of the way towards the fanouts of the cover
+      // (rounding up), which damps oscillations between passes
+      std::vector<unsigned int> newEstimateVector (estimateVector.size ());
+      for (unsigned int i = 0; i < estimateVector.size (); i++)
+        newEstimateVector[i]
+            = (2 * estimateVector[i] + coverFanoutVector[i] + 2) / 3;
+      if (newEstimateVector == estimateVector)
+        break;
+      estimateVector = std::move (newEstimateVector);
+      _mappingEngine.updateFanoutEstimates (estimateVector);
+    }
 
-              // Set as implemented
-              _implementationMap[evenOutputLiteral] = true;
+  // Build the best cover again if it was not the last one
+  if (usesFanout && bestEstimateVector != estimateVector)
+    {
+      _mappingEngine.updateFanoutEstimates (bestEstimateVector);
+      coverOutputs ();
+      _numPasses++;
+      evaluateCoverDelay (evaluateCoverFanouts ());
+    }
+
+  this->notifyCoverFinalized (_mappingAreaCost, _mappingDelayCost,
+                              _mappingEstimatedDelay);
+}
 
-              // Update mapping area cost
+template <typename ObserverPolicy>
+void
+TechMapperBase<ObserverPolicy>::setMaxPasses (unsigned int maxPasses) noexcept
+{
+  _maxPasses = std::max (1u, maxPasses);
+}
+
+template <typename ObserverPolicy>
+unsigned int
+TechMapperBase<ObserverPolicy>::getNumPasses () const noexcept
+{
+  return _numPasses;
+}
+
+template <typename ObserverPolicy>
+bool
+TechMapperBase<ObserverPolicy>::hasConverged () const noexcept
+{
+  return _converged;
+}
+
+template <typename ObserverPolicy>
+void
+TechMapperBase<ObserverPolicy>::setNumThreads (
+    unsigned int numThreads) noexcept
+{
+  numThreads = std::max (1u, numThreads);
+  if (numThreads != _numThreads)
+    _workerPool.reset ();
+  _numThreads = numThreads;
+}
+
+template <typename ObserverPolicy>
+unsigned int
+TechMapperBase<ObserverPolicy>::getNumThreads () const noexcept
+{
+  return _numThreads;
+}
+
+template <typename ObserverPolicy>
+bool
+TechMapperBase<ObserverPolicy>::isImplemented (unsigned int andLiteral) const
+{
+  if (!_aig.nodeIsAnd (andLiteral))
+    throw std::runtime_error (
+        "Runtime error (isImplemented): the value provided in andLiteral "
+        "argument is not a valid and-literal for the AndInverterGraph "
+        "object.");
+  unsigned int bit = AndInverterGraph::indexFromLiteral (andLiteral)
+                     - AndInverterGraph::indexFromLiteral (
+                         _aig.getFirstAndLiteral ());
+  return _implementedBitmap[bit / 64].load (std::memory_order_relaxed)
+         & (std::uint64_t (1) << (bit % 64));
+}
+
+template <typename ObserverPolicy>
+bool
+TechMapperBase<ObserverPolicy>::markImplemented (unsigned int andLiteral)
+{
+  unsigned int bit = AndInverterGraph::indexFromLiteral (andLiteral)
+                     - AndInverterGraph::indexFromLiteral (
+                         _aig.getFirstAndLiteral ());
+  std::uint64_t mask = std::uint64_t (1) << (bit % 64);
+  return !(_implementedBitmap[bit / 64].fetch_or (mask,
+                                                  std::memory_order_relaxed)
+           & mask);
+}
+
+template <typename ObserverPolicy>
+void
+TechMapperBase<ObserverPolicy>::runOnThreads (
+    const std::function<void (unsigned int)> &task)
+{
+  if (_numThreads == 1)
+    {
+      task (0);
+      return;
+    }
+  if (!_workerPool)
+    _workerPool = std::make_unique<WorkerPool> (_numThreads);
+  _workerPool->runOnAll (task);
+}
+
+template <typename ObserverPolicy>
+void
+TechMapperBase<ObserverPolicy>::coverOutputs ()
+{
+  // Find the cuts of every node not found yet (e.g. after the fanout
+  // estimates changed)
+  _mappingEngine.run ();
+
+  // Start from an empty cover
+  _mappingAreaCost = 0;
+  _mappingDelayCost = 0;
+  for (auto &word : _implementedBitmap)
+    word.store (0, std::memory_order_relaxed);
+
+  // The and-nodes driving outputs are the first frontier. Outputs driven by
+  // an input, GND or VDD are implemented by one lookup table each (delay is
+  // evaluated in evaluateCoverDelay()). An and-node whose selected cut has no
+  // leaves is a constant driver, which takes no lookup table
+  std::vector<unsigned int> frontier;
+  for (const auto &outputLiteral : _aig.getOutputLiteralVector ())
+    if (_aig.nodeIsAnd (outputLiteral))
+      {
+        // Sometimes the output literal is inverted (odd number)
+        unsigned int evenOutputLiteral = outputLiteral - outputLiteral % 2;
+        _mappingEngine.findCuts (outputLiteral);
+        if (markImplemented (evenOutputLiteral))
+          {
+            if (_mappingEngine.getSelectedCut (evenOutputLiteral)
+                    .numNodeVariables ()
+                > 0)
               _mappingAreaCost++;
+            frontier.push_back (evenOutputLiteral);
+          }
+      }
+    else if (_aig.nodeIsInput (outputLiteral) || outputLiteral < 2)
+      _mappingAreaCost++;
 
-              // Update mapping delay cost
-              const Cut &outputBestCut
-                  = _cutEngine.getBestCut (evenOutputLiteral);
-              unsigned int maxDepth = outputBestCut.getDelayCost ();
-              _mappingDelayCost = _mappingDelayCost < maxDepth
-                                      ? maxDepth
-                                      : _mappingDelayCost;
-
-              // Get all and-nodes in the best cut of outputLiteral
-              std::set<unsigned int> currentIteration;
-              for (const auto &nodeIndex : outputBestCut)
-                if (_aig.nodeIsAnd (
-                        AndInverterGraph::literalFromIndex (nodeIndex)))
-                  currentIteration.emplace (
-                      AndInverterGraph::literalFromIndex (nodeIndex));
-
-              // Check if some of the and-nodes are unimplemented
-              // If so, mark the and-node as implemented and check whether the
-              // the and-nodes in its best cut is implemented, iteratively
-              while (!currentIteration.empty ())
+  // Each frontier holds the nodes implemented by the previous one; the
+  // and-nodes in their selected cuts that are not implemented yet form the
+  // next. Which thread claims a node does not change the set of nodes
+  // implemented, so the cover does not depend on the number of threads
+  std::vector<CoverReduction> reductionVector (_numThreads);
+  while (!frontier.empty ())
+    {
+      unsigned int numWorkers
+          = frontier.size () < MinParallelFrontier ? 1 : _numThreads;
+      auto expandFrontier = [&] (unsigned int worker) {
+        TMAP_ALLOCATION_SUBSYSTEM ("cover");
+        CoverReduction &reduction = reductionVector[worker];
+        reduction.nextFrontier.clear ();
+        reduction.numLuts = 0;
+        if (worker >= numWorkers)
+          return;
+        for (std::size_t i = worker; i < frontier.size (); i += numWorkers)
+          for (const auto &nodeIndex :
+               _mappingEngine.getSelectedCut (frontier[i]))
+            {
+              unsigned int nodeLiteral
+                  = AndInverterGraph::literalFromIndex (nodeIndex);
+              if (_aig.nodeIsAnd (nodeLiteral)
+                  && markImplemented (nodeLiteral))
                 {
-                  // Prepares a set for the next iteration
-                  std::set<unsigned int> nextIteration;
-
-                  // For each unimplemented and-node
-                  for (const auto &nodeLiteral : currentIteration)
-                    if (_implementationMap[nodeLiteral] == false)
-                      {
-                        // Mark it as implemented and update area cost
-                        _implementationMap[nodeLiteral] = true;
-                        _mappingAreaCost++;
-
-                        // Add all its and-nodes to be checked in the next
-                        // iteration
-                        const Cut &nodeLiteralBestCut
-                            = _cutEngine.getBestCut (nodeLiteral);
-                        for (const auto &nodeIndex : nodeLiteralBestCut)
-                          if (_aig.nodeIsAnd (
-                                  AndInverterGraph::literalFromIndex (
-                                      nodeIndex)))
-                            nextIteration.emplace (
-                                AndInverterGraph::literalFromIndex (
-                                    nodeIndex));
-                      }
-
-                  // Update the set of nodes to be checked
-                  currentIteration = nextIteration;
+                  if (_mappingEngine.getSelectedCut (nodeLiteral)
+                          .numNodeVariables ()
+                      > 0)
+                    reduction.numLuts++;
+                  reduction.nextFrontier.push_back (nodeLiteral);
                 }
             }
+      };
+      if (numWorkers == 1)
+        expandFrontier (0);
+      else
+        runOnThreads (expandFrontier);
+
+      frontier.clear ();
+      for (unsigned int worker = 0; worker < numWorkers; worker++)
+        {
+          const CoverReduction &reduction = reductionVector[worker];
+          _mappingAreaCost += reduction.numLuts;
+          frontier.insert (frontier.end (), reduction.nextFrontier.begin (),
+                           reduction.nextFrontier.end ());
         }
+    }
+}
+
+template <typename ObserverPolicy>
+std::vector<unsigned int>
+TechMapperBase<ObserverPolicy>::evaluateCoverFanouts () const
+{
+  std::vector<unsigned int> coverFanoutVector (_aig.getMaxVariableIndex () + 1,
+                                               0);
+  for (const auto &outputLiteral : _aig.getOutputLiteralVector ())
+    coverFanoutVector[AndInverterGraph::indexFromLiteral (outputLiteral)]++;
+  for (unsigned int i = 0; i < _aig.getNumAnds (); i++)
+    {
+      unsigned int node = _aig.getFirstAndLiteral () + 2 * i;
+      if (isImplemented (node))
+        for (const auto &leafVariable : _mappingEngine.getSelectedCut (node))
+          coverFanoutVector[leafVariable]++;
+    }
+  return coverFanoutVector;
+}
+
+template <typename ObserverPolicy>
+void
+TechMapperBase<ObserverPolicy>::evaluateCoverDelay (
+    const std::vector<unsigned int> &coverFanoutVector)
+{
+  // Level and arrival time of the output of each lookup table, indexed by
+  // variable index. Sources and constant drivers are at level 0 and their
+  // outputs arrive at 0
+  DelayModel delayModel = _mappingEngine.getDelayModel ();
+  std::vector<unsigned int> levelVector (_aig.getMaxVariableIndex () + 1, 0);
+  std::vector<unsigned int> arrivalVector (_aig.getMaxVariableIndex () + 1, 0);
 
-      // The output is directly connected to an input, GND or VDD
-      else if (_aig.nodeIsInput (outputLiteral) || outputLiteral < 2)
+  // And-nodes are stored in topological order
+  for (unsigned int i = 0; i < _aig.getNumAnds (); i++)
+    {
+      unsigned int node = _aig.getFirstAndLiteral () + 2 * i;
+      if (!isImplemented (node))
+        continue;
+      const Cut &selectedCut = _mappingEngine.getSelectedCut (node);
+      if (selectedCut.numNodeVariables () == 0)
+        continue;
+      unsigned int level = 0;
+      unsigned int latestArrival = 0;
+      for (const auto &leafVariable : selectedCut)
         {
-          // Update area and delay costs
-          _mappingAreaCost++;
-          _mappingDelayCost = _mappingDelayCost < 1 ? 1 : _mappingDelayCost;
+          level = std::max (level, levelVector[leafVariable]);
+          unsigned int netDelay
+              = delayModel.getNetDelay (coverFanoutVector[leafVariable]);
+          latestArrival = std::max (latestArrival,
+                                    arrivalVector[leafVariable] + netDelay);
         }
+      unsigned int variable = AndInverterGraph::indexFromLiteral (node);
+      levelVector[variable] = level + 1;
+      arrivalVector[variable] = latestArrival + delayModel.lutDelay;
+    }
+
+  // Outputs driven by an input, GND or VDD are implemented by one lookup
+  // table. Each thread reduces the maxima over a share of the outputs
+  const std::vector<unsigned int> &outputs = _aig.getOutputLiteralVector ();
+  unsigned int numWorkers
+      = outputs.size () < MinParallelFrontier ? 1 : _numThreads;
+  std::vector<CoverReduction> reductionVector (numWorkers);
+  auto reduceOutputs = [&] (unsigned int worker) {
+    if (worker >= numWorkers)
+      return;
+    CoverReduction &reduction = reductionVector[worker];
+    for (std::size_t i = worker; i < outputs.size (); i += numWorkers)
+      {
+        unsigned int variable
+            = AndInverterGraph::indexFromLiteral (outputs[i]);
+        if (_aig.nodeIsAnd (outputs[i]))
+          {
+            reduction.delayCost
+                = std::max (reduction.delayCost, levelVector[variable]);
+            reduction.estimatedDelay
+                = std::max (reduction.estimatedDelay, arrivalVector[variable]);
+          }
+        else if (_aig.nodeIsInput (outputs[i]) || outputs[i] < 2)
+          {
+            reduction.delayCost = std::max (reduction.delayCost, 1u);
+            reduction.estimatedDelay
+                = std::max (reduction.estimatedDelay, delayModel.lutDelay);
+          }
+      }
+  };
+  if (numWorkers == 1)
+    reduceOutputs (0);
+  else
+    runOnThreads (reduceOutputs);
+
+  _mappingDelayCost = 0;
+  _mappingEstimatedDelay = 0;
+  for (const auto &reduction : reductionVector)
+    {
+      _mappingDelayCost = std::max (_mappingDelayCost, reduction.delayCost);
+      _mappingEstimatedDelay
+          = std::max (_mappingEstimatedDelay, reduction.estimatedDelay);
     }
 }
 
+template <typename ObserverPolicy>
+unsigned int
+TechMapperBase<ObserverPolicy>::getMappingAreaCost () const noexcept
+{
+  return _mappingAreaCost;
+}
+
+template <typename ObserverPolicy>
+unsigned int
+TechMapperBase<ObserverPolicy>::getMappingDelayCost () const noexcept
+{
+  return _mappingDelayCost;
+}
+
+template <typename ObserverPolicy>
+unsigned int
+TechMapperBase<ObserverPolicy>::getMappingEstimatedDelay () const noexcept
+{
+  return _mappingEstimatedDelay;
+}
+
+template <typename ObserverPolicy>
+std::uint64_t
+TechMapperBase<ObserverPolicy>::getFingerprint () const
+{
+  // 64-bit FNV-1a over the words of the cover
+  std::uint64_t fingerprint = 0xcbf29ce484222325ULL;
+  auto hashWord = [&fingerprint] (std::uint32_t word) {
+    for (unsigned int i = 0; i < 4; i++)
+      {
+        fingerprint ^= (word >> (8 * i)) & 0xff;
+        fingerprint *= 0x100000001b3ULL;
+      }
+  };
+  for (unsigned int i = 0; i < _aig.getNumAnds (); i++)
+    {
+      unsigned int node = _aig.getFirstAndLiteral () + 2 * i;
+      if (isImplemented (node))
+        {
+          const Cut &selectedCut = _mappingEngine.getSelectedCut (node);
+          hashWord (node);
+          hashWord (selectedCut.numNodeVariables ());
+          for (const auto &leafVariable : selectedCut)
+            hashWord (leafVariable);
+        }
+    }
+  return fingerprint;
+}
+
+template <typename ObserverPolicy>
 void
-TechMapper::printResults (std::ostream &os)
+TechMapperBase<ObserverPolicy>::printResults (std::ostream &os)
 {
   os << ">> Technology Mapping results" << std::endl;
   os << "# LUT count: " << _mappingAreaCost << std::endl;
   os << "# Levels: " << _mappingDelayCost << std::endl;
+  if (_mappingEngine.getDelayModel ().dependsOnFanout ())
+    {
+      os << "# Estimated delay: " << _mappingEstimatedDelay << std::endl;
+      os << "# Mapping passes: " << _numPasses;
+      if (!_converged)
+        os << " (limit reached, the fanout estimates did not converge)";
+      os << std::endl;
+    }
+  std::ios_base::fmtflags flags = os.flags ();
+  os << "# Fingerprint: " << std::hex << std::setw (16) << std::setfill ('0')
+     << getFingerprint () << std::setfill (' ') << std::endl;
+  os.flags (flags);
+}
+
+template <typename ObserverPolicy>
+void
+TechMapperBase<ObserverPolicy>::writeReport (JsonWriter &writer) const
+{
+  // Levels of the lookup tables, as in evaluateCoverDelay(), and their
+  // number of inputs
+  std::vector<unsigned int> levelVector (_aig.getMaxVariableIndex () + 1, 0);
+  std::vector<unsigned int> lutsByInputs (1, 0);
+  std::vector<unsigned int> levelHistogram (_mappingDelayCost, 0);
+  auto countLut = [&] (unsigned int numInputs, unsigned int level) {
+    if (numInputs >= lutsByInputs.size ())
+      lutsByInputs.resize (numInputs + 1, 0);
+    lutsByInputs[numInputs]++;
+    if (level > levelHistogram.size ())
+      levelHistogram.resize (level, 0);
+    levelHistogram[level - 1]++;
+  };
+  for (unsigned int i = 0; i < _aig.getNumAnds (); i++)
+    {
+      unsigned int node = _aig.getFirstAndLiteral () + 2 * i;
+      if (!isImplemented (node))
+        continue;
+      const Cut &selectedCut = _mappingEngine.getSelectedCut (node);
+      if (selectedCut.numNodeVariables () == 0)
+        continue;
+      unsigned int level = 0;
+      for (const auto &leafVariable : selectedCut)
+        level = std::max (level, levelVector[leafVariable]);
+      levelVector[AndInverterGraph::indexFromLiteral (node)] = level + 1;
+      countLut (selectedCut.numNodeVariables (), level + 1);
+    }
+
+  // Outputs driven by an input, GND or VDD are implemented by one lookup
+  // table of one or no input
+  const std::vector<unsigned int> &outputs = _aig.getOutputLiteralVector ();
+  auto outputDepth = [&] (unsigned int outputLiteral) {
+    if (_aig.nodeIsAnd (outputLiteral))
+      return levelVector[AndInverterGraph::indexFromLiteral (outputLiteral)];
+    return _aig.nodeIsInput (outputLiteral) || outputLiteral < 2 ? 1u : 0u;
+  };
+  for (const auto &outputLiteral : outputs)
+    if (_aig.nodeIsInput (outputLiteral) || outputLiteral < 2)
+      countLut (outputLiteral < 2 ? 0 : 1, 1);
+
+  std::ostringstream fingerprint;
+  fingerprint << std::hex << std::setw (16) << std::setfill ('0')
+              << getFingerprint ();
+  writer.key ("lutCount").value (_mappingAreaCost);
+  writer.key ("levels").value (_mappingDelayCost);
+  if (_mappingEngine.getDelayModel ().dependsOnFanout ())
+    {
+      writer.key ("estimatedDelay").value (_mappingEstimatedDelay);
+      writer.key ("mappingPasses").value (_numPasses);
+      writer.key ("mappingConverged").value (_converged);
+    }
+  writer.key ("fingerprint").value (fingerprint.str ());
+  writer.key ("lutsByInputs").beginArray ();
+  for (const auto &count : lutsByInputs)
+    writer.value (count);
+  writer.endArray ();
+  writer.key ("levelHistogram").beginArray ();
+  for (const auto &count : levelHistogram)
+    writer.value (count);
+  writer.endArray ();
+  writer.key ("outputs").beginArray ();
+  for (unsigned int i = 0; i < outputs.size (); i++)
+    {
+      writer.beginObject ();
+      std::string_view name = _aig.getOutputName (i);
+      if (!name.empty ())
+        writer.key ("name").value (name);
+      writer.key ("literal").value (outputs[i]);
+      writer.key ("depth").value (outputDepth (outputs[i]));
+      writer.endObject ();
+    }
+  writer.endArray ();
+  writer.key ("criticalOutputs").beginArray ();
+  for (unsigned int i = 0; i < outputs.size (); i++)
+    if (outputDepth (outputs[i]) == _mappingDelayCost)
+      writer.value (i);
+  writer.endArray ();
 }
 
+template <typename ObserverPolicy>
 void
-TechMapper::printImplementation (std::ostream &os)
+TechMapperBase<ObserverPolicy>::printImplementation (std::ostream &os)
 {
   std::cout << ">> Implementation details: " << std::endl;
-  for (const auto &[node, implemented] : _implementationMap)
-    if (implemented)
-      std::cout << "(" << node << ") => " << _cutEngine.getBestCut (node)
-                << std::endl;
-    else
-      std::cout << "(" << node << ") => not implemented" << std::endl;
-}
\ No newline at end of file
+  for (unsigned int i = 0; i < _aig.getNumAnds (); i++)
+    {
+      unsigned int node = _aig.getFirstAndLiteral () + 2 * i;
+      if (isImplemented (node)
+          && _mappingEngine.getSelectedCut (node).numNodeVariables () == 0)
+        std::cout << "(" << node << ") => constant : function = "
+                  << _mappingEngine.getSelectedCut (node).getTruthTable ()
+                  << std::endl;
+      else if (isImplemented (node))
+        std::cout << "(" << node << ") => "
+                  << _mappingEngine.getSelectedCut (node) << std::endl;
+      else
+        std::cout << "(" << node << ") => not implemented" << std::endl;
+    }
+}
+
+template class TechMapperBase<NullObserverPolicy>;
+template class TechMapperBase<DynamicObserverPolicy>;
\ No newline at end of file
@@ -0,0 +1,227 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/TruthTable.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+// Minterms where variable i is 1, for the six variables inside a word
+const std::uint64_t variableMasks[6]
+    = { 0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL };
+
+unsigned int
+numWords (unsigned int numVariables)
+{
+  return numVariables <= 6 ? 1 : 1u << (numVariables - 6);
+}
+
+// Packs the 32 bits of a word whose minterms have variable i equal to 0
+std::uint64_t
+compressWord (std::uint64_t word, unsigned int variable)
+{
+  std::uint64_t compressed = 0;
+  unsigned int position = 0;
+  for (unsigned int minterm = 0; minterm < 64; minterm++)
+    if (!(minterm & (1u << variable)))
+      compressed |= ((word >> minterm) & 1) << position++;
+  return compressed;
+}
+
+} // namespace
+
+TruthTable::TruthTable (unsigned int numVariables)
+{
+  if (numVariables > MaxVariables)
+    throw std::runtime_error ("Truth tables are limited to "
+                              + std::to_string (MaxVariables)
+                              + " variables.");
+  _numVariables = numVariables;
+  _words.assign (numWords (numVariables), 0);
+}
+
+TruthTable
+TruthTable::nthVariable (unsigned int numVariables, unsigned int variable)
+{
+  if (variable >= numVariables)
+    throw std::runtime_error ("Runtime error (nthVariable): variable "
+                              + std::to_string (variable)
+                              + " out of range.");
+  TruthTable truthTable (numVariables);
+  for (unsigned int i = 0; i < truthTable._words.size (); i++)
+    if (variable < 6)
+      truthTable._words[i] = variableMasks[variable];
+    else
+      truthTable._words[i] = ((i >> (variable - 6)) & 1) ? ~0ULL : 0ULL;
+  return truthTable;
+}
+
+unsigned int
+TruthTable::getNumVariables () const noexcept
+{
+  return _numVariables;
+}
+
+bool
+TruthTable::isEmpty () const noexcept
+{
+  return _words.empty ();
+}
+
+bool
+TruthTable::dependsOn (unsigned int variable) const
+{
+  if (variable >= _numVariables)
+    return false;
+
+  // Compare the cofactors: inside each word for the six lowest variables,
+  // or word against word for the others
+  if (variable < 6)
+    {
+      unsigned int shift = 1u << variable;
+      for (const auto &word : _words)
+        if (((word >> shift) ^ word) & ~variableMasks[variable])
+          return true;
+      return false;
+    }
+  unsigned int step = 1u << (variable - 6);
+  for (unsigned int i = 0; i < _words.size (); i++)
+    if (!(i & step) && _words[i] != _words[i + step])
+      return true;
+  return false;
+}
+
+void
+TruthTable::removeVariable (unsigned int variable)
+{
+  if (variable >= _numVariables)
+    throw std::runtime_error ("Runtime error (removeVariable): variable "
+                              + std::to_string (variable)
+                              + " out of range.");
+  if (dependsOn (variable))
+    throw std::runtime_error ("Runtime error (removeVariable): the function "
+                              "depends on variable "
+                              + std::to_string (variable) + ".");
+
+  // Keep the cofactor where the variable is 0 (both cofactors are equal)
+  std::vector<std::uint64_t> words;
+  words.reserve (numWords (_numVariables - 1));
+  if (variable >= 6)
+    {
+      unsigned int step = 1u << (variable - 6);
+      for (unsigned int i = 0; i < _words.size (); i++)
+        if (!(i & step))
+          words.push_back (_words[i]);
+    }
+  else if (_words.size () == 1)
+    {
+      std::uint64_t compressed = compressWord (_words[0], variable);
+      words.push_back (compressed | (compressed << 32));
+    }
+  else
+    for (unsigned int i = 0; i < _words.size (); i += 2)
+      words.push_back (compressWord (_words[i], variable)
+                       | (compressWord (_words[i + 1], variable) << 32));
+
+  _words.swap (words);
+  _numVariables--;
+}
+
+bool
+TruthTable::getBit (unsigned int minterm) const
+{
+  if (minterm >= (1u << _numVariables))
+    throw std::runtime_error ("Runtime error (getBit): minterm "
+                              + std::to_string (minterm) + " out of range.");
+  return (_words[minterm / 64] >> (minterm % 64)) & 1;
+}
+
+void
+TruthTable::setBit (unsigned int minterm, bool value)
+{
+  unsigned int numMinterms = 1u << _numVariables;
+  if (minterm >= numMinterms)
+    throw std::runtime_error ("Runtime error (setBit): minterm "
+                              + std::to_string (minterm) + " out of range.");
+  for (unsigned int bit = minterm; bit < std::max (numMinterms, 64u);
+       bit += numMinterms)
+    if (value)
+      _words[bit / 64] |= std::uint64_t (1) << (bit % 64);
+    else
+      _words[bit / 64] &= ~(std::uint64_t (1) << (bit % 64));
+}
+
+const std::vector<std::uint64_t> &
+TruthTable::getWords () const noexcept
+{
+  return _words;
+}
+
+TruthTable
+TruthTable::operator& (const TruthTable &rhs) const
+{
+  if (_numVariables != rhs._numVariables
+      || _words.size () != rhs._words.size ())
+    throw std::runtime_error ("The conjunction of two truth tables (operator "
+                              "&) requires tables with the same variables.");
+  TruthTable result = *this;
+  for (unsigned int i = 0; i < result._words.size (); i++)
+    result._words[i] &= rhs._words[i];
+  return result;
+}
+
+TruthTable
+TruthTable::operator~ () const
+{
+  TruthTable result = *this;
+  for (auto &word : result._words)
+    word = ~word;
+  return result;
+}
+
+bool
+TruthTable::operator== (const TruthTable &rhs) const
+{
+  return _numVariables == rhs._numVariables && _words == rhs._words;
+}
+
+std::ostream &
+operator<< (std::ostream &os, const TruthTable &truthTable)
+{
+  if (truthTable._words.empty ())
+    return os;
+
+  std::ios_base::fmtflags flags = os.flags ();
+  char fill = os.fill ();
+  os << "0x" << std::hex << std::setfill ('0');
+  if (truthTable._numVariables < 6)
+    {
+      unsigned int numBits = 1u << truthTable._numVariables;
+      unsigned int numDigits = numBits < 4 ? 1 : numBits / 4;
+      std::uint64_t bits = truthTable._words[0];
+      if (numBits < 64)
+        bits &= (1ULL << numBits) - 1;
+      os << std::setw (numDigits) << bits;
+    }
+  else
+    for (auto word = truthTable._words.rbegin ();
+         word != truthTable._words.rend (); ++word)
+      os << std::setw (16) << *word;
+  os.flags (flags);
+  os.fill (fill);
+
+  return os;
+}
@@ -0,0 +1,94 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/WorkerPool.h"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool (unsigned int numWorkers,
+                        std::function<void (unsigned int)> onStart)
+{
+  numWorkers = std::max (1u, numWorkers);
+  _workerVector.reserve (numWorkers);
+  for (unsigned int i = 0; i < numWorkers; i++)
+    _workerVector.emplace_back (&WorkerPool::workerLoop, this, i, onStart);
+}
+
+WorkerPool::~WorkerPool ()
+{
+  {
+    std::lock_guard<std::mutex> lock (_mutex);
+    _stopping = true;
+  }
+  _startCondition.notify_all ();
+  for (auto &worker : _workerVector)
+    worker.join ();
+}
+
+unsigned int
+WorkerPool::getNumWorkers () const noexcept
+{
+  return _workerVector.size ();
+}
+
+void
+WorkerPool::runOnAll (const std::function<void (unsigned int)> &task)
+{
+  std::unique_lock<std::mutex> lock (_mutex);
+  _task = &task;
+  _exception = nullptr;
+  _numRunning = _workerVector.size ();
+  _generation++;
+  _startCondition.notify_all ();
+  _doneCondition.wait (lock, [this] { return _numRunning == 0; });
+  _task = nullptr;
+  if (_exception)
+    std::rethrow_exception (_exception);
+}
+
+void
+WorkerPool::workerLoop (unsigned int worker,
+                        std::function<void (unsigned int)> onStart)
+{
+  if (onStart)
+    onStart (worker);
+
+  unsigned long lastGeneration = 0;
+  while (true)
+    {
+      const std::function<void (unsigned int)> *task = nullptr;
+      {
+        std::unique_lock<std::mutex> lock (_mutex);
+        _startCondition.wait (lock, [&] {
+          return _stopping || _generation != lastGeneration;
+        });
+        if (_stopping)
+          return;
+        lastGeneration = _generation;
+        task = _task;
+      }
+
+      std::exception_ptr exception = nullptr;
+      try
+        {
+          (*task) (worker);
+        }
+      catch (...)
+        {
+          exception = std::current_exception ();
+        }
+
+      std::lock_guard<std::mutex> lock (_mutex);
+      if (exception && !_exception)
+        _exception = exception;
+      if (--_numRunning == 0)
+        _doneCondition.notify_one ();
+    }
+}
@@ -0,0 +1,348 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/ZddCutEngine.h"
+#include "../include/AllocationTracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+
+// Evaluates min over all sets of a ZDD of the cost of the set, where the cost
+// of a path is built bottom-up by combine(variable, cost of the rest of the
+// path). Returns the cost of every node reachable from the root.
+template <typename Combine>
+std::unordered_map<unsigned int, double>
+shortestPath (const ZddManager &zddManager, unsigned int root,
+              Combine combine)
+{
+  const double infinity = std::numeric_limits<double>::infinity ();
+  std::unordered_map<unsigned int, double> cost
+      = { { ZddManager::Empty, infinity }, { ZddManager::Base, 0.0 } };
+  std::vector<unsigned int> processingStack = { root };
+  while (!processingStack.empty ())
+    {
+      unsigned int current = processingStack.back ();
+      if (cost.count (current))
+        {
+          processingStack.pop_back ();
+          continue;
+        }
+      unsigned int low = zddManager.getLow (current);
+      unsigned int high = zddManager.getHigh (current);
+      auto lowCost = cost.find (low);
+      auto highCost = cost.find (high);
+      if (lowCost != cost.end () && highCost != cost.end ())
+        {
+          cost[current] = std::min (
+              lowCost->second,
+              combine (zddManager.getVariable (current), highCost->second));
+          processingStack.pop_back ();
+          continue;
+        }
+      if (lowCost == cost.end ())
+        processingStack.push_back (low);
+      if (highCost == cost.end ())
+        processingStack.push_back (high);
+    }
+  return cost;
+}
+
+} // namespace
+
+ZddCutEngine::ZddCutEngine (const AndInverterGraph &aig,
+                            MappingGoal mappingGoal, unsigned int k)
+    : _aig (aig), _mappingGoal (mappingGoal), _k (k)
+{
+  // Integrity check
+  if (_k < 2)
+    throw std::runtime_error (
+        "Runtime error (ZddCutEngine constructor): value of parameter k "
+        "(number of lut inputs) must be greater than 1.");
+
+  // Memory allocation and vector initialization
+  try
+    {
+      _cutFamilyVector.assign (_aig.getNumAnds (), ZddManager::Empty);
+      _cutSetVector.insert (_cutSetVector.begin (), _aig.getNumAnds (), {});
+      _areaFlowVector.assign (_aig.getMaxVariableIndex () + 1, 0.0);
+    }
+  catch (const std::exception &e)
+    {
+      throw std::runtime_error (
+          "Failed to initialize ZddCutEngine object from '"
+          + _aig.getFilePath () + "'.\n what(): " + e.what ());
+    }
+}
+
+const AndInverterGraph &
+ZddCutEngine::getAndInverterGraph () const noexcept
+{
+  return _aig;
+}
+
+bool
+ZddCutEngine::hasBestCut (unsigned int andLiteral) const
+{
+  if (!_aig.nodeIsAnd (andLiteral))
+    throw std::runtime_error (
+        "Runtime error (hasBestCut): the value provided in andLiteral "
+        "argument is not a valid and-literal for the AndInverterGraph "
+        "object.");
+  return !_cutSetVector.at (vectorIndexFromAndLiteral (andLiteral)).empty ();
+}
+
+const CutSet &
+ZddCutEngine::getCutSet (unsigned int andLiteral) const
+{
+  if (!_aig.nodeIsAnd (andLiteral))
+    throw std::runtime_error (
+        "Runtime error (getCutSet): the value provided in andLiteral argument "
+        "is not a valid and-literal for the AndInverterGraph object.");
+  return _cutSetVector.at (vectorIndexFromAndLiteral (andLiteral));
+}
+
+const Cut &
+ZddCutEngine::getBestCut (unsigned int andLiteral) const
+{
+  if (!hasBestCut (andLiteral))
+    throw std::runtime_error ("Runtime error (getBestCut): the best cut for "
+                              "the and-node has not been defined yet. Call "
+                              "hasBestCut() to check for it before calling "
+                              "getBestCut().");
+  return _cutSetVector.at (vectorIndexFromAndLiteral (andLiteral)).at (0);
+}
+
+unsigned int
+ZddCutEngine::getCutFamily (unsigned int andLiteral) const
+{
+  if (!hasBestCut (andLiteral))
+    throw std::runtime_error ("Runtime error (getCutFamily): the cut family "
+                              "of the and-node has not been built yet.");
+  return _cutFamilyVector.at (vectorIndexFromAndLiteral (andLiteral));
+}
+
+double
+ZddCutEngine::countCuts (unsigned int andLiteral) const
+{
+  return _zddManager.count (getCutFamily (andLiteral));
+}
+
+const ZddManager &
+ZddCutEngine::getZddManager () const noexcept
+{
+  return _zddManager;
+}
+
+const CutSet &
+ZddCutEngine::findCuts (const unsigned int &andLiteral)
+{
+  TMAP_ALLOCATION_SUBSYSTEM ("zdd cut families");
+
+  // Throw an exception if the value provided in andLiteral is not a valid AND
+  // node literal
+  if (!_aig.nodeIsAnd (andLiteral))
+    throw std::runtime_error (
+        "Runtime error (findCuts): value provided in andLiteral argument "
+        "is not a valid and-literal for the AndInverterGraph object.");
+
+  // Collect the and-nodes without a family in the transitive fanin
+  std::vector<unsigned int> pendingVariables;
+  std::vector<unsigned int> processingStack
+      = { AndInverterGraph::indexFromLiteral (andLiteral) };
+  std::vector<bool> visited (_aig.getNumAnds (), false);
+  while (!processingStack.empty ())
+    {
+      unsigned int currentVariable = processingStack.back ();
+      processingStack.pop_back ();
+      unsigned int currentLiteral
+          = AndInverterGraph::literalFromIndex (currentVariable);
+      unsigned int vectorIndex = vectorIndexFromAndLiteral (currentLiteral);
+      if (visited[vectorIndex] || hasBestCut (currentLiteral))
+        continue;
+      visited[vectorIndex] = true;
+      pendingVariables.push_back (currentVariable);
+      const AndNode &an = _aig.getAndNodeFromLiteral (currentLiteral);
+      for (unsigned int childLiteral :
+           { an.getFirstChild (), an.getSecondChild () })
+        if (_aig.nodeIsAnd (childLiteral))
+          processingStack.push_back (
+              AndInverterGraph::indexFromLiteral (childLiteral));
+    }
+
+  // And-nodes are stored in topological order
+  std::sort (pendingVariables.begin (), pendingVariables.end ());
+  if (_progress)
+    _progress->addNodes (pendingVariables.size ());
+  for (const auto &andVariable : pendingVariables)
+    {
+      stopIfCancelled ();
+      buildCutFamily (andVariable);
+      if (_progress)
+        _progress->nodeDone ();
+    }
+
+  return _cutSetVector.at (vectorIndexFromAndLiteral (andLiteral));
+}
+
+void
+ZddCutEngine::run ()
+{
+  for (const auto &outputLiteral : _aig.getOutputLiteralVector ())
+    if (_aig.nodeIsAnd (outputLiteral))
+      this->findCuts (outputLiteral);
+}
+
+void
+ZddCutEngine::setProgress (MappingProgress *progress) noexcept
+{
+  _progress = progress;
+}
+
+void
+ZddCutEngine::stopIfCancelled ()
+{
+  if (!_progress || !_progress->isCancelled ())
+    return;
+  _zddManager = ZddManager ();
+  std::fill (_cutFamilyVector.begin (), _cutFamilyVector.end (),
+             ZddManager::Empty);
+  for (auto &cutSet : _cutSetVector)
+    cutSet = CutSet ();
+  std::fill (_areaFlowVector.begin (), _areaFlowVector.end (), 0.0);
+  throw MappingCancelled (_progress->isPastDeadline ()
+                              ? "Mapping cancelled: the deadline has passed."
+                              : "Mapping cancelled.");
+}
+
+unsigned int
+ZddCutEngine::vectorIndexFromAndLiteral (unsigned int andLiteral) const
+{
+  unsigned int vectorIndex = _aig.indexFromLiteral (andLiteral)
+                             - _aig.getNumInputs () - _aig.getNumLatches ()
+                             - 1;
+  if (vectorIndex >= _cutSetVector.size ())
+    throw std::overflow_error (
+        "Range overflow. Index used to access _cutSetVector is greater or "
+        "equal its size.");
+  else
+    return vectorIndex;
+}
+
+void
+ZddCutEngine::buildCutFamily (unsigned int andVariable)
+{
+  unsigned int andLiteral = AndInverterGraph::literalFromIndex (andVariable);
+  const AndNode &an = _aig.getAndNodeFromLiteral (andLiteral);
+
+  // Phi operation: each fanin contributes its own cuts plus its trivial cut.
+  // Sources (inputs and latches) only contribute their trivial cut
+  unsigned int faninFamilies[2];
+  unsigned int childLiterals[2]
+      = { an.getFirstChild (), an.getSecondChild () };
+  for (int i = 0; i < 2; i++)
+    {
+      unsigned int childVariable
+          = AndInverterGraph::indexFromLiteral (childLiterals[i]);
+      faninFamilies[i] = _zddManager.singleton (childVariable);
+      if (_aig.nodeIsAnd (childLiterals[i]))
+        {
+          unsigned int childVectorIndex
+              = vectorIndexFromAndLiteral (childLiterals[i]);
+          faninFamilies[i] = _zddManager.unite (
+              faninFamilies[i], _cutFamilyVector.at (childVectorIndex));
+        }
+    }
+
+  // Diamond operation
+  unsigned int cutFamily
+      = _zddManager.product (faninFamilies[0], faninFamilies[1], _k);
+  unsigned int vectorIndex = vectorIndexFromAndLiteral (andLiteral);
+  _cutFamilyVector[vectorIndex] = cutFamily;
+
+  // Best cut and its costs
+  std::set<unsigned int> bestCutVariables = extractBestCut (cutFamily);
+  unsigned int delayCost = 0;
+  double areaFlow = 1.0;
+  for (const auto &leafVariable : bestCutVariables)
+    {
+      delayCost = std::max (delayCost, leafArrival (leafVariable));
+      areaFlow += _areaFlowVector[leafVariable];
+    }
+  unsigned int fanout = _aig.getAndNodeFromLiteral (andLiteral).getFanout ();
+  _areaFlowVector[andVariable] = areaFlow / std::max (1u, fanout);
+
+  CutSet cutSet;
+  cutSet.emplace (Cut (bestCutVariables,
+                       static_cast<unsigned int> (std::lround (areaFlow)),
+                       delayCost, 0));
+  _cutSetVector[vectorIndex] = cutSet;
+}
+
+unsigned int
+ZddCutEngine::leafArrival (unsigned int variable) const
+{
+  unsigned int literal = AndInverterGraph::literalFromIndex (variable);
+  if (_aig.nodeIsAnd (literal))
+    return getBestCut (literal).getDelayCost () + 1;
+  return 1;
+}
+
+std::set<unsigned int>
+ZddCutEngine::extractBestCut (unsigned int cutFamily) const
+{
+  const double infinity = std::numeric_limits<double>::infinity ();
+  auto areaCombine = [this] (unsigned int variable, double rest) {
+    return _areaFlowVector[variable] + rest;
+  };
+
+  std::unordered_map<unsigned int, double> cost;
+  if (_mappingGoal == MappingGoal::MinimizeDelay)
+    {
+      auto delayCombine = [this] (unsigned int variable, double rest) {
+        return std::max (static_cast<double> (leafArrival (variable)), rest);
+      };
+      double minimumDelay
+          = shortestPath (_zddManager, cutFamily, delayCombine)[cutFamily];
+      cost = shortestPath (
+          _zddManager, cutFamily,
+          [&] (unsigned int variable, double rest) {
+            return leafArrival (variable) <= minimumDelay
+                       ? areaCombine (variable, rest)
+                       : infinity;
+          });
+    }
+  else
+    cost = shortestPath (_zddManager, cutFamily, areaCombine);
+
+  // Walk the ZDD along the cheapest path, collecting the variables of the
+  // high edges taken
+  std::set<unsigned int> cutVariables;
+  unsigned int current = cutFamily;
+  while (!ZddManager::isTerminal (current))
+    {
+      unsigned int low = _zddManager.getLow (current);
+      if (cost.at (low) == cost.at (current))
+        current = low;
+      else
+        {
+          cutVariables.insert (_zddManager.getVariable (current));
+          current = _zddManager.getHigh (current);
+        }
+    }
+  if (current != ZddManager::Base || cutVariables.empty ())
+    throw std::runtime_error (
+        "Runtime error (extractBestCut): the cut family is empty.");
+  return cutVariables;
+}
@@ -0,0 +1,234 @@
+/**
+ *
+ *  Author: Rafael Calcada (rafaelcalcada@gmail.com)
+ *  GitHub: https://github.com/rafaelcalcada/tmap
+ *
+ *  Licensed under the MIT License. For the full license please read the
+ * 'LICENSE.md' file
+ *
+ */
+
+#include "../include/ZddManager.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+ZddManager::ZddManager (std::size_t cacheLimit) : _cacheLimit (cacheLimit)
+{
+  // Terminal nodes have the largest variable, so that they are always below
+  // any non-terminal node
+  unsigned int terminalVariable = -1;
+  _nodeVector.push_back ({ terminalVariable, Empty, Empty });
+  _nodeVector.push_back ({ terminalVariable, Base, Base });
+}
+
+unsigned int
+ZddManager::singleton (unsigned int variable)
+{
+  return makeNode (variable, Empty, Base);
+}
+
+unsigned int
+ZddManager::unite (unsigned int zddA, unsigned int zddB)
+{
+  // Terminal cases
+  if (zddA == Empty)
+    return zddB;
+  if (zddB == Empty || zddA == zddB)
+    return zddA;
+
+  // Union is commutative: normalize the operands to improve cache hits
+  if (zddA > zddB)
+    std::swap (zddA, zddB);
+  CacheKey key = { Operation::Unite, zddA, zddB, 0 };
+  unsigned int result;
+  if (lookupCache (key, result))
+    return result;
+
+  const ZddNode nodeA = _nodeVector[zddA];
+  const ZddNode nodeB = _nodeVector[zddB];
+  if (nodeA.variable < nodeB.variable)
+    result = makeNode (nodeA.variable, unite (nodeA.low, zddB), nodeA.high);
+  else if (nodeA.variable > nodeB.variable)
+    result = makeNode (nodeB.variable, unite (zddA, nodeB.low), nodeB.high);
+  else
+    result = makeNode (nodeA.variable, unite (nodeA.low, nodeB.low),
+                       unite (nodeA.high, nodeB.high));
+
+  insertCache (key, result);
+  return result;
+}
+
+unsigned int
+ZddManager::product (unsigned int zddA, unsigned int zddB, unsigned int k)
+{
+  // Terminal cases
+  if (zddA == Empty || zddB == Empty)
+    return Empty;
+  if (zddA == Base)
+    return restrict (zddB, k);
+  if (zddB == Base)
+    return restrict (zddA, k);
+
+  // Product is commutative: normalize the operands to improve cache hits
+  if (zddA > zddB)
+    std::swap (zddA, zddB);
+  CacheKey key = { Operation::Product, zddA, zddB, k };
+  unsigned int result;
+  if (lookupCache (key, result))
+    return result;
+
+  // Sets with the top variable need one more variable out of the k allowed
+  const ZddNode nodeA = _nodeVector[zddA];
+  const ZddNode nodeB = _nodeVector[zddB];
+  if (nodeA.variable < nodeB.variable)
+    result = makeNode (nodeA.variable, product (nodeA.low, zddB, k),
+                       k > 0 ? product (nodeA.high, zddB, k - 1) : Empty);
+  else if (nodeA.variable > nodeB.variable)
+    result = makeNode (nodeB.variable, product (zddA, nodeB.low, k),
+                       k > 0 ? product (zddA, nodeB.high, k - 1) : Empty);
+  else
+    {
+      unsigned int high = Empty;
+      if (k > 0)
+        {
+          high = product (nodeA.high, nodeB.high, k - 1);
+          high = unite (high, product (nodeA.high, nodeB.low, k - 1));
+          high = unite (high, product (nodeA.low, nodeB.high, k - 1));
+        }
+      result = makeNode (nodeA.variable, product (nodeA.low, nodeB.low, k),
+                         high);
+    }
+
+  insertCache (key, result);
+  return result;
+}
+
+unsigned int
+ZddManager::restrict (unsigned int zdd, unsigned int k)
+{
+  if (isTerminal (zdd))
+    return zdd;
+
+  CacheKey key = { Operation::Restrict, zdd, 0, k };
+  unsigned int result;
+  if (lookupCache (key, result))
+    return result;
+
+  const ZddNode node = _nodeVector[zdd];
+  result = makeNode (node.variable, restrict (node.low, k),
+                     k > 0 ? restrict (node.high, k - 1) : Empty);
+
+  insertCache (key, result);
+  return result;
+}
+
+double
+ZddManager::count (unsigned int zdd) const
+{
+  std::unordered_map<unsigned int, double> counts = { { Empty, 0.0 },
+                                                      { Base, 1.0 } };
+  std::vector<unsigned int> processingStack = { zdd };
+  while (!processingStack.empty ())
+    {
+      unsigned int current = processingStack.back ();
+      if (counts.count (current))
+        {
+          processingStack.pop_back ();
+          continue;
+        }
+      const ZddNode &node = _nodeVector[current];
+      auto low = counts.find (node.low);
+      auto high = counts.find (node.high);
+      if (low != counts.end () && high != counts.end ())
+        {
+          counts[current] = low->second + high->second;
+          processingStack.pop_back ();
+          continue;
+        }
+      if (low == counts.end ())
+        processingStack.push_back (node.low);
+      if (high == counts.end ())
+        processingStack.push_back (node.high);
+    }
+  return counts[zdd];
+}
+
+unsigned int
+ZddManager::getVariable (unsigned int zdd) const
+{
+  if (isTerminal (zdd))
+    throw std::runtime_error (
+        "Runtime error (getVariable): terminal nodes have no variable.");
+  return _nodeVector.at (zdd).variable;
+}
+
+unsigned int
+ZddManager::getLow (unsigned int zdd) const
+{
+  if (isTerminal (zdd))
+    throw std::runtime_error (
+        "Runtime error (getLow): terminal nodes have no children.");
+  return _nodeVector.at (zdd).low;
+}
+
+unsigned int
+ZddManager::getHigh (unsigned int zdd) const
+{
+  if (isTerminal (zdd))
+    throw std::runtime_error (
+        "Runtime error (getHigh): terminal nodes have no children.");
+  return _nodeVector.at (zdd).high;
+}
+
+bool
+ZddManager::isTerminal (unsigned int zdd) noexcept
+{
+  return zdd == Empty || zdd == Base;
+}
+
+std::size_t
+ZddManager::getNumNodes () const noexcept
+{
+  return _nodeVector.size ();
+}
+
+unsigned int
+ZddManager::makeNode (unsigned int variable, unsigned int low,
+                      unsigned int high)
+{
+  // Zero-suppression rule
+  if (high == Empty)
+    return low;
+
+  ZddNode node = { variable, low, high };
+  auto found = _uniqueTable.find (node);
+  if (found != _uniqueTable.end ())
+    return found->second;
+
+  unsigned int index = _nodeVector.size ();
+  if (index == static_cast<unsigned int> (-1))
+    throw std::overflow_error (
+        "Range overflow. Maximum number of ZDD nodes reached.");
+  _nodeVector.push_back (node);
+  _uniqueTable.emplace (node, index);
+  return index;
+}
+
+bool
+ZddManager::lookupCache (const CacheKey &key, unsigned int &result) const
+{
+  auto found = _computedCache.find (key);
+  if (found == _computedCache.end ())
+    return false;
+  result = found->second;
+  return true;
+}
+
+void
+ZddManager::insertCache (const CacheKey &key, unsigned int result)
+{
+  if (_computedCache.size () >= _cacheLimit)
+    _computedCache.clear ();
+  _computedCache.emplace (key, result);
+}
@@ -8,41 +8,492 @@
  *
  */
 
+#include <chrono>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <vector>
 
+#include "../include/AllocationTracker.h"
 #include "../include/AndInverterGraph.h"
 #include "../include/CutEngine.h"
+#include "../include/ExactRemapper.h"
+#include "../include/FlowMapEngine.h"
+#include "../include/HierarchicalMapper.h"
+#include "../include/JsonWriter.h"
+#include "../include/LutNetwork.h"
+#include "../include/MappingJob.h"
+#include "../include/MappingProfiler.h"
+#include "../include/RegisterPartitioner.h"
+#include "../include/SequentialMapper.h"
 #include "../include/TechMapper.h"
+#include "../include/ZddCutEngine.h"
 
 int
 main (int argc, char *argv[])
 try
   {
     // Basic parameter processing
+    // Usage: tmap <file> [k] [c] [a|d] [--engine=cuts|flowmap|zdd]
+    //             [--no-support-reduction] [--lut-delay=N] [--wire-delay=N]
+    //             [--threads=N] [--save-snapshot=FILE] [--stats]
+    //             [--spill-window=N] [--spill-dir=DIR] [--resynthesize]
+    //             [--json=FILE] [--timeout=SECONDS] [--prune-dominated]
+    //             [--auto] [--time-budget=SECONDS] [--memory-budget=MB]
+    //             [--exact-remap] [--conflict-budget=N]
+    //        tmap <file.manifest> [k] [c] [a|d] [--remap-boundary]
+    //             [--no-support-reduction] [--threads=N] [--stats]
+    //        tmap <file> [k] [c] --sequential [--stats]
     int k = 6;
     int c = 0;
     std::string inputFile = "";
+    std::string engine = "cuts";
+    bool supportReduction = true;
+    bool pruneDominated = false;
+    bool printStats = false;
+    int numThreads = 1;
+    std::string snapshotFile = "";
+    int spillWindow = 0;
+    std::string spillDirectory = "";
+    bool boundaryRemapping = false;
+    bool sequential = false;
+    bool resynthesis = false;
+    bool exactRemapping = false;
+    long long conflictBudget = 0;
+    std::string jsonFile = "";
+    double timeout = 0;
+    bool autoC = false;
+    double timeBudget = 0;
+    double memoryBudget = 0;
+    DelayModel delayModel;
     MappingGoal mg = MappingGoal::MinimizeArea;
-    if (argc > 1)
-      inputFile = argv[1];
-    if (argc > 2)
-      k = std::atoi (argv[2]);
-    if (argc > 3)
-      c = std::atoi (argv[3]);
-    if (argc > 4 && argv[4][0] == 'd')
+    std::vector<std::string> positionalArgs;
+    for (int i = 1; i < argc; i++)
+      {
+        std::string arg = argv[i];
+        if (arg.rfind ("--engine=", 0) == 0)
+          engine = arg.substr (9);
+        else if (arg == "--no-support-reduction")
+          supportReduction = false;
+        else if (arg == "--prune-dominated")
+          pruneDominated = true;
+        else if (arg.rfind ("--threads=", 0) == 0)
+          numThreads = std::atoi (arg.substr (10).c_str ());
+        else if (arg.rfind ("--save-snapshot=", 0) == 0)
+          snapshotFile = arg.substr (16);
+        else if (arg.rfind ("--spill-window=", 0) == 0)
+          spillWindow = std::atoi (arg.substr (15).c_str ());
+        else if (arg.rfind ("--spill-dir=", 0) == 0)
+          spillDirectory = arg.substr (12);
+        else if (arg == "--remap-boundary")
+          boundaryRemapping = true;
+        else if (arg == "--sequential")
+          sequential = true;
+        else if (arg == "--resynthesize")
+          resynthesis = true;
+        else if (arg == "--exact-remap")
+          exactRemapping = true;
+        else if (arg.rfind ("--conflict-budget=", 0) == 0)
+          conflictBudget = std::atoll (arg.substr (18).c_str ());
+        else if (arg.rfind ("--json=", 0) == 0)
+          jsonFile = arg.substr (7);
+        else if (arg.rfind ("--timeout=", 0) == 0)
+          timeout = std::atof (arg.substr (10).c_str ());
+        else if (arg == "--auto")
+          autoC = true;
+        else if (arg.rfind ("--time-budget=", 0) == 0)
+          timeBudget = std::atof (arg.substr (14).c_str ());
+        else if (arg.rfind ("--memory-budget=", 0) == 0)
+          memoryBudget = std::atof (arg.substr (16).c_str ());
+        else if (arg == "--stats")
+          printStats = true;
+        else if (arg.rfind ("--lut-delay=", 0) == 0)
+          delayModel.lutDelay = std::atoi (arg.substr (12).c_str ());
+        else if (arg.rfind ("--wire-delay=", 0) == 0)
+          delayModel.wireDelay = std::atoi (arg.substr (13).c_str ());
+        else if (arg.rfind ("--", 0) == 0)
+          throw std::runtime_error ("Unknown option '" + arg + "'");
+        else
+          positionalArgs.push_back (arg);
+      }
+    if (positionalArgs.size () > 0)
+      inputFile = positionalArgs[0];
+    if (positionalArgs.size () > 1)
+      k = std::atoi (positionalArgs[1].c_str ());
+    if (positionalArgs.size () > 2)
+      c = std::atoi (positionalArgs[2].c_str ());
+    if (positionalArgs.size () > 3 && positionalArgs[3][0] == 'd')
       mg = MappingGoal::MinimizeDelay;
+    if (numThreads < 1)
+      throw std::runtime_error ("The number of threads must be at least 1.");
+    if (spillWindow < 0)
+      throw std::runtime_error ("The spill window must not be negative.");
+    if (spillWindow > 0 && numThreads > 1)
+      throw std::runtime_error ("--spill-window enumerates with one thread; "
+                                "it cannot be used with --threads.");
+    if (timeout < 0)
+      throw std::runtime_error ("The timeout must not be negative.");
+    if (delayModel.lutDelay == 0)
+      throw std::runtime_error ("The lut delay must be greater than 0.");
+    if (engine != "cuts" && engine != "flowmap" && engine != "zdd")
+      throw std::runtime_error ("Unknown engine '" + engine
+                                + "'. Valid engines are 'cuts', 'flowmap' "
+                                  "and 'zdd'.");
+    if (pruneDominated && engine != "cuts")
+      throw std::runtime_error ("--prune-dominated only applies to the "
+                                "'cuts' engine.");
+    if (timeBudget < 0 || memoryBudget < 0)
+      throw std::runtime_error ("The budgets must not be negative.");
+    if ((timeBudget > 0 || memoryBudget > 0) && !autoC)
+      throw std::runtime_error ("--time-budget and --memory-budget are the "
+                                "budgets of --auto.");
+    if (autoC && engine != "cuts")
+      throw std::runtime_error ("--auto only applies to the 'cuts' engine.");
+    if (conflictBudget < 0)
+      throw std::runtime_error ("The conflict budget must not be negative.");
+    if (conflictBudget > 0 && !exactRemapping)
+      throw std::runtime_error ("--conflict-budget is the budget of "
+                                "--exact-remap.");
+    if (exactRemapping && resynthesis)
+      throw std::runtime_error ("--exact-remap and --resynthesize both start "
+                                "from the cover; they cannot be used "
+                                "together.");
 
-    // Only go ahead if inputFile is provided
-    if (!inputFile.empty ())
+    // A manifest lists the modules and instances of a hierarchical design,
+    // mapped with the cuts engine
+    bool isManifest
+        = inputFile.size () > 9
+          && inputFile.compare (inputFile.size () - 9, 9, ".manifest") == 0;
+    if (isManifest)
+      {
+        if (engine != "cuts" || spillWindow > 0 || !snapshotFile.empty ()
+            || resynthesis || !jsonFile.empty () || pruneDominated
+            || autoC || exactRemapping)
+          throw std::runtime_error ("Manifests are mapped with the 'cuts' "
+                                    "engine, in memory, without snapshots, "
+                                    "resynthesis, JSON reports, dominance "
+                                    "pruning, --auto or --exact-remap.");
+        auto start = std::chrono::steady_clock::now ();
+        HierarchicalMapper hierarchicalMapper (inputFile, mg, k, c);
+        hierarchicalMapper.setBoundaryRemapping (boundaryRemapping);
+        hierarchicalMapper.setSupportReduction (supportReduction);
+        hierarchicalMapper.setNumThreads (numThreads);
+        hierarchicalMapper.run ();
+        hierarchicalMapper.printResults (std::cout);
+        if (printStats)
+          {
+            std::cout << ">> Statistics" << std::endl;
+            std::cout << std::fixed << std::setprecision (3);
+            std::cout << "# Mapping time (s): "
+                      << std::chrono::duration<double> (
+                             std::chrono::steady_clock::now () - start)
+                             .count ()
+                      << std::endl;
+            std::cout << std::defaultfloat;
+            AllocationTracker::print (std::cout);
+          }
+      }
+
+    // Sequential mapping keeps priority cuts (8 unless c is given) and has
+    // its own cut enumeration
+    else if (sequential && !inputFile.empty ())
       {
+        if (engine != "cuts" || spillWindow > 0 || numThreads > 1
+            || resynthesis || !jsonFile.empty () || pruneDominated
+            || autoC || exactRemapping)
+          throw std::runtime_error ("--sequential has its own cut "
+                                    "enumeration; it cannot be used with "
+                                    "--engine, --spill-window, --threads, "
+                                    "--resynthesize, --json, "
+                                    "--prune-dominated, --auto or "
+                                    "--exact-remap.");
+        auto start = std::chrono::steady_clock::now ();
         AndInverterGraph aig (inputFile);
-        CutEngine cutEngine (aig, mg, k, c);
-        TechMapper techMapper (cutEngine);
-        techMapper.run ();
-        techMapper.printResults (std::cout);
-        techMapper.printImplementation (std::cout);
-        std::cout << cutEngine << std::endl;
-        cutEngine.printImplementation (std::cout);
+        if (!snapshotFile.empty ())
+          aig.saveSnapshot (snapshotFile);
+        SequentialMapper sequentialMapper (aig, k, c > 0 ? c : 8);
+        sequentialMapper.run ();
+        sequentialMapper.printResults (std::cout);
+        if (printStats)
+          {
+            std::cout << ">> Statistics" << std::endl;
+            std::cout << std::fixed << std::setprecision (3);
+            std::cout << "# Mapping time (s): "
+                      << std::chrono::duration<double> (
+                             std::chrono::steady_clock::now () - start)
+                             .count ()
+                      << std::endl;
+            std::cout << std::defaultfloat;
+            AllocationTracker::print (std::cout);
+          }
+        sequentialMapper.printImplementation (std::cout);
+      }
+
+    // Only go ahead if inputFile is provided
+    else if (!inputFile.empty ())
+      {
+        // Wall-clock time of each phase, in seconds
+        using Clock = std::chrono::steady_clock;
+        auto secondsSince = [] (Clock::time_point start) {
+          return std::chrono::duration<double> (Clock::now () - start).count ();
+        };
+        double parseTime, enumerationTime, coverTime, resynthesisTime,
+            exactRemappingTime;
+
+        Clock::time_point start = Clock::now ();
+        std::unique_ptr<AndInverterGraph> aig;
+        {
+          TMAP_ALLOCATION_PHASE ("parse");
+          aig.reset (new AndInverterGraph (inputFile));
+        }
+        parseTime = secondsSince (start);
+        if (!snapshotFile.empty ())
+          aig->saveSnapshot (snapshotFile);
+
+        // --auto replaces c with the largest one predicted to fit the
+        // budgets
+        start = Clock::now ();
+        std::unique_ptr<MappingProfiler> profiler;
+        if (autoC)
+          {
+            TMAP_ALLOCATION_PHASE ("profile");
+            profiler.reset (new MappingProfiler (*aig, mg, k));
+            if (timeBudget > 0)
+              profiler->setTimeBudget (timeBudget);
+            if (memoryBudget > 0)
+              profiler->setMemoryBudget (
+                  static_cast<std::uint64_t> (memoryBudget * 1024 * 1024));
+            profiler->run ();
+            profiler->printResults (std::cout);
+            c = profiler->getSelectedC ();
+          }
+        double profileTime = secondsSince (start);
+
+        // Sequential designs are mapped one combinational island (the logic
+        // between registers) at a time, with any engine
+        if (aig->isSequential ())
+          {
+            if (spillWindow > 0 || resynthesis || !jsonFile.empty ()
+                || pruneDominated || exactRemapping)
+              throw std::runtime_error ("--spill-window, --resynthesize, "
+                                        "--json, --prune-dominated and "
+                                        "--exact-remap cannot be used with "
+                                        "sequential designs.");
+            start = Clock::now ();
+            RegisterPartitioner partitioner (*aig, mg, k, c);
+            partitioner.setEngine (engine);
+            partitioner.setSupportReduction (supportReduction);
+            partitioner.setDelayModel (delayModel);
+            partitioner.setNumThreads (numThreads);
+            partitioner.run ();
+            double mappingTime = secondsSince (start);
+            partitioner.printResults (std::cout);
+            if (printStats)
+              {
+                std::cout << ">> Statistics" << std::endl;
+                std::cout << std::fixed << std::setprecision (3);
+                std::cout << "# Parse time (s): " << parseTime << std::endl;
+                if (profiler)
+                  std::cout << "# Profile time (s): " << profileTime
+                            << std::endl;
+                std::cout << "# Mapping time (s): " << mappingTime
+                          << std::endl;
+                std::cout << std::defaultfloat;
+                AllocationTracker::print (std::cout);
+              }
+            partitioner.printImplementation (std::cout);
+            return 0;
+          }
+
+        // FlowMap labeling is depth-optimal: the mapping goal is ignored
+        start = Clock::now ();
+        std::unique_ptr<MappingEngine> mappingEngine;
+        {
+          TMAP_ALLOCATION_PHASE ("enumeration");
+          if (engine == "flowmap")
+            mappingEngine.reset (new FlowMapEngine (*aig, k));
+          else if (engine == "zdd")
+            mappingEngine.reset (new ZddCutEngine (*aig, mg, k));
+          else
+            {
+              CutEngine *cutEngine = new CutEngine (*aig, mg, k, c);
+              mappingEngine.reset (cutEngine);
+              cutEngine->setSupportReduction (supportReduction);
+              cutEngine->setDominancePruning (pruneDominated);
+              cutEngine->setDelayModel (delayModel);
+              cutEngine->setNumThreads (numThreads);
+              if (spillWindow > 0)
+                cutEngine->setOutOfCore (spillWindow, spillDirectory);
+            }
+          if (timeout == 0)
+            mappingEngine->run ();
+        }
+        enumerationTime = secondsSince (start);
+
+        start = Clock::now ();
+        std::unique_ptr<TechMapper> techMapper;
+        {
+          TMAP_ALLOCATION_PHASE ("cover");
+          techMapper.reset (new TechMapper (*mappingEngine));
+          techMapper->setNumThreads (numThreads);
+          if (timeout == 0)
+            techMapper->run ();
+        }
+        coverTime = secondsSince (start);
+
+        // With a timeout, the engine and the cover run as a job that is
+        // cancelled when the deadline passes
+        if (timeout > 0)
+          {
+            MappingJob mappingJob (*mappingEngine, *techMapper);
+            mappingJob.setDeadline (
+                Clock::now ()
+                + std::chrono::duration_cast<Clock::duration> (
+                    std::chrono::duration<double> (timeout)));
+            mappingJob.start ().get ();
+            enumerationTime = mappingJob.getEnumerationSeconds ();
+            coverTime = mappingJob.getCoverSeconds ();
+          }
+
+        // Collapse and decomposition moves on the lookup tables of the cover
+        start = Clock::now ();
+        std::unique_ptr<LutNetwork> lutNetwork;
+        if (resynthesis)
+          {
+            TMAP_ALLOCATION_PHASE ("resynthesis");
+            lutNetwork.reset (
+                new LutNetwork (*mappingEngine, *techMapper, mg, k));
+            lutNetwork->run ();
+          }
+        resynthesisTime = secondsSince (start);
+
+        // Exact covers of small cones of the critical paths
+        start = Clock::now ();
+        std::unique_ptr<ExactRemapper> exactRemapper;
+        if (exactRemapping)
+          {
+            TMAP_ALLOCATION_PHASE ("remapping");
+            exactRemapper.reset (
+                new ExactRemapper (*mappingEngine, *techMapper, k));
+            exactRemapper->setNumThreads (numThreads);
+            if (conflictBudget > 0)
+              exactRemapper->setConflictBudget (conflictBudget);
+            exactRemapper->run ();
+          }
+        exactRemappingTime = secondsSince (start);
+
+        techMapper->printResults (std::cout);
+        if (lutNetwork)
+          lutNetwork->printResults (std::cout);
+        if (exactRemapper)
+          exactRemapper->printResults (std::cout);
+        if (engine == "zdd")
+          std::cout << "# ZDD nodes: "
+                    << static_cast<ZddCutEngine &> (*mappingEngine)
+                           .getZddManager ()
+                           .getNumNodes ()
+                    << std::endl;
+        if (printStats)
+          {
+            std::cout << ">> Statistics" << std::endl;
+            std::cout << std::fixed << std::setprecision (3);
+            std::cout << "# Parse time (s): " << parseTime << std::endl;
+            if (profiler)
+              std::cout << "# Profile time (s): " << profileTime
+                        << std::endl;
+            std::cout << "# Enumeration time (s): " << enumerationTime
+                      << std::endl;
+            std::cout << "# Cover time (s): " << coverTime << std::endl;
+            if (lutNetwork)
+              std::cout << "# Resynthesis time (s): " << resynthesisTime
+                        << std::endl;
+            if (exactRemapper)
+              std::cout << "# Exact remapping time (s): "
+                        << exactRemappingTime << std::endl;
+            std::cout << std::defaultfloat;
+            if (engine == "cuts" && spillWindow > 0)
+              std::cout << "# Spilled cut set bytes: "
+                        << static_cast<CutEngine &> (*mappingEngine)
+                               .getNumSpilledBytes ()
+                        << std::endl;
+            AllocationTracker::print (std::cout);
+          }
+        // The report is streamed to the file as it is written
+        if (!jsonFile.empty ())
+          {
+            std::ofstream jsonStream (jsonFile);
+            if (!jsonStream)
+              throw std::runtime_error ("Could not open '" + jsonFile
+                                        + "' for writing.");
+            JsonWriter writer (jsonStream);
+            writer.beginObject ();
+            writer.key ("design").value (inputFile);
+            writer.key ("parameters").beginObject ();
+            writer.key ("engine").value (engine);
+            writer.key ("k").value (k);
+            writer.key ("c").value (c);
+            writer.key ("goal").value (
+                mg == MappingGoal::MinimizeDelay ? "delay" : "area");
+            writer.key ("supportReduction").value (supportReduction);
+            writer.key ("pruneDominated").value (pruneDominated);
+            writer.key ("lutDelay").value (delayModel.lutDelay);
+            writer.key ("wireDelay").value (delayModel.wireDelay);
+            writer.key ("threads").value (numThreads);
+            writer.key ("spillWindow").value (spillWindow);
+            writer.key ("resynthesis").value (resynthesis);
+            writer.key ("auto").value (autoC);
+            writer.key ("exactRemapping").value (exactRemapping);
+            writer.endObject ();
+            writer.key ("timings").beginObject ();
+            writer.key ("parseSeconds").value (parseTime);
+            if (profiler)
+              writer.key ("profileSeconds").value (profileTime);
+            writer.key ("enumerationSeconds").value (enumerationTime);
+            writer.key ("coverSeconds").value (coverTime);
+            if (lutNetwork)
+              writer.key ("resynthesisSeconds").value (resynthesisTime);
+            if (exactRemapper)
+              writer.key ("exactRemappingSeconds").value (exactRemappingTime);
+            writer.endObject ();
+            if (profiler)
+              {
+                writer.key ("profile").beginObject ();
+                profiler->writeReport (writer);
+                writer.endObject ();
+              }
+            writer.key ("mapping").beginObject ();
+            techMapper->writeReport (writer);
+            writer.endObject ();
+            if (lutNetwork)
+              {
+                writer.key ("resynthesis").beginObject ();
+                lutNetwork->writeReport (writer);
+                writer.endObject ();
+              }
+            if (exactRemapper)
+              {
+                writer.key ("exactRemapping").beginObject ();
+                exactRemapper->writeReport (writer);
+                writer.endObject ();
+              }
+            writer.endObject ();
+            if (!jsonStream)
+              throw std::runtime_error ("Could not write '" + jsonFile
+                                        + "'.");
+          }
+
+        techMapper->printImplementation (std::cout);
+        if (lutNetwork)
+          lutNetwork->printImplementation (std::cout);
+        if (exactRemapper)
+          exactRemapper->printImplementation (std::cout);
+        if (engine == "cuts")
+          {
+            CutEngine &cutEngine = static_cast<CutEngine &> (*mappingEngine);
+            std::cout << cutEngine << std::endl;
+            cutEngine.printImplementation (std::cout);
+          }
       }
 
     return 0;